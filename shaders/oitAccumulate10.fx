@@ -0,0 +1,62 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// oitAccumulate10.fx (HLSL)
+// Brief: Shader override of the OIT scene render, weighted blended accumulation and coverage
+// Copyright: 2020 Artineering and/or its licensors
+// License: MIT
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// COMMON MAYA VARIABLES
+float4x4 gWVP : WorldViewProjection;
+float4x4 gWVIT : WorldViewInverseTranspose;
+
+// transparent items are drawn with a single color and opacity (the override replaces their materials)
+float4 gTransparentColor = { 0.6, 0.75, 1.0, 0.4 };
+
+// VERTEX SHADER
+struct appData {
+	float3 vertex : POSITION;
+	float3 normal : NORMAL;
+};
+
+struct vertexOutput {
+	float4 pos : SV_POSITION;
+	float3 viewNormal : NORMAL;
+};
+
+vertexOutput accumulateVert(appData v) {
+	vertexOutput o;
+	o.pos = mul(float4(v.vertex, 1.0f), gWVP);
+	o.viewNormal = mul(float4(v.normal, 0.0f), gWVIT).xyz;
+	return o;
+}
+
+
+// PIXEL SHADER
+// accumulation target blended with (One, One), revealage target blended with (One, InvSrcColor)
+struct fragmentOutput {
+	float4 accum : SV_Target0;
+	float4 coverage : SV_Target1;
+};
+
+fragmentOutput accumulatePix(vertexOutput i) {
+    // headlight, so that the shapes read without their materials
+    float light = 0.35 + 0.65 * abs(normalize(i.viewNormal).z);
+    float3 color = gTransparentColor.rgb * light;
+    float alpha = gTransparentColor.a;
+    // weight of the layer, closer layers dominate the average (McGuire and Bavoil 2013)
+    float z = 1.0 - i.pos.z;
+    float weight = clamp(alpha * max(1e-2, 3e3 * z * z * z), 1e-2, 3e3);
+    fragmentOutput o;
+    o.accum = float4(color * alpha, alpha) * weight;  // sum(w * a * c), sum(w * a)
+    o.coverage = alpha;                               // 1 - prod(1 - a)
+    return o;
+}
+
+// TECHNIQUES
+technique11 accumulate <
+    string transparency = "transparent";
+> {
+    pass p0 {
+        SetVertexShader(CompileShader(vs_5_0, accumulateVert()));
+        SetPixelShader(CompileShader(ps_5_0, accumulatePix()));
+    }
+}
@@ -0,0 +1,47 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// oitComposite10.fx (HLSL)
+// Brief: Weighted blended order-independent transparency composite
+// Copyright: 2020 Artineering and/or its licensors
+// License: MIT
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// COMMON MAYA VARIABLES
+float4x4 gWVP : WorldViewProjection;
+
+// TEXTURES
+Texture2D gAccumTex;
+Texture2D gRevealageTex;
+
+// VERTEX SHADER
+struct appData {
+	float3 vertex : POSITION;
+};
+
+struct vertexOutput {
+	float4 pos : SV_POSITION;
+};
+
+vertexOutput quadVert(appData v) {
+	vertexOutput o;
+	o.pos = mul(float4(v.vertex, 1.0f), gWVP);
+	return o;
+}
+
+
+// PIXEL SHADER
+float4 compositePix(vertexOutput i) : SV_Target {
+    int3 loc = int3(i.pos.xy, 0);
+    float4 accum = gAccumTex.Load(loc);            // sum(w * a * c), sum(w * a)
+    float coverage = gRevealageTex.Load(loc).r;    // 1 - prod(1 - a)
+
+    // weighted average color, premultiplied by the total coverage
+    float3 average = accum.rgb / max(accum.a, 1e-5);
+    return float4(average * coverage, coverage);
+}
+
+// TECHNIQUES
+technique11 composite {
+    pass p0 {
+        SetVertexShader(CompileShader(vs_5_0, quadVert()));
+        SetPixelShader(CompileShader(ps_5_0, compositePix()));
+    }
+}
@@ -0,0 +1,41 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// overdraw10.fx (HLSL)
+// Brief: Shader override of the overdraw scene renders, halves the target for every layer
+// Copyright: 2020 Artineering and/or its licensors
+// License: MIT
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// COMMON MAYA VARIABLES
+float4x4 gWVP : WorldViewProjection;
+
+// VERTEX SHADER
+struct appData {
+	float3 vertex : POSITION;
+};
+
+struct vertexOutput {
+	float4 pos : SV_POSITION;
+};
+
+vertexOutput countVert(appData v) {
+	vertexOutput o;
+	o.pos = mul(float4(v.vertex, 1.0f), gWVP);
+	return o;
+}
+
+
+// PIXEL SHADER
+// blended over the target as a transparent item (no depth writes)
+float4 countPix(vertexOutput i) : SV_Target {
+    // black at half opacity: 2^-layers with straight or premultiplied alpha blending
+    return float4(0.0, 0.0, 0.0, 0.5);
+}
+
+// TECHNIQUES
+technique11 count <
+    string transparency = "transparent";
+> {
+    pass p0 {
+        SetVertexShader(CompileShader(vs_5_0, countVert()));
+        SetPixelShader(CompileShader(ps_5_0, countPix()));
+    }
+}
@@ -0,0 +1,48 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// quadClear10.fx (HLSL)
+// Brief: Clears the color and depth within the viewport rectangle (partial redraw)
+// Copyright: 2020 Artineering and/or its licensors
+// License: MIT
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// COMMON MAYA VARIABLES
+float4x4 gWVP : WorldViewProjection;
+
+// VARIABLES
+float4 gClearColor = float4(0.0, 0.0, 0.0, 0.0);  // clear color of the scene render
+
+// VERTEX SHADER
+struct appData {
+	float3 vertex : POSITION;
+};
+
+struct vertexOutput {
+	float4 pos : SV_POSITION;
+};
+
+vertexOutput quadVert(appData v) {
+	vertexOutput o;
+	o.pos = mul(float4(v.vertex, 1.0f), gWVP);
+	return o;
+}
+
+
+// PIXEL SHADER
+struct fragmentOutput {
+    float4 color : SV_Target0;
+    float depth : SV_Depth;
+};
+
+fragmentOutput clearPix(vertexOutput i) {
+    fragmentOutput o;
+    o.color = gClearColor;
+    o.depth = 1.0;  // far plane, as cleared by the scene render
+    return o;
+}
+
+// TECHNIQUES
+technique11 clear {
+    pass p0 {
+        SetVertexShader(CompileShader(vs_5_0, quadVert()));
+        SetPixelShader(CompileShader(ps_5_0, clearPix()));
+    }
+}
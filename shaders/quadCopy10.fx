@@ -0,0 +1,40 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// quadCopy10.fx (HLSL)
+// Brief: Copies the input target (blended by the operation, e.g., progressive accumulation)
+// Copyright: 2020 Artineering and/or its licensors
+// License: MIT
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// COMMON MAYA VARIABLES
+float4x4 gWVP : WorldViewProjection;
+
+// TEXTURES
+Texture2D gInputTex;
+
+// VERTEX SHADER
+struct appData {
+	float3 vertex : POSITION;
+};
+
+struct vertexOutput {
+	float4 pos : SV_POSITION;
+};
+
+vertexOutput quadVert(appData v) {
+	vertexOutput o;
+	o.pos = mul(float4(v.vertex, 1.0f), gWVP);
+	return o;
+}
+
+
+// PIXEL SHADER
+float4 copyPix(vertexOutput i) : SV_Target {
+    return gInputTex.Load(int3(i.pos.xy, 0));
+}
+
+// TECHNIQUES
+technique11 copy {
+    pass p0 {
+        SetVertexShader(CompileShader(vs_5_0, quadVert()));
+        SetPixelShader(CompileShader(ps_5_0, copyPix()));
+    }
+}
@@ -4,14 +4,39 @@
 // Copyright: 2020 Artineering and/or its licensors
 // License: MIT
 ////////////////////////////////////////////////////////////////////////////////////////////////////
+// PERMUTATIONS (compiled per debug mode, see viewOverride::mDebugMode)
+#ifndef VISUALIZE
+#define VISUALIZE 0        // 0: color, 1: linear depth, 2: normals remapped to [0, 1]
+#endif
+#ifndef NORMAL_ENCODING
+#define NORMAL_ENCODING 0  // 0: none, 1: octahedral, 2: remapped to [0, 1]
+#endif
+#ifndef ALPHA_ONLY
+#define ALPHA_ONLY 0       // 1: shows the alpha channel alone
+#endif
+
 // COMMON MAYA VARIABLES
 float4x4 gWVP : WorldViewProjection;
 
 // TEXTURES
 Texture2D gInputTex;
+Texture2D gColorTex;
+Texture2D gDepthTex;
+Texture2D gNormalsTex;
+Texture2D gAccumTex;
+Texture2D gRevealageTex;
 
 // VARIABLES
 float4 gColorChannels = float4( 1.0, 1.0, 1.0, 0.0 );
+int gNormalEncoding = 0;  // tiles only, 0: none, 1: octahedral, 2: remapped to [0, 1]
+float4 gDepthParams = float4( 0.1, 10000.0, 0.0, 0.0 );  // near, far, orthographic
+float4 gTileParams = float4( 1.0, 1.0, 3.0, 2.0 );  // viewport size, columns, rows
+int gTileCount = 3;
+float4 gTileChannels0 = float4( 1.0, 1.0, 1.0, 0.0 );
+float4 gTileChannels1 = float4( 1.0, 1.0, 1.0, 0.0 );
+float4 gTileChannels2 = float4( 1.0, 1.0, 1.0, 0.0 );
+float4 gTileChannels3 = float4( 1.0, 1.0, 1.0, 0.0 );
+float4 gTileChannels4 = float4( 1.0, 1.0, 1.0, 0.0 );
 
 // VERTEX SHADER
 struct appData {
@@ -30,16 +55,86 @@ vertexOutput quadVert(appData v) {
 
 
 // PIXEL SHADER
+// decodes packed G-buffer normals
+float4 decodeNormals(float4 tex, int encoding) {
+    if (encoding == 1) {
+        float3 n = float3(tex.xy, 1.0 - abs(tex.x) - abs(tex.y));
+        float t = max(-n.z, 0.0);
+        n.x += (n.x >= 0.0) ? -t : t;
+        n.y += (n.y >= 0.0) ? -t : t;
+        return float4(normalize(n), 1.0);
+    } else if (encoding == 2) {
+        return float4(normalize(tex.xyz * 2.0 - 1.0), tex.a);
+    }
+    return tex;
+}
+
+// linear depth between the clipping planes, in [0, 1]
+float linearDepth(float depth) {
+    float nearPlane = gDepthParams.x;
+    float farPlane = gDepthParams.y;
+    float viewDepth = (gDepthParams.z > 0.0) ? nearPlane + depth * (farPlane - nearPlane) : nearPlane * farPlane / (farPlane - depth * (farPlane - nearPlane));
+    return (viewDepth - nearPlane) / (farPlane - nearPlane);
+}
+
+// makes the contents of a target visible (0: color, 1: depth, 2: normals)
+float4 visualize(float4 tex, int target, int encoding) {
+    if (target == 1) {
+        float depth = linearDepth(tex.r);
+        return float4(depth, depth, depth, 1.0);
+    } else if (target == 2) {
+        float4 normals = decodeNormals(tex, encoding);
+        return float4(normals.xyz * 0.5 + 0.5, normals.a);
+    }
+    return tex;
+}
+
+// channel debugger
+float4 maskChannels(float4 tex, float4 channels) {
+    if (channels.a > 0) {
+        return float4(tex.a, tex.a, tex.a, tex.a);
+    }
+    return float4(channels.r * tex.r, channels.g * tex.g, channels.b * tex.b, tex.a);
+}
+
+// the permutation macros are constant, so the compiler strips the branches that don't apply
 float4 debugPix(vertexOutput i) : SV_Target {
     int3 loc = int3(i.pos.xy, 0);
-    float4 tex = gInputTex.Load(loc);
+    float4 tex = visualize(gInputTex.Load(loc), VISUALIZE, NORMAL_ENCODING);
+#if ALPHA_ONLY
+    return float4(tex.a, tex.a, tex.a, tex.a);
+#else
+    return float4(gColorChannels.rgb * tex.rgb, tex.a);
+#endif
+}
 
-    // channel debugger
-    if (gColorChannels.a > 0) {
-        return float4(tex.a, tex.a, tex.a, tex.a);
+float4 tilesPix(vertexOutput i) : SV_Target {
+    // tiles are laid out from the top left corner
+    float2 tileSize = floor(gTileParams.xy / gTileParams.zw);
+    int2 tile = int2(i.pos.xy / tileSize);
+    int index = tile.y * int(gTileParams.z) + tile.x;
+    int3 loc = int3(frac(i.pos.xy / tileSize) * gTileParams.xy, 0);
+    float4 tex = float4(0.0, 0.0, 0.0, 1.0);
+    float4 channels = float4(0.0, 0.0, 0.0, 0.0);
+    if (tile.x >= int(gTileParams.z) || tile.y >= int(gTileParams.w) || index >= gTileCount) {
+        index = -1;
+    } else if (index == 0) {
+        tex = gColorTex.Load(loc);
+        channels = gTileChannels0;
+    } else if (index == 1) {
+        tex = gDepthTex.Load(loc);
+        channels = gTileChannels1;
+    } else if (index == 2) {
+        tex = gNormalsTex.Load(loc);
+        channels = gTileChannels2;
+    } else if (index == 3) {
+        tex = gAccumTex.Load(loc);
+        channels = gTileChannels3;
     } else {
-        return float4(gColorChannels.r * tex.r, gColorChannels.g * tex.g, gColorChannels.b * tex.b, tex.a);
+        tex = gRevealageTex.Load(loc);
+        channels = gTileChannels4;
     }
+    return float4(maskChannels(visualize(tex, index, gNormalEncoding), channels).rgb, 1.0);
 }
 
 // TECHNIQUES
@@ -49,3 +144,10 @@ technique11 debug {
         SetPixelShader(CompileShader(ps_5_0, debugPix()));
     }
 }
+
+technique11 tiles {
+    pass p0 {
+        SetVertexShader(CompileShader(vs_5_0, quadVert()));
+        SetPixelShader(CompileShader(ps_5_0, tilesPix()));
+    }
+}
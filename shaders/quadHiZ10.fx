@@ -0,0 +1,63 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// quadHiZ10.fx (HLSL)
+// Brief: Reduces the depth (or the previous level) into a min/max level of the depth pyramid
+// Copyright: 2020 Artineering and/or its licensors
+// License: MIT
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// PERMUTATIONS (the first level reduces the depth target)
+#ifndef DEPTH_SOURCE
+#define DEPTH_SOURCE 0     // 1: the input is the depth target, 0: the previous (min, max) level
+#endif
+
+// COMMON MAYA VARIABLES
+float4x4 gWVP : WorldViewProjection;
+
+// TEXTURES
+Texture2D gInputTex;
+
+// VARIABLES
+float4 gSourceSize = float4(1.0, 1.0, 0.0, 0.0);  // size of the depth or previous level (pixels)
+
+// VERTEX SHADER
+struct appData {
+	float3 vertex : POSITION;
+};
+
+struct vertexOutput {
+	float4 pos : SV_POSITION;
+};
+
+vertexOutput quadVert(appData v) {
+	vertexOutput o;
+	o.pos = mul(float4(v.vertex, 1.0f), gWVP);
+	return o;
+}
+
+
+// PIXEL SHADER
+// levels are rounded up, so the 2x2 texels are clamped to the source on odd sizes
+float2 fetchMinMax(int2 texel) {
+    texel = min(texel, int2(gSourceSize.xy) - 1);
+#if DEPTH_SOURCE
+    return gInputTex.Load(int3(texel, 0)).rr;
+#else
+    return gInputTex.Load(int3(texel, 0)).rg;
+#endif
+}
+
+float4 hiZPix(vertexOutput i) : SV_Target {
+    int2 src = int2(i.pos.xy) * 2;
+    float2 a = fetchMinMax(src);
+    float2 b = fetchMinMax(src + int2(1, 0));
+    float2 c = fetchMinMax(src + int2(0, 1));
+    float2 d = fetchMinMax(src + int2(1, 1));
+    return float4(min(min(a.x, b.x), min(c.x, d.x)), max(max(a.y, b.y), max(c.y, d.y)), 0.0, 0.0);
+}
+
+// TECHNIQUES
+technique11 reduce {
+    pass p0 {
+        SetVertexShader(CompileShader(vs_5_0, quadVert()));
+        SetPixelShader(CompileShader(ps_5_0, hiZPix()));
+    }
+}
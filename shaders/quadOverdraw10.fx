@@ -0,0 +1,90 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// quadOverdraw10.fx (HLSL)
+// Brief: Heatmap and statistics of the layers counted by the overdraw scene renders
+// Copyright: 2020 Artineering and/or its licensors
+// License: MIT
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// PERMUTATIONS (the first reduction decodes the layer counts)
+#ifndef LAYER_SOURCE
+#define LAYER_SOURCE 0     // 1: the input is a layer count target, 0: the previous reduction
+#endif
+
+// COMMON MAYA VARIABLES
+float4x4 gWVP : WorldViewProjection;
+
+// TEXTURES
+Texture2D gInputTex;
+
+// VARIABLES
+float4 gSourceSize = float4(1.0, 1.0, 0.0, 0.0);      // size of the input (pixels)
+float4 gOverdrawParams = float4(4.0, 0.0, 0.0, 0.0);  // layer threshold of the statistics
+
+// VERTEX SHADER
+struct appData {
+	float3 vertex : POSITION;
+};
+
+struct vertexOutput {
+	float4 pos : SV_POSITION;
+};
+
+vertexOutput quadVert(appData v) {
+	vertexOutput o;
+	o.pos = mul(float4(v.vertex, 1.0f), gWVP);
+	return o;
+}
+
+
+// PIXEL SHADER
+// the target is cleared to 1 and halved by every layer
+float layers(float4 value) {
+    return (value.r > 0.0) ? floor(-log2(value.r) + 0.5) : 150.0;
+}
+
+float4 heatmapPix(vertexOutput i) : SV_Target {
+    float n = layers(gInputTex.Load(int3(i.pos.xy, 0)));
+    // black, blue, green, yellow and red at 0, 1, 3, 7 and 15 layers, then white
+    float t = log2(n + 1.0);
+    float3 color = lerp(float3(0.0, 0.0, 0.0), float3(0.0, 0.2, 1.0), saturate(t));
+    color = lerp(color, float3(0.0, 0.9, 0.2), saturate(t - 1.0));
+    color = lerp(color, float3(1.0, 0.9, 0.0), saturate(t - 2.0));
+    color = lerp(color, float3(1.0, 0.1, 0.0), saturate(t - 3.0));
+    color = lerp(color, float3(1.0, 1.0, 1.0), saturate(t - 4.0));
+    return float4(color, 1.0);
+}
+
+float4 reducePix(vertexOutput i) : SV_Target {
+    // (sum, max, pixels above the threshold, pixels) of 8x8 texels within the input
+    int2 base = int2(i.pos.xy) * 8;
+    float4 reduced = float4(0.0, 0.0, 0.0, 0.0);
+    for (int y = 0; y < 8; y++) {
+        for (int x = 0; x < 8; x++) {
+            int2 texel = base + int2(x, y);
+            if (texel.x >= int(gSourceSize.x) || texel.y >= int(gSourceSize.y)) {
+                continue;
+            }
+            float4 value = gInputTex.Load(int3(texel, 0));
+#if LAYER_SOURCE
+            float n = layers(value);
+            value = float4(n, n, (n > gOverdrawParams.x) ? 1.0 : 0.0, 1.0);
+#endif
+            reduced = float4(reduced.x + value.x, max(reduced.y, value.y), reduced.zw + value.zw);
+        }
+    }
+    return reduced;
+}
+
+// TECHNIQUES
+technique11 heatmap {
+    pass p0 {
+        SetVertexShader(CompileShader(vs_5_0, quadVert()));
+        SetPixelShader(CompileShader(ps_5_0, heatmapPix()));
+    }
+}
+
+technique11 reduce {
+    pass p0 {
+        SetVertexShader(CompileShader(vs_5_0, quadVert()));
+        SetPixelShader(CompileShader(ps_5_0, reducePix()));
+    }
+}
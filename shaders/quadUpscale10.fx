@@ -0,0 +1,63 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// quadUpscale10.fx (HLSL)
+// Brief: Upscales the scaled scene targets to the viewport (dynamic resolution)
+// Copyright: 2020 Artineering and/or its licensors
+// License: MIT
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// COMMON MAYA VARIABLES
+float4x4 gWVP : WorldViewProjection;
+
+// TEXTURES
+Texture2D gColorTex;
+Texture2D gDepthTex;
+
+// SAMPLERS
+SamplerState gLinearSampler {
+    Filter = MIN_MAG_MIP_LINEAR;
+    AddressU = Clamp;
+    AddressV = Clamp;
+};
+
+// VARIABLES
+float4 gScaleParams = float4(1.0, 1.0, 1.0, 1.0);  // scaled / viewport size, 1 / target size
+float4 gSourceSize = float4(1.0, 1.0, 0.0, 0.0);   // scaled viewport size (pixels)
+
+// VERTEX SHADER
+struct appData {
+	float3 vertex : POSITION;
+};
+
+struct vertexOutput {
+	float4 pos : SV_POSITION;
+};
+
+vertexOutput quadVert(appData v) {
+	vertexOutput o;
+	o.pos = mul(float4(v.vertex, 1.0f), gWVP);
+	return o;
+}
+
+
+// PIXEL SHADER
+struct fragmentOutput {
+    float4 color : SV_Target0;
+    float depth : SV_Depth;
+};
+
+fragmentOutput upscalePix(vertexOutput i) {
+    fragmentOutput o;
+    // position in the scaled sub-rectangle, kept off its edges so that filtering doesn't bleed
+    float2 src = clamp(i.pos.xy * gScaleParams.xy, 0.5, gSourceSize.xy - 0.5);
+    o.color = gColorTex.SampleLevel(gLinearSampler, src * gScaleParams.zw, 0);  // bilinear
+    // depth isn't filtered, so that the UI is tested against actual surfaces
+    o.depth = gDepthTex.Load(int3(src, 0)).r;
+    return o;
+}
+
+// TECHNIQUES
+technique11 upscale {
+    pass p0 {
+        SetVertexShader(CompileShader(vs_5_0, quadVert()));
+        SetPixelShader(CompileShader(ps_5_0, upscalePix()));
+    }
+}
@@ -0,0 +1,17 @@
+// Title         M3dView.h
+// Summary       Stand-in for the Maya devkit 3D view
+// Copyright     2020 Artineering and/or its licensors
+// License       MIT
+
+#pragma once
+#include <maya/MString.h>
+
+class M3dView {
+public:
+    static MStatus scheduleRefreshAllViews() { return MS::kSuccess; }
+    static MStatus getM3dViewFromModelPanel(const MString& modelPaneName, M3dView& view) { return MS::kSuccess; }
+    MStatus scheduleRefresh() { return MS::kSuccess; }
+    MStatus refresh(bool all = false, bool force = false) { return MS::kSuccess; }
+    int portWidth(MStatus* status = nullptr) const { return 0; }
+    int portHeight(MStatus* status = nullptr) const { return 0; }
+};
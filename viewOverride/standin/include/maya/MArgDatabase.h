@@ -0,0 +1,89 @@
+// Title         MArgDatabase.h
+// Summary       Stand-in for the Maya devkit argument database
+// Copyright     2020 Artineering and/or its licensors
+// License       MIT
+
+#pragma once
+#include <map>
+#include <string>
+#include <maya/MSyntax.h>
+#include <maya/MArgList.h>
+
+class MArgDatabase {
+public:
+    MArgDatabase(const MSyntax& syntax, const MArgList& argList, MStatus* status = nullptr) : mQuery(false) {
+        MStatus result = MS::kSuccess;
+        for (unsigned int i = 0; i < argList.length(); i++) {
+            std::string arg = argList.asString(i).asChar();
+            if (arg == "-q" || arg == "-query") {
+                mQuery = syntax.standinQueryEnabled();
+                continue;
+            }
+            const MSyntax::Flag* flag = syntax.standinFind(arg);
+            if (!flag) {
+                result = MS::kInvalidParameter;
+                continue;
+            }
+            std::vector<MString>& values = mFlags[flag->shortName];
+            values.clear();
+            // query flags take no arguments
+            for (size_t a = 0; a < flag->args.size() && !mQuery; a++) {
+                if (i + 1 < argList.length()) {
+                    values.push_back(argList.asString(++i));
+                }
+            }
+        }
+        if (status) *status = result;
+    }
+
+    bool isQuery(MStatus* status = nullptr) const { if (status) *status = MS::kSuccess; return mQuery; }
+    bool isFlagSet(const char* flag, MStatus* status = nullptr) const {
+        if (status) *status = MS::kSuccess;
+        return mFlags.find(flag) != mFlags.end();
+    }
+    MStatus getFlagArgument(const char* flag, unsigned int index, bool& result) const {
+        const MString* v = mFind(flag, index);
+        if (!v) return MS::kFailure;
+        result = (*v == "1" || *v == "true" || *v == "on");
+        return MS::kSuccess;
+    }
+    MStatus getFlagArgument(const char* flag, unsigned int index, int& result) const {
+        const MString* v = mFind(flag, index);
+        if (!v) return MS::kFailure;
+        result = (*v == "true" || *v == "on") ? 1 : v->asInt();
+        return MS::kSuccess;
+    }
+    MStatus getFlagArgument(const char* flag, unsigned int index, unsigned int& result) const {
+        const MString* v = mFind(flag, index);
+        if (!v) return MS::kFailure;
+        result = (unsigned int)v->asInt();
+        return MS::kSuccess;
+    }
+    MStatus getFlagArgument(const char* flag, unsigned int index, double& result) const {
+        const MString* v = mFind(flag, index);
+        if (!v) return MS::kFailure;
+        result = v->asDouble();
+        return MS::kSuccess;
+    }
+    MStatus getFlagArgument(const char* flag, unsigned int index, MString& result) const {
+        const MString* v = mFind(flag, index);
+        if (!v) return MS::kFailure;
+        result = *v;
+        return MS::kSuccess;
+    }
+    bool getFlagArgumentBool(const char* flag, unsigned int index, MStatus* status = nullptr) const {
+        bool value = false;
+        MStatus s = getFlagArgument(flag, index, value);
+        if (status) *status = s;
+        return value;
+    }
+
+private:
+    const MString* mFind(const char* flag, unsigned int index) const {
+        auto it = mFlags.find(flag);
+        if (it == mFlags.end() || index >= it->second.size()) return nullptr;
+        return &it->second[index];
+    }
+    std::map<std::string, std::vector<MString>> mFlags;
+    bool mQuery;
+};
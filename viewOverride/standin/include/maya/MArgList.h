@@ -0,0 +1,17 @@
+// Title         MArgList.h
+// Summary       Stand-in for the Maya devkit argument list
+// Copyright     2020 Artineering and/or its licensors
+// License       MIT
+
+#pragma once
+#include <maya/MString.h>
+
+class MArgList {
+public:
+    unsigned int length(MStatus* status = nullptr) const { if (status) *status = MS::kSuccess; return mArgs.length(); }
+    MArgList& addArg(const MString& arg) { mArgs.append(arg); return *this; }
+    MArgList& addArg(const char* arg) { mArgs.append(MString(arg)); return *this; }
+    const MString& asString(unsigned int index) const { return mArgs[index]; }
+private:
+    MStringArray mArgs;
+};
@@ -0,0 +1,42 @@
+// Title         MBoundingBox.h
+// Summary       Stand-in for the Maya devkit bounding box class
+// Copyright     2020 Artineering and/or its licensors
+// License       MIT
+
+#pragma once
+#include <algorithm>
+#include <maya/MPoint.h>
+#include <maya/MMatrix.h>
+
+class MBoundingBox {
+public:
+    MBoundingBox() : mEmpty(true) {}
+    MBoundingBox(const MPoint& corner1, const MPoint& corner2) : mEmpty(true) { expand(corner1); expand(corner2); }
+    void expand(const MPoint& p) {
+        if (mEmpty) { mMin = p; mMax = p; mEmpty = false; return; }
+        mMin.x = std::min(mMin.x, p.x); mMin.y = std::min(mMin.y, p.y); mMin.z = std::min(mMin.z, p.z);
+        mMax.x = std::max(mMax.x, p.x); mMax.y = std::max(mMax.y, p.y); mMax.z = std::max(mMax.z, p.z);
+    }
+    void expand(const MBoundingBox& box) { if (!box.mEmpty) { expand(box.mMin); expand(box.mMax); } }
+    void clear() { mEmpty = true; }
+    MPoint min() const { return mMin; }
+    MPoint max() const { return mMax; }
+    double width() const { return mEmpty ? 0.0 : mMax.x - mMin.x; }
+    double height() const { return mEmpty ? 0.0 : mMax.y - mMin.y; }
+    double depth() const { return mEmpty ? 0.0 : mMax.z - mMin.z; }
+    MBoundingBox& transformUsing(const MMatrix& m) {
+        if (mEmpty) return *this;
+        MPoint lo = mMin, hi = mMax;
+        mEmpty = true;
+        for (int i = 0; i < 8; i++) {
+            MPoint p((i & 1) ? hi.x : lo.x, (i & 2) ? hi.y : lo.y, (i & 4) ? hi.z : lo.z);
+            expand(MPoint(p.x * m(0, 0) + p.y * m(1, 0) + p.z * m(2, 0) + m(3, 0),
+                          p.x * m(0, 1) + p.y * m(1, 1) + p.z * m(2, 1) + m(3, 1),
+                          p.x * m(0, 2) + p.y * m(1, 2) + p.z * m(2, 2) + m(3, 2)));
+        }
+        return *this;
+    }
+private:
+    MPoint mMin, mMax;
+    bool mEmpty;
+};
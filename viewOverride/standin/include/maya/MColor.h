@@ -0,0 +1,14 @@
+// Title         MColor.h
+// Summary       Stand-in for the Maya devkit color class
+// Copyright     2020 Artineering and/or its licensors
+// License       MIT
+
+#pragma once
+#include <maya/MTypes.h>
+
+class MColor {
+public:
+    MColor() : r(0.0f), g(0.0f), b(0.0f), a(1.0f) {}
+    MColor(float rr, float gg, float bb, float aa = 1.0f) : r(rr), g(gg), b(bb), a(aa) {}
+    float r, g, b, a;
+};
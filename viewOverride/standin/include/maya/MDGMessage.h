@@ -0,0 +1,21 @@
+// Title         MDGMessage.h
+// Summary       Stand-in for the Maya devkit dependency graph messages
+// Copyright     2020 Artineering and/or its licensors
+// License       MIT
+
+#pragma once
+#include <maya/MMessage.h>
+
+class MDGMessage : public MMessage {
+public:
+    static MCallbackId addNodeAddedCallback(MMessage::MNodeFunction func, const MString& nodeType = "dependNode",
+        void* clientData = nullptr, MStatus* status = nullptr) {
+        if (status) *status = MS::kSuccess;
+        return standinAdd("nodeAdded", nullptr, func, clientData);
+    }
+    static MCallbackId addNodeRemovedCallback(MMessage::MNodeFunction func, const MString& nodeType = "dependNode",
+        void* clientData = nullptr, MStatus* status = nullptr) {
+        if (status) *status = MS::kSuccess;
+        return standinAdd("nodeRemoved", nullptr, func, clientData);
+    }
+};
@@ -0,0 +1,24 @@
+// Title         MDagPath.h
+// Summary       Stand-in for the Maya devkit DAG path class
+// Copyright     2020 Artineering and/or its licensors
+// License       MIT
+
+#pragma once
+#include <maya/MString.h>
+#include <maya/MMatrix.h>
+
+class MDagPath {
+public:
+    MDagPath() {}
+    explicit MDagPath(const MString& name) : mName(name) {}
+    bool isValid() const { return mName.length() > 0; }
+    MString fullPathName(MStatus* status = nullptr) const { if (status) *status = MS::kSuccess; return mName; }
+    MMatrix inclusiveMatrix(MStatus* status = nullptr) const { if (status) *status = MS::kSuccess; return mInclusiveMatrix; }
+    bool operator==(const MDagPath& other) const { return mName == other.mName; }
+
+    // stand-in only: world matrix of the path
+    void standinSetInclusiveMatrix(const MMatrix& matrix) { mInclusiveMatrix = matrix; }
+private:
+    MString mName;
+    MMatrix mInclusiveMatrix;
+};
@@ -0,0 +1,7 @@
+// Title         MDrawContext.h
+// Summary       Stand-in for the Maya devkit draw context
+// Copyright     2020 Artineering and/or its licensors
+// License       MIT
+
+#pragma once
+#include <maya/MFrameContext.h>
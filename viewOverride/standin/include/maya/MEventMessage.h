@@ -0,0 +1,16 @@
+// Title         MEventMessage.h
+// Summary       Stand-in for the Maya devkit event messages
+// Copyright     2020 Artineering and/or its licensors
+// License       MIT
+
+#pragma once
+#include <maya/MMessage.h>
+
+class MEventMessage : public MMessage {
+public:
+    static MCallbackId addEventCallback(const MString& eventName, MMessage::MBasicFunction func,
+        void* clientData = nullptr, MStatus* status = nullptr) {
+        if (status) *status = MS::kSuccess;
+        return standinAdd(eventName.asChar(), func, nullptr, clientData);
+    }
+};
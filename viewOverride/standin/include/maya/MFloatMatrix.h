@@ -0,0 +1,20 @@
+// Title         MFloatMatrix.h
+// Summary       Stand-in for the Maya devkit float matrix class
+// Copyright     2020 Artineering and/or its licensors
+// License       MIT
+
+#pragma once
+#include <maya/MTypes.h>
+
+class MFloatMatrix {
+public:
+    MFloatMatrix() {
+        for (int r = 0; r < 4; r++)
+            for (int c = 0; c < 4; c++)
+                matrix[r][c] = (r == c) ? 1.0f : 0.0f;
+    }
+    float& operator()(unsigned int row, unsigned int col) { return matrix[row][col]; }
+    float operator()(unsigned int row, unsigned int col) const { return matrix[row][col]; }
+
+    float matrix[4][4];
+};
@@ -0,0 +1,14 @@
+// Title         MFloatPoint.h
+// Summary       Stand-in for the Maya devkit float point class
+// Copyright     2020 Artineering and/or its licensors
+// License       MIT
+
+#pragma once
+#include <maya/MTypes.h>
+
+class MFloatPoint {
+public:
+    MFloatPoint() : x(0.0f), y(0.0f), z(0.0f), w(1.0f) {}
+    MFloatPoint(float xx, float yy, float zz = 0.0f, float ww = 1.0f) : x(xx), y(yy), z(zz), w(ww) {}
+    float x, y, z, w;
+};
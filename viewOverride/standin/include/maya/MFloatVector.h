@@ -0,0 +1,14 @@
+// Title         MFloatVector.h
+// Summary       Stand-in for the Maya devkit float vector class
+// Copyright     2020 Artineering and/or its licensors
+// License       MIT
+
+#pragma once
+#include <maya/MTypes.h>
+
+class MFloatVector {
+public:
+    MFloatVector() : x(0.0f), y(0.0f), z(0.0f) {}
+    MFloatVector(float xx, float yy, float zz = 0.0f) : x(xx), y(yy), z(zz) {}
+    float x, y, z;
+};
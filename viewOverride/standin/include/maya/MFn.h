@@ -0,0 +1,26 @@
+// Title         MFn.h
+// Summary       Stand-in for the Maya devkit function set types
+// Copyright     2020 Artineering and/or its licensors
+// License       MIT
+
+#pragma once
+
+class MFn {
+public:
+    enum Type {
+        kInvalid = 0,
+        kBase,
+        kDependencyNode,
+        kDagNode,
+        kTransform,
+        kShape,
+        kMesh,
+        kCamera,
+        kLight,
+        kShadingEngine,
+        kLambert,
+        kTexture2d,
+        kTexture3d,
+        kPluginHardwareShader
+    };
+};
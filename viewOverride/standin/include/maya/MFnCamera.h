@@ -0,0 +1,20 @@
+// Title         MFnCamera.h
+// Summary       Stand-in for the Maya devkit camera function set
+// Copyright     2020 Artineering and/or its licensors
+// License       MIT
+
+#pragma once
+#include <maya/MStatus.h>
+#include <maya/MDagPath.h>
+
+class MFnCamera {
+public:
+    MFnCamera(const MDagPath& path, MStatus* status = nullptr) : mValid(path.isValid()) {
+        if (status) *status = mValid ? MS::kSuccess : MS::kFailure;
+    }
+    double nearClippingPlane(MStatus* status = nullptr) const { if (status) *status = MS::kSuccess; return 0.1; }
+    double farClippingPlane(MStatus* status = nullptr) const { if (status) *status = MS::kSuccess; return 10000.0; }
+    bool isOrtho(MStatus* status = nullptr) const { if (status) *status = MS::kSuccess; return false; }
+private:
+    bool mValid;
+};
@@ -0,0 +1,76 @@
+// Title         MFnDagNode.h
+// Summary       Stand-in for the Maya devkit DAG node function set
+// Copyright     2020 Artineering and/or its licensors
+// License       MIT
+
+#pragma once
+#include <vector>
+#include <maya/MStatus.h>
+#include <maya/MString.h>
+#include <maya/MDagPath.h>
+#include <maya/MBoundingBox.h>
+
+class MFnDagNode {
+public:
+    MFnDagNode(const MObject& object, MStatus* status = nullptr) : mNode(object.standinNode()) {
+        bool valid = object.hasFn(MFn::kDagNode) && mNode < (int)standinNodes().size();
+        if (!valid) mNode = -1;
+        if (status) *status = valid ? MS::kSuccess : MS::kFailure;
+    }
+    MBoundingBox boundingBox(MStatus* status = nullptr) const {
+        if (status) *status = (mNode >= 0) ? MS::kSuccess : MS::kFailure;
+        return (mNode >= 0) ? standinNodes()[mNode].bounds : MBoundingBox();
+    }
+    unsigned int childCount(MStatus* status = nullptr) const {
+        if (status) *status = (mNode >= 0) ? MS::kSuccess : MS::kFailure;
+        return (mNode >= 0) ? (unsigned int)standinNodes()[mNode].children.size() : 0;
+    }
+    MObject child(unsigned int i, MStatus* status = nullptr) const {
+        bool valid = (mNode >= 0) && i < standinNodes()[mNode].children.size();
+        if (status) *status = valid ? MS::kSuccess : MS::kFailure;
+        if (!valid) return MObject();
+        int node = standinNodes()[mNode].children[i];
+        return MObject(node, standinNodes()[node].types);
+    }
+    MStatus getPath(MDagPath& path) const {
+        if (mNode < 0) return MS::kFailure;
+        path = MDagPath(standinNodes()[mNode].name);
+        path.standinSetInclusiveMatrix(standinNodes()[mNode].world);
+        return MS::kSuccess;
+    }
+
+    // stand-in only: nodes of the given types, and shapes with object space bounds and a world matrix,
+    // driven from a harness
+    static MObject standinCreateNode(const MString& name, unsigned int types) {
+        types |= (1u << MFn::kDependencyNode);
+        standinNodes().push_back({ name, MBoundingBox(), MMatrix(), types, std::vector<int>() });
+        return MObject((int)standinNodes().size() - 1, types);
+    }
+    static MObject standinCreateTransform(const MString& name) {
+        return standinCreateNode(name, (1u << MFn::kDagNode) | (1u << MFn::kTransform));
+    }
+    static void standinAddChild(const MObject& parent, const MObject& child) {
+        standinNodes()[parent.standinNode()].children.push_back(child.standinNode());
+    }
+    static MObject standinCreateShape(const MString& name, const MBoundingBox& bounds, unsigned int extraTypes = 0) {
+        MObject shape = standinCreateNode(name, (1u << MFn::kDagNode) | (1u << MFn::kShape) | extraTypes);
+        standinNodes()[shape.standinNode()].bounds = bounds;
+        return shape;
+    }
+    static void standinSetWorldMatrix(const MObject& object, const MMatrix& world) {
+        standinNodes()[object.standinNode()].world = world;
+    }
+private:
+    struct StandinNode {
+        MString name;
+        MBoundingBox bounds;
+        MMatrix world;
+        unsigned int types;
+        std::vector<int> children;
+    };
+    static std::vector<StandinNode>& standinNodes() {
+        static std::vector<StandinNode> nodes;
+        return nodes;
+    }
+    int mNode;
+};
@@ -0,0 +1,20 @@
+// Title         MFnPlugin.h
+// Summary       Stand-in for the Maya devkit plugin function set
+// Copyright     2020 Artineering and/or its licensors
+// License       MIT
+
+#pragma once
+#include <maya/MString.h>
+#include <maya/MSyntax.h>
+
+typedef void* (*MCreatorFunction)();
+typedef MSyntax (*MCreateSyntaxFunction)();
+
+class MFnPlugin {
+public:
+    MFnPlugin(MObject& object, const char* vendor = "Unknown", const char* version = "Unknown",
+        const char* requiredApiVersion = "Any", MStatus* status = nullptr) {}
+    MStatus registerCommand(const MString& commandName, MCreatorFunction creatorFunction,
+        MCreateSyntaxFunction createSyntaxFunction = nullptr) { return MS::kSuccess; }
+    MStatus deregisterCommand(const MString& commandName) { return MS::kSuccess; }
+};
@@ -0,0 +1,105 @@
+// Title         MFrameContext.h
+// Summary       Stand-in for the Maya devkit frame and draw contexts
+// Copyright     2020 Artineering and/or its licensors
+// License       MIT
+
+#pragma once
+#include <maya/MString.h>
+#include <maya/MMatrix.h>
+#include <maya/MDagPath.h>
+#include <maya/MStateManager.h>
+
+namespace MHWRender {
+
+class MFrameContext {
+public:
+    enum MatrixType {
+        kWorldMtx = 0,
+        kWorldTransposeMtx,
+        kWorldInverseMtx,
+        kWorldTranspInverseMtx,
+        kViewMtx,
+        kViewTransposeMtx,
+        kViewInverseMtx,
+        kViewTranspInverseMtx,
+        kProjectionMtx,
+        kProjectionTranposeMtx,
+        kProjectionInverseMtx,
+        kProjectionTranspInverseMtx,
+        kViewProjMtx,
+        kViewProjTransposeMtx,
+        kViewProjInverseMtx,
+        kViewProjTranspInverseMtx,
+        kWorldViewMtx,
+        kWorldViewTransposeMtx,
+        kWorldViewInverseMtx,
+        kWorldViewTranspInverseMtx,
+        kWorldViewProjMtx,
+        kWorldViewProjTransposeMtx,
+        kWorldViewProjInverseMtx,
+        kWorldViewProjTranspInverseMtx,
+        kMatrixTypeCount
+    };
+    enum DisplayStyle {
+        kGouraudShaded = 0x1,
+        kWireFrame = 0x2,
+        kBoundingBox = 0x4,
+        kTextured = 0x8,
+        kDefaultMaterial = 0x10,
+        kXrayJoint = 0x20,
+        kXray = 0x40,
+        kTwoSidedLighting = 0x80,
+        kFlatShaded = 0x100,
+        kShadeActiveOnly = 0x200,
+        kXrayActiveComponents = 0x400,
+        kBackfaceCulling = 0x800,
+        kSmoothWireframe = 0x1000
+    };
+
+    MStatus getViewportDimensions(int& originX, int& originY, int& width, int& height) const {
+        originX = mOriginX; originY = mOriginY; width = mWidth; height = mHeight;
+        return MS::kSuccess;
+    }
+    MMatrix getMatrix(MatrixType mtype, MStatus* returnStatus = nullptr) const {
+        if (returnStatus) *returnStatus = MS::kSuccess;
+        if (mtype == kViewMtx) return mView;
+        if (mtype == kProjectionMtx) return mProjection;
+        if (mtype == kViewProjMtx) return mView * mProjection;
+        return MMatrix();
+    }
+    unsigned int getDisplayStyle() const { return mDisplayStyle; }
+    MDagPath getCurrentCameraPath(MStatus* returnStatus = nullptr) const {
+        if (returnStatus) *returnStatus = MS::kSuccess;
+        return mCamera;
+    }
+
+    // stand-in only: drive the frame state from a harness
+    void standinSetViewportDimensions(int originX, int originY, int width, int height) {
+        mOriginX = originX; mOriginY = originY; mWidth = width; mHeight = height;
+    }
+    void standinSetMatrices(const MMatrix& view, const MMatrix& projection) {
+        mView = view; mProjection = projection;
+    }
+    void standinSetDisplayStyle(unsigned int displayStyle) { mDisplayStyle = displayStyle; }
+
+protected:
+    friend class MRenderer;
+    MFrameContext() : mOriginX(0), mOriginY(0), mWidth(640), mHeight(480), mCamera(MString("|persp|perspShape")) {}
+    virtual ~MFrameContext() {}
+    int mOriginX, mOriginY, mWidth, mHeight;
+    MMatrix mView, mProjection;
+    unsigned int mDisplayStyle = kGouraudShaded;
+    MDagPath mCamera;
+};
+
+class MDrawContext : public MFrameContext {
+public:
+    MStatus getRenderTargetSize(int& width, int& height) const { width = mWidth; height = mHeight; return MS::kSuccess; }
+    MStateManager* getStateManager() const { return &mStateManager; }
+protected:
+    friend class MRenderer;
+    MDrawContext() {}
+    mutable MStateManager mStateManager;
+};
+
+}  // namespace MHWRender
@@ -0,0 +1,18 @@
+// Title         MGlobal.h
+// Summary       Stand-in for the Maya devkit global functions
+// Copyright     2020 Artineering and/or its licensors
+// License       MIT
+
+#pragma once
+#include <maya/MString.h>
+#include <maya/MSelectionList.h>
+
+class MGlobal {
+public:
+    static MString executeCommandStringResult(const MString& command, bool displayEnabled = false, bool undoEnabled = false, MStatus* status = nullptr);
+    static MStatus executeCommand(const MString& command, bool displayEnabled = false, bool undoEnabled = false);
+    static MStatus getSelectionListByName(const MString& name, MSelectionList& list) { list.clear(); return list.add(name); }
+    static void displayInfo(const MString& message) { cout << message << endl; }
+    static void displayWarning(const MString& message) { cout << "Warning: " << message << endl; }
+    static void displayError(const MString& message) { cerr << "Error: " << message << endl; }
+};
@@ -0,0 +1,12 @@
+// Title         MIOStream.h
+// Summary       Stand-in for the Maya devkit iostream header
+// Copyright     2020 Artineering and/or its licensors
+// License       MIT
+
+#pragma once
+#include <iostream>
+
+// the devkit pulls these into the global namespace with REQUIRE_IOSTREAM
+using std::cout;
+using std::cerr;
+using std::endl;
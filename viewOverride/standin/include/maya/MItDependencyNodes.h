@@ -0,0 +1,16 @@
+// Title         MItDependencyNodes.h
+// Summary       Stand-in for the Maya devkit dependency node iterator
+// Copyright     2020 Artineering and/or its licensors
+// License       MIT
+
+#pragma once
+#include <maya/MStatus.h>
+
+// the stand-in has no dependency graph, so there are no nodes to iterate
+class MItDependencyNodes {
+public:
+    MItDependencyNodes(MStatus* status = nullptr) { if (status) *status = MS::kSuccess; }
+    bool isDone(MStatus* status = nullptr) const { if (status) *status = MS::kSuccess; return true; }
+    MStatus next() { return MS::kSuccess; }
+    MObject thisNode(MStatus* status = nullptr) const { if (status) *status = MS::kSuccess; return MObject(); }
+};
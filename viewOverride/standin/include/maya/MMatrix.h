@@ -0,0 +1,45 @@
+// Title         MMatrix.h
+// Summary       Stand-in for the Maya devkit matrix class
+// Copyright     2020 Artineering and/or its licensors
+// License       MIT
+
+#pragma once
+#include <cmath>
+#include <maya/MTypes.h>
+
+class MMatrix {
+public:
+    MMatrix() {
+        for (int r = 0; r < 4; r++)
+            for (int c = 0; c < 4; c++)
+                matrix[r][c] = (r == c) ? 1.0 : 0.0;
+    }
+    double& operator()(unsigned int row, unsigned int col) { return matrix[row][col]; }
+    double operator()(unsigned int row, unsigned int col) const { return matrix[row][col]; }
+    const double* operator[](unsigned int row) const { return matrix[row]; }
+    double* operator[](unsigned int row) { return matrix[row]; }
+    MMatrix operator*(const MMatrix& right) const {
+        MMatrix result;
+        for (int r = 0; r < 4; r++) {
+            for (int c = 0; c < 4; c++) {
+                double sum = 0.0;
+                for (int k = 0; k < 4; k++) sum += matrix[r][k] * right.matrix[k][c];
+                result.matrix[r][c] = sum;
+            }
+        }
+        return result;
+    }
+    bool operator==(const MMatrix& other) const { return isEquivalent(other, 0.0); }
+    bool operator!=(const MMatrix& other) const { return !isEquivalent(other, 0.0); }
+    bool isEquivalent(const MMatrix& other, double tolerance = 1e-10) const {
+        for (int r = 0; r < 4; r++)
+            for (int c = 0; c < 4; c++)
+                if (std::fabs(matrix[r][c] - other.matrix[r][c]) > tolerance) return false;
+        return true;
+    }
+    static const MMatrix identity;
+
+    double matrix[4][4];
+};
+
+
@@ -0,0 +1,58 @@
+// Title         MMessage.h
+// Summary       Stand-in for the Maya devkit message base class
+// Copyright     2020 Artineering and/or its licensors
+// License       MIT
+
+#pragma once
+#include <map>
+#include <string>
+#include <maya/MString.h>
+
+class MMessage {
+public:
+    typedef void (*MBasicFunction)(void* clientData);
+    typedef void (*MStringFunction)(const MString& str, void* clientData);
+    typedef void (*MNodeFunction)(MObject& node, void* clientData);
+    static MStatus removeCallback(MCallbackId id) {
+        standinCallbacks().erase(id);
+        return MS::kSuccess;
+    }
+
+    // stand-in only: invoke the callbacks registered for a message from a harness
+    static void standinEmit(const std::string& message) {
+        MObject node;
+        standinEmit(message, node);
+    }
+    static void standinEmit(const std::string& message, MObject& node) {
+        std::map<MCallbackId, StandinCallback> callbacks = standinCallbacks();  // callbacks may add or remove others
+        for (std::map<MCallbackId, StandinCallback>::iterator it = callbacks.begin(); it != callbacks.end(); ++it) {
+            if (it->second.message != message || (it->second.standinNode >= 0 && it->second.standinNode != node.standinNode())) {
+                continue;
+            }
+            if (it->second.basic) it->second.basic(it->second.clientData);
+            if (it->second.node) it->second.node(node, it->second.clientData);
+        }
+    }
+    static size_t standinCallbackCount() { return standinCallbacks().size(); }
+
+protected:
+    struct StandinCallback {
+        std::string message;
+        MBasicFunction basic;
+        MNodeFunction node;
+        void* clientData;
+        int standinNode;  ///< node the callback is registered on (-1 for all)
+    };
+    static std::map<MCallbackId, StandinCallback>& standinCallbacks() {
+        static std::map<MCallbackId, StandinCallback> callbacks;
+        return callbacks;
+    }
+    static MCallbackId standinNextId() { static MCallbackId id = 0; return ++id; }
+    static MCallbackId standinAdd(const std::string& message, MBasicFunction basic, MNodeFunction node, void* clientData,
+        int standinNode = -1) {
+        MCallbackId id = standinNextId();
+        StandinCallback callback = { message, basic, node, clientData, standinNode };
+        standinCallbacks()[id] = callback;
+        return id;
+    }
+};
@@ -0,0 +1,21 @@
+// Title         MNodeMessage.h
+// Summary       Stand-in for the Maya devkit node messages
+// Copyright     2020 Artineering and/or its licensors
+// License       MIT
+
+#pragma once
+#include <maya/MMessage.h>
+
+class MNodeMessage : public MMessage {
+public:
+    static MCallbackId addNodeDirtyCallback(MObject& node, MMessage::MBasicFunction func,
+        void* clientData = nullptr, MStatus* status = nullptr) {
+        if (status) *status = MS::kSuccess;
+        return standinAdd("nodeDirty", func, nullptr, clientData, node.standinNode());
+    }
+    static MCallbackId addNodeDirtyCallback(MObject& node, MMessage::MNodeFunction func,
+        void* clientData = nullptr, MStatus* status = nullptr) {
+        if (status) *status = MS::kSuccess;
+        return standinAdd("nodeDirty", nullptr, func, clientData, node.standinNode());
+    }
+};
@@ -0,0 +1,21 @@
+// Title         MObjectHandle.h
+// Summary       Stand-in for the Maya devkit object handle
+// Copyright     2020 Artineering and/or its licensors
+// License       MIT
+
+#pragma once
+#include <maya/MTypes.h>
+
+class MObjectHandle {
+public:
+    MObjectHandle() {}
+    MObjectHandle(const MObject& object) : mObject(object) {}
+    bool isValid() const { return !mObject.isNull(); }
+    bool isAlive() const { return !mObject.isNull(); }
+    unsigned int hashCode() const { return (unsigned int)(mObject.standinNode() + 1); }
+    const MObject& objectRef() const { return mObject; }
+    MObject object() const { return mObject; }
+    bool operator==(const MObject& object) const { return object.standinNode() == mObject.standinNode(); }
+private:
+    MObject mObject;
+};
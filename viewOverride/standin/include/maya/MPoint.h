@@ -0,0 +1,14 @@
+// Title         MPoint.h
+// Summary       Stand-in for the Maya devkit point classes
+// Copyright     2020 Artineering and/or its licensors
+// License       MIT
+
+#pragma once
+#include <maya/MTypes.h>
+
+class MPoint {
+public:
+    MPoint() : x(0.0), y(0.0), z(0.0), w(1.0) {}
+    MPoint(double xx, double yy, double zz = 0.0, double ww = 1.0) : x(xx), y(yy), z(zz), w(ww) {}
+    double x, y, z, w;
+};
@@ -0,0 +1,42 @@
+// Title         MPxCommand.h
+// Summary       Stand-in for the Maya devkit command proxy
+// Copyright     2020 Artineering and/or its licensors
+// License       MIT
+
+#pragma once
+#include <maya/MString.h>
+#include <maya/MSyntax.h>
+#include <maya/MArgList.h>
+
+class MPxCommand {
+public:
+    MPxCommand() {}
+    virtual ~MPxCommand() {}
+    virtual MStatus doIt(const MArgList& args) = 0;
+    virtual MStatus undoIt() { return MS::kSuccess; }
+    virtual MStatus redoIt() { return MS::kSuccess; }
+    virtual bool isUndoable() const { return false; }
+
+    static void setResult(bool result) { sResult = MString(result ? "1" : "0"); }
+    static void setResult(int result) { sResult = MString(std::to_string(result).c_str()); }
+    static void setResult(unsigned int result) { sResult = MString(std::to_string(result).c_str()); }
+    static void setResult(double result) { sResult = MString(std::to_string(result).c_str()); }
+    static void setResult(const MString& result) { sResult = result; }
+    static void setResult(const char* result) { sResult = MString(result); }
+    static void clearResult() { sResult = MString(); }
+    static void appendToResult(const MString& result) { sResult += (sResult.length() ? " " : ""); sResult += result; }
+    static void appendToResult(int result) { appendToResult(MString(std::to_string(result).c_str())); }
+    static void appendToResult(double result) { appendToResult(MString(std::to_string(result).c_str())); }
+    static void displayInfo(const MString& message) { cout << message << endl; }
+    static void displayWarning(const MString& message) { cout << "Warning: " << message << endl; }
+    static void displayError(const MString& message) { cerr << "Error: " << message << endl; }
+
+    // stand-in only: the syntax is handed over by the harness before doIt()
+    MSyntax syntax() const { return mSyntax; }
+    void standinSetSyntax(const MSyntax& syntax) { mSyntax = syntax; }
+    static const MString& standinResult() { return sResult; }
+
+private:
+    MSyntax mSyntax;
+    static MString sResult;
+};
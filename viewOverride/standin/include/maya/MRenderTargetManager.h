@@ -0,0 +1,112 @@
+// Title         MRenderTargetManager.h
+// Summary       Stand-in for the Maya devkit render target classes
+// Copyright     2020 Artineering and/or its licensors
+// License       MIT
+
+#pragma once
+#include <vector>
+#include <maya/MString.h>
+
+namespace MHWRender {
+
+enum MRasterFormat {
+    kFormatInvalid = 0,
+    kD24S8,
+    kD24X8,
+    kD32_FLOAT,
+    kR24G8,
+    kR24X8,
+    kR32_FLOAT,
+    kR16_FLOAT,
+    kR8_UNORM,
+    kR16G16_FLOAT,
+    kR16G16_SNORM,
+    kR16G16_UNORM,
+    kR32G32_FLOAT,
+    kR8G8B8A8_UNORM,
+    kR10G10B10A2_UNORM,
+    kR16G16B16A16_FLOAT,
+    kR32G32B32A32_FLOAT,
+    kNumberOfRasterFormats
+};
+
+class MRenderTargetDescription {
+public:
+    MRenderTargetDescription()
+        : mWidth(0), mHeight(0), mMultiSampleCount(1), mRasterFormat(kFormatInvalid)
+        , mArraySliceCount(0), mIsCubeMap(false) {}
+    MRenderTargetDescription(const MString& name, unsigned int width, unsigned int height,
+        unsigned int multiSampleCount, MRasterFormat rasterFormat,
+        unsigned int arraySliceCount, bool isCubeMap)
+        : mName(name), mWidth(width), mHeight(height), mMultiSampleCount(multiSampleCount)
+        , mRasterFormat(rasterFormat), mArraySliceCount(arraySliceCount), mIsCubeMap(isCubeMap) {}
+
+    const MString& name() const { return mName; }
+    unsigned int width() const { return mWidth; }
+    unsigned int height() const { return mHeight; }
+    unsigned int multiSampleCount() const { return mMultiSampleCount; }
+    MRasterFormat rasterFormat() const { return mRasterFormat; }
+    unsigned int arraySliceCount() const { return mArraySliceCount; }
+    bool isCubeMap() const { return mIsCubeMap; }
+    bool compatibleWithDescription(const MRenderTargetDescription& desc) const {
+        return mWidth == desc.mWidth && mHeight == desc.mHeight &&
+               mMultiSampleCount == desc.mMultiSampleCount && mRasterFormat == desc.mRasterFormat &&
+               mArraySliceCount == desc.mArraySliceCount && mIsCubeMap == desc.mIsCubeMap;
+    }
+
+    void setName(const MString& name) { mName = name; }
+    void setWidth(unsigned int width) { mWidth = width; }
+    void setHeight(unsigned int height) { mHeight = height; }
+    void setMultiSampleCount(unsigned int count) { mMultiSampleCount = count; }
+    void setRasterFormat(MRasterFormat format) { mRasterFormat = format; }
+    void setArraySliceCount(unsigned int count) { mArraySliceCount = count; }
+    void setIsCubeMap(bool isCubeMap) { mIsCubeMap = isCubeMap; }
+
+private:
+    MString mName;
+    unsigned int mWidth;
+    unsigned int mHeight;
+    unsigned int mMultiSampleCount;
+    MRasterFormat mRasterFormat;
+    unsigned int mArraySliceCount;
+    bool mIsCubeMap;
+};
+
+class MRenderTarget {
+public:
+    MStatus updateDescription(const MRenderTargetDescription& targetDescription);
+    void targetDescription(MRenderTargetDescription& desc) const { desc = mDescription; }
+    void* resourceHandle() const { return (void*)this; }
+    void* rawData(int& rowPitch, size_t& slicePitch);
+    static void freeRawData(void* data);
+
+    // stand-in only: how many times the backing storage was (re)allocated
+    unsigned int standinAllocationCount() const { return mAllocationCount; }
+
+private:
+    friend class MRenderTargetManager;
+    MRenderTarget(const MRenderTargetDescription& desc) : mDescription(desc), mAllocationCount(1) {}
+    ~MRenderTarget() {}
+    MRenderTargetDescription mDescription;
+    unsigned int mAllocationCount;
+};
+
+class MRenderTargetManager {
+public:
+    MRenderTarget* acquireRenderTarget(const MRenderTargetDescription& targetDescription) const;
+    void releaseRenderTarget(MRenderTarget* target) const;
+    bool formatSupportsSRGBWrite(MRasterFormat format) const { return format == kR8G8B8A8_UNORM; }
+
+    // stand-in only: live targets and total (re)allocations since startup
+    unsigned int standinLiveTargets() const { return mLiveTargets; }
+    unsigned long long standinAllocations() const { return mAllocations; }
+
+private:
+    friend class MRenderer;
+    friend class MRenderTarget;
+    MRenderTargetManager() : mLiveTargets(0), mAllocations(0) {}
+    mutable unsigned int mLiveTargets;
+    mutable unsigned long long mAllocations;
+};
+
+}  // namespace MHWRender
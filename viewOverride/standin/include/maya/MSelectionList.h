@@ -0,0 +1,33 @@
+// Title         MSelectionList.h
+// Summary       Stand-in for the Maya devkit selection list
+// Copyright     2020 Artineering and/or its licensors
+// License       MIT
+
+#pragma once
+#include <vector>
+#include <maya/MString.h>
+#include <maya/MDagPath.h>
+
+class MSelectionList {
+public:
+    MStatus add(const MString& matchString, bool searchChildNamespacesToo = false) {
+        mItems.push_back(MDagPath(matchString));
+        return MS::kSuccess;
+    }
+    MStatus add(const MDagPath& path) { mItems.push_back(path); return MS::kSuccess; }
+    MStatus clear() { mItems.clear(); return MS::kSuccess; }
+    unsigned int length(MStatus* status = nullptr) const { if (status) *status = MS::kSuccess; return (unsigned int)mItems.size(); }
+    bool isEmpty(MStatus* status = nullptr) const { if (status) *status = MS::kSuccess; return mItems.empty(); }
+    MStatus getDagPath(unsigned int index, MDagPath& path) const {
+        if (index >= mItems.size()) return MS::kFailure;
+        path = mItems[index];
+        return MS::kSuccess;
+    }
+    MStatus getSelectionStrings(MStringArray& array) const {
+        array.clear();
+        for (const MDagPath& p : mItems) array.append(p.fullPathName());
+        return MS::kSuccess;
+    }
+private:
+    std::vector<MDagPath> mItems;
+};
@@ -0,0 +1,128 @@
+// Title         MShaderManager.h
+// Summary       Stand-in for the Maya devkit shader classes
+// Copyright     2020 Artineering and/or its licensors
+// License       MIT
+
+#pragma once
+#include <map>
+#include <string>
+#include <maya/MString.h>
+#include <maya/MMatrix.h>
+#include <maya/MFloatVector.h>
+#include <maya/MRenderTargetManager.h>
+
+namespace MHWRender {
+
+class MTexture;
+class MSamplerState;
+class MDrawContext;
+class MShaderInstance;
+
+class MRenderItemList {
+public:
+    int length() const { return 0; }
+};
+
+struct MRenderTargetAssignment {
+    MRenderTarget* target;
+};
+
+struct MTextureAssignment {
+    MTexture* texture;
+};
+
+struct MShaderCompileMacro {
+    MString mName;
+    MString mDefinition;
+};
+
+class MShaderInstance {
+public:
+    typedef void (*DrawCallback)(MDrawContext& context, const MRenderItemList& renderItemList, MShaderInstance* shaderInstance);
+
+    enum ParameterType {
+        kInvalid = 0,
+        kBoolean,
+        kInteger,
+        kFloat,
+        kFloat2,
+        kFloat3,
+        kFloat4,
+        kFloat4x4Row,
+        kFloat4x4Col,
+        kTexture1,
+        kTexture2,
+        kTexture3,
+        kTextureCube,
+        kSampler
+    };
+
+    MStatus setParameter(const MString& parameterName, bool value) { return mSet(parameterName, kBoolean); }
+    MStatus setParameter(const MString& parameterName, int value) { return mSet(parameterName, kInteger); }
+    MStatus setParameter(const MString& parameterName, float value) { return mSet(parameterName, kFloat); }
+    MStatus setParameter(const MString& parameterName, const float* value) { return mSet(parameterName, kFloat4); }
+    MStatus setParameter(const MString& parameterName, const MFloatVector& value) { return mSet(parameterName, kFloat3); }
+    MStatus setParameter(const MString& parameterName, const MMatrix& value) { return mSet(parameterName, kFloat4x4Row); }
+    MStatus setParameter(const MString& parameterName, MTextureAssignment& value) { return mSet(parameterName, kTexture2); }
+    MStatus setParameter(const MString& parameterName, MRenderTargetAssignment& value) { return mSet(parameterName, kTexture2); }
+    MStatus setParameter(const MString& parameterName, const MSamplerState& value) { return mSet(parameterName, kSampler); }
+
+    void parameterList(MStringArray& list) const {
+        list.clear();
+        for (const auto& p : mParameters) list.append(MString(p.first.c_str()));
+    }
+    ParameterType parameterType(const MString& parameterName) const {
+        auto it = mParameters.find(parameterName.asChar());
+        return it == mParameters.end() ? kInvalid : it->second;
+    }
+    MStatus techniqueNames(MStringArray& names) const { names.clear(); names.append(mTechnique); return MS::kSuccess; }
+
+    // stand-in only: number of setParameter() calls that reached the instance
+    unsigned long long standinParameterUpdates() const { return mUpdates; }
+    // stand-in only: callbacks around the draws of the items (the real ones are called by Maya)
+    DrawCallback standinPreDrawCallback() const { return mPreCb; }
+    DrawCallback standinPostDrawCallback() const { return mPostCb; }
+
+private:
+    friend class MShaderManager;
+    MShaderInstance(const MString& effect, const MString& technique, DrawCallback preCb = 0, DrawCallback postCb = 0)
+        : mEffect(effect), mTechnique(technique), mUpdates(0), mPreCb(preCb), mPostCb(postCb) {}
+    ~MShaderInstance() {}
+    MStatus mSet(const MString& name, ParameterType type) {
+        mParameters[name.asChar()] = type;
+        mUpdates++;
+        return MS::kSuccess;
+    }
+    MString mEffect;
+    MString mTechnique;
+    std::map<std::string, ParameterType> mParameters;
+    unsigned long long mUpdates;
+    DrawCallback mPreCb;
+    DrawCallback mPostCb;
+};
+
+class MShaderManager {
+public:
+    MShaderInstance* getEffectsFileShader(const MString& effectsFileName, const MString& techniqueName,
+        const MShaderCompileMacro* macros = 0, const unsigned int numberOfMacros = 0,
+        bool useEffectCache = true, MShaderInstance::DrawCallback preCb = 0, MShaderInstance::DrawCallback postCb = 0) const;
+    MShaderInstance* getEffectsBufferShader(const void* buffer, unsigned int size, const MString& techniqueName,
+        const MShaderCompileMacro* macros = 0, const unsigned int numberOfMacros = 0,
+        bool useEffectCache = true) const;
+    void releaseShader(MShaderInstance* shader) const;
+    MStatus removeEffectFromCache(const MString& effectsFileName, const MString& techniqueName,
+        const MShaderCompileMacro* macros = 0, const unsigned int numberOfMacros = 0) const;
+    MStatus shaderPaths(MStringArray& paths) const { paths = mPaths; return MS::kSuccess; }
+    MStatus addShaderPath(const MString& path) const { mPaths.append(path); return MS::kSuccess; }
+
+    // stand-in only: number of effect compilations since startup
+    unsigned long long standinCompilations() const { return mCompilations; }
+
+private:
+    friend class MRenderer;
+    MShaderManager() : mCompilations(0) {}
+    mutable MStringArray mPaths;
+    mutable unsigned long long mCompilations;
+};
+
+}  // namespace MHWRender
@@ -0,0 +1,174 @@
+// Title         MStateManager.h
+// Summary       Stand-in for the Maya devkit state manager
+// Copyright     2020 Artineering and/or its licensors
+// License       MIT
+
+#pragma once
+#include <maya/MStatus.h>
+
+namespace MHWRender {
+
+class MBlendState {
+public:
+    enum BlendOption {
+        kZero = 0,
+        kOne,
+        kSourceColor,
+        kInvSourceColor,
+        kSourceAlpha,
+        kInvSourceAlpha,
+        kDestinationAlpha,
+        kInvDestinationAlpha,
+        kDestinationColor,
+        kInvDestinationColor,
+        kSourceAlphaSat,
+        kBothSourceAlpha,
+        kBothInvSourceAlpha,
+        kBlendFactor,
+        kInvBlendFactor
+    };
+    enum BlendOperation {
+        kAdd = 0,
+        kSubtract,
+        kReverseSubtract,
+        kMin,
+        kMax
+    };
+    enum ChannelMask {
+        kNoChannels = 0,
+        kRedChannel = 1,
+        kGreenChannel = 2,
+        kBlueChannel = 4,
+        kAlphaChannel = 8,
+        kAllChannels = 15
+    };
+};
+
+class MTargetBlendDesc {
+public:
+    MTargetBlendDesc() { setDefaults(); }
+    void setDefaults() {
+        blendEnable = false;
+        sourceBlend = MBlendState::kOne;
+        destinationBlend = MBlendState::kZero;
+        blendOperation = MBlendState::kAdd;
+        alphaSourceBlend = MBlendState::kOne;
+        alphaDestinationBlend = MBlendState::kZero;
+        alphaBlendOperation = MBlendState::kAdd;
+        targetWriteMask = MBlendState::kAllChannels;
+    }
+    bool blendEnable;
+    MBlendState::BlendOption sourceBlend;
+    MBlendState::BlendOption destinationBlend;
+    MBlendState::BlendOperation blendOperation;
+    MBlendState::BlendOption alphaSourceBlend;
+    MBlendState::BlendOption alphaDestinationBlend;
+    MBlendState::BlendOperation alphaBlendOperation;
+    unsigned char targetWriteMask;
+};
+
+class MBlendStateDesc {
+public:
+    enum { kMaxTargets = 8 };
+    MBlendStateDesc() { setDefaults(); }
+    void setDefaults() {
+        alphaToCoverageEnable = false;
+        independentBlendEnable = false;
+        for (int i = 0; i < kMaxTargets; i++) targetBlends[i].setDefaults();
+        for (int i = 0; i < 4; i++) blendFactor[i] = 1.0f;
+        multiSampleMask = 0xffffffff;
+    }
+    bool alphaToCoverageEnable;
+    bool independentBlendEnable;
+    MTargetBlendDesc targetBlends[kMaxTargets];
+    float blendFactor[4];
+    unsigned int multiSampleMask;
+};
+
+class MDepthStencilState {
+public:
+    enum StencilOperation {
+        kKeep = 0,
+        kZero,
+        kReplace,
+        kIncrementClamp,
+        kDecrementClamp,
+        kInvert,
+        kIncrement,
+        kDecrement
+    };
+};
+class MRasterizerState {};
+class MDepthStencilStateDesc;
+
+class MStateManager {
+public:
+    enum CompareMode {
+        kCompareNever = 0,
+        kCompareLess,
+        kCompareEqual,
+        kCompareLessEqual,
+        kCompareGreater,
+        kCompareNotEqual,
+        kCompareGreaterEqual,
+        kCompareAlways
+    };
+    static const MBlendState* acquireBlendState(const MBlendStateDesc& desc) { return new MBlendState(); }
+    MStatus setBlendState(const MBlendState* blendState) { mBlendState = blendState; return MS::kSuccess; }
+    const MBlendState* getBlendState() const { return mBlendState; }
+    static MStatus releaseBlendState(const MBlendState*& blendState) {
+        delete blendState;
+        blendState = nullptr;
+        return MS::kSuccess;
+    }
+    static const MDepthStencilState* acquireDepthStencilState(const MDepthStencilStateDesc& desc) { return new MDepthStencilState(); }
+    static MStatus releaseDepthStencilState(const MDepthStencilState*& depthStencilState) {
+        delete depthStencilState;
+        depthStencilState = nullptr;
+        return MS::kSuccess;
+    }
+private:
+    const MBlendState* mBlendState = nullptr;  ///< bound by the draws (nullptr for the default)
+};
+
+class MStencilOpDesc {
+public:
+    MStencilOpDesc() { setDefaults(); }
+    void setDefaults() {
+        stencilFailOp = MDepthStencilState::kKeep;
+        stencilDepthFailOp = MDepthStencilState::kKeep;
+        stencilPassOp = MDepthStencilState::kKeep;
+        stencilFunc = MStateManager::kCompareAlways;
+    }
+    MDepthStencilState::StencilOperation stencilFailOp;
+    MDepthStencilState::StencilOperation stencilDepthFailOp;
+    MDepthStencilState::StencilOperation stencilPassOp;
+    MStateManager::CompareMode stencilFunc;
+};
+
+class MDepthStencilStateDesc {
+public:
+    MDepthStencilStateDesc() { setDefaults(); }
+    void setDefaults() {
+        depthEnable = true;
+        depthWriteEnable = true;
+        depthFunc = MStateManager::kCompareLess;
+        stencilEnable = false;
+        stencilReadMask = 0xff;
+        stencilWriteMask = 0xff;
+        stencilReferenceVal = 0;
+        frontFace.setDefaults();
+        backFace.setDefaults();
+    }
+    bool depthEnable;
+    bool depthWriteEnable;
+    MStateManager::CompareMode depthFunc;
+    bool stencilEnable;
+    unsigned char stencilReadMask;
+    unsigned char stencilWriteMask;
+    int stencilReferenceVal;
+    MStencilOpDesc frontFace;
+    MStencilOpDesc backFace;
+};
+
+}  // namespace MHWRender
@@ -0,0 +1,40 @@
+// Title         MStatus.h
+// Summary       Stand-in for the Maya devkit status class
+// Copyright     2020 Artineering and/or its licensors
+// License       MIT
+
+#pragma once
+#include <maya/MTypes.h>
+
+class MStatus {
+public:
+    enum MStatusCode {
+        kSuccess = 0,
+        kFailure,
+        kInsufficientMemory,
+        kInvalidParameter,
+        kLicenseFailure,
+        kUnknownParameter,
+        kNotImplemented,
+        kNotFound,
+        kEndOfFile
+    };
+    MStatus() : mCode(kSuccess) {}
+    MStatus(MStatusCode code) : mCode(code) {}
+    bool operator==(const MStatus& other) const { return mCode == other.mCode; }
+    bool operator!=(const MStatus& other) const { return mCode != other.mCode; }
+    bool operator==(MStatusCode code) const { return mCode == code; }
+    bool operator!=(MStatusCode code) const { return mCode != code; }
+    operator bool() const { return mCode == kSuccess; }
+    MStatusCode statusCode() const { return mCode; }
+    bool error() const { return mCode != kSuccess; }
+private:
+    MStatusCode mCode;
+};
+
+typedef MStatus MS;
+
+#define CHECK_MSTATUS_AND_RETURN_IT(_status) \
+    do { MStatus _s = (_status); if (!_s) { return _s; } } while (0)
+#define CHECK_MSTATUS(_status) \
+    do { MStatus _s = (_status); if (!_s) { cerr << __FILE__ << ":" << __LINE__ << " failed" << endl; } } while (0)
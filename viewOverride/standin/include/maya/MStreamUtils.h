@@ -0,0 +1,13 @@
+// Title         MStreamUtils.h
+// Summary       Stand-in for the Maya devkit stream utilities
+// Copyright     2020 Artineering and/or its licensors
+// License       MIT
+
+#pragma once
+#include <maya/MIOStream.h>
+
+class MStreamUtils {
+public:
+    static std::ostream& stdOutStream() { return std::cout; }
+    static std::ostream& stdErrorStream() { return std::cerr; }
+};
@@ -0,0 +1,99 @@
+// Title         MString.h
+// Summary       Stand-in for the Maya devkit string classes
+// Copyright     2020 Artineering and/or its licensors
+// License       MIT
+
+#pragma once
+#include <string>
+#include <vector>
+#include <cstdlib>
+#include <maya/MTypes.h>
+#include <maya/MStatus.h>
+
+class MStringArray;
+
+class MString {
+public:
+    MString() {}
+    MString(const char* str) : mStr(str ? str : "") {}
+    MString(const char* str, int charLength) : mStr(str, charLength) {}
+    MString(const MString& other) = default;
+    MString& operator=(const MString& other) = default;
+
+    const char* asChar() const { return mStr.c_str(); }
+    unsigned int length() const { return (unsigned int)mStr.size(); }
+    unsigned int numChars() const { return (unsigned int)mStr.size(); }
+
+    MString& operator+=(const MString& other) { mStr += other.mStr; return *this; }
+    MString& operator+=(const char* other) { mStr += other; return *this; }
+    MString operator+(const MString& other) const { return MString((mStr + other.mStr).c_str()); }
+    MString operator+(const char* other) const { return MString((mStr + other).c_str()); }
+    bool operator==(const MString& other) const { return mStr == other.mStr; }
+    bool operator==(const char* other) const { return mStr == other; }
+    bool operator!=(const MString& other) const { return mStr != other.mStr; }
+    bool operator!=(const char* other) const { return mStr != other; }
+    bool operator<(const MString& other) const { return mStr < other.mStr; }
+
+    int indexW(const MString& other) const {
+        size_t pos = mStr.find(other.mStr);
+        return pos == std::string::npos ? -1 : (int)pos;
+    }
+    int rindexW(const MString& other) const {
+        size_t pos = mStr.rfind(other.mStr);
+        return pos == std::string::npos ? -1 : (int)pos;
+    }
+    int rindexW(char c) const {
+        size_t pos = mStr.rfind(c);
+        return pos == std::string::npos ? -1 : (int)pos;
+    }
+    /// inclusive [start, end] range as in the devkit
+    MString substringW(int start, int end) const {
+        if (start < 0) start = 0;
+        if (end >= (int)mStr.size()) end = (int)mStr.size() - 1;
+        if (end < start) return MString();
+        return MString(mStr.substr(start, end - start + 1).c_str());
+    }
+    MStatus split(char delimiter, MStringArray& output) const;
+
+    bool isInt() const { char* e = nullptr; std::strtol(mStr.c_str(), &e, 10); return !mStr.empty() && *e == '\0'; }
+    int asInt() const { return std::atoi(mStr.c_str()); }
+    float asFloat() const { return (float)std::atof(mStr.c_str()); }
+    double asDouble() const { return std::atof(mStr.c_str()); }
+    MString& set(double value) { mStr = std::to_string(value); return *this; }
+    MString& operator+=(int value) { mStr += std::to_string(value); return *this; }
+    MString& operator+=(unsigned int value) { mStr += std::to_string(value); return *this; }
+    MString& operator+=(double value) { mStr += std::to_string(value); return *this; }
+
+private:
+    std::string mStr;
+};
+
+inline MString operator+(const char* a, const MString& b) { return MString(a) + b; }
+inline std::ostream& operator<<(std::ostream& os, const MString& s) { return os << s.asChar(); }
+
+class MStringArray {
+public:
+    unsigned int length() const { return (unsigned int)mArray.size(); }
+    MString& operator[](unsigned int i) { return mArray[i]; }
+    const MString& operator[](unsigned int i) const { return mArray[i]; }
+    MStatus append(const MString& s) { mArray.push_back(s); return MS::kSuccess; }
+    MStatus clear() { mArray.clear(); return MS::kSuccess; }
+    MStatus setLength(unsigned int length) { mArray.resize(length); return MS::kSuccess; }
+private:
+    std::vector<MString> mArray;
+};
+
+inline MStatus MString::split(char delimiter, MStringArray& output) const {
+    output.clear();
+    std::string token;
+    for (char c : mStr) {
+        if (c == delimiter) {
+            if (!token.empty()) output.append(MString(token.c_str()));
+            token.clear();
+        } else {
+            token += c;
+        }
+    }
+    if (!token.empty()) output.append(MString(token.c_str()));
+    return MS::kSuccess;
+}
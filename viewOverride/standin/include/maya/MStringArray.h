@@ -0,0 +1,7 @@
+// Title         MStringArray.h
+// Summary       Stand-in for the Maya devkit string array
+// Copyright     2020 Artineering and/or its licensors
+// License       MIT
+
+#pragma once
+#include <maya/MString.h>
@@ -0,0 +1,69 @@
+// Title         MSyntax.h
+// Summary       Stand-in for the Maya devkit command syntax
+// Copyright     2020 Artineering and/or its licensors
+// License       MIT
+
+#pragma once
+#include <string>
+#include <vector>
+#include <maya/MString.h>
+
+class MSyntax {
+public:
+    enum MArgType {
+        kInvalidArgType = 0,
+        kNoArg,
+        kBoolean,
+        kLong,
+        kDouble,
+        kString,
+        kUnsigned,
+        kDistance,
+        kAngle,
+        kTime,
+        kSelectionItem,
+        kLastArgType
+    };
+
+    struct Flag {
+        std::string shortName;
+        std::string longName;
+        std::vector<MArgType> args;
+        bool multiUse;
+    };
+
+    MSyntax() : mQuery(false), mEdit(false) {}
+    MStatus addFlag(const char* shortName, const char* longName,
+        MArgType argType1 = kNoArg, MArgType argType2 = kNoArg, MArgType argType3 = kNoArg,
+        MArgType argType4 = kNoArg, MArgType argType5 = kNoArg, MArgType argType6 = kNoArg) {
+        Flag flag{ shortName, longName, {}, false };
+        MArgType types[6] = { argType1, argType2, argType3, argType4, argType5, argType6 };
+        for (int i = 0; i < 6; i++) {
+            if (types[i] != kNoArg) flag.args.push_back(types[i]);
+        }
+        mFlags.push_back(flag);
+        return MS::kSuccess;
+    }
+    MStatus makeFlagMultiUse(const char* flag) {
+        for (Flag& f : mFlags) {
+            if (f.shortName == flag || f.longName == flag) f.multiUse = true;
+        }
+        return MS::kSuccess;
+    }
+    void enableQuery(bool supportsQuery = true) { mQuery = supportsQuery; }
+    void enableEdit(bool supportsEdit = true) { mEdit = supportsEdit; }
+
+    // stand-in only
+    const Flag* standinFind(const std::string& name) const {
+        for (const Flag& f : mFlags) {
+            if (f.shortName == name || f.longName == name) return &f;
+        }
+        return nullptr;
+    }
+    bool standinQueryEnabled() const { return mQuery; }
+
+private:
+    std::vector<Flag> mFlags;
+    bool mQuery;
+    bool mEdit;
+};
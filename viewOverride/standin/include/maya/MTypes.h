@@ -0,0 +1,30 @@
+// Title         MTypes.h
+// Summary       Stand-in for the Maya devkit basic types
+// Copyright     2020 Artineering and/or its licensors
+// License       MIT
+
+#pragma once
+#include <cstdio>
+#include <cstring>
+#include <cstddef>
+#include <maya/MIOStream.h>
+#include <maya/MFn.h>
+
+#define MAYA_API_VERSION 20200000
+
+typedef unsigned int MCallbackId;
+typedef unsigned int MUint64Placeholder;
+
+class MObject {
+public:
+    MObject() {}
+    bool isNull() const { return mStandinNode < 0; }
+    bool hasFn(MFn::Type type) const { return (mStandinTypes & (1u << type)) != 0; }
+
+    // stand-in only: index of the node in the stand-in scene (see MFnDagNode) and its types
+    MObject(int standinNode, unsigned int standinTypes) : mStandinNode(standinNode), mStandinTypes(standinTypes) {}
+    int standinNode() const { return mStandinNode; }
+private:
+    int mStandinNode = -1;
+    unsigned int mStandinTypes = 0;
+};
@@ -0,0 +1,45 @@
+// Title         MUIDrawManager.h
+// Summary       Stand-in for the Maya devkit UI draw manager
+// Copyright     2020 Artineering and/or its licensors
+// License       MIT
+
+#pragma once
+#include <maya/MString.h>
+#include <maya/MPoint.h>
+#include <maya/MColor.h>
+
+namespace MHWRender {
+
+class MUIDrawManager {
+public:
+    enum FontSize {
+        kDefaultFontSize = 12,
+        kSmallFontSize = 9
+    };
+    enum TextAlignment {
+        kLeft = 0,
+        kCenter,
+        kRight
+    };
+
+    void beginDrawable() { mDrawables++; }
+    void endDrawable() {}
+    void setColor(const MColor& color) {}
+    void setFontSize(const unsigned int fontSize) {}
+    void text(const MPoint& position, const MString& text, TextAlignment alignment = kLeft,
+        const int* backgroundSize = nullptr, const MColor* backgroundColor = nullptr, bool dynamic = false) {
+        mTextCalls++;
+    }
+    void rect2d(const MPoint& center, const MPoint& up, double scaleX, double scaleY, bool filled = false) {}
+    void line2d(const MPoint& startPoint, const MPoint& endPoint) {}
+
+    // stand-in only
+    MUIDrawManager() : mDrawables(0), mTextCalls(0) {}
+    unsigned int standinTextCalls() const { return mTextCalls; }
+
+private:
+    unsigned int mDrawables;
+    unsigned int mTextCalls;
+};
+
+}  // namespace MHWRender
@@ -0,0 +1,16 @@
+// Title         MUiMessage.h
+// Summary       Stand-in for the Maya devkit UI messages
+// Copyright     2020 Artineering and/or its licensors
+// License       MIT
+
+#pragma once
+#include <maya/MMessage.h>
+
+class MUiMessage : public MMessage {
+public:
+    static MCallbackId add3dViewDestroyMsgCallback(const MString& panelName, MMessage::MBasicFunction func,
+        void* clientData = nullptr, MStatus* status = nullptr) {
+        if (status) *status = MS::kSuccess;
+        return standinNextId();
+    }
+};
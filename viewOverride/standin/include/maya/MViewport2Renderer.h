@@ -0,0 +1,223 @@
+// Title         MViewport2Renderer.h
+// Summary       Stand-in for the Maya devkit Viewport 2.0 renderer classes
+// Copyright     2020 Artineering and/or its licensors
+// License       MIT
+
+#pragma once
+#include <vector>
+#include <maya/MString.h>
+#include <maya/MColor.h>
+#include <maya/MMatrix.h>
+#include <maya/MDagPath.h>
+#include <maya/MFloatPoint.h>
+#include <maya/MSelectionList.h>
+#include <maya/MFrameContext.h>
+#include <maya/MUIDrawManager.h>
+#include <maya/MStateManager.h>
+#include <maya/MRenderTargetManager.h>
+
+namespace MHWRender {
+
+class MShaderInstance;
+class MShaderManager;
+
+enum DrawAPI {
+    kNone = 0,
+    kOpenGL = 1 << 0,
+    kDirectX11 = 1 << 1,
+    kOpenGLCoreProfile = 1 << 2,
+    kAllDevices = kOpenGL | kDirectX11 | kOpenGLCoreProfile
+};
+
+class MCameraOverride {
+public:
+    MCameraOverride()
+        : mUseViewMatrix(false), mUseProjectionMatrix(false)
+        , mUseNearClippingPlane(false), mClipNear(0.1)
+        , mUseFarClippingPlane(false), mClipFar(10000.0)
+        , mUseHiddenCameraList(false) {}
+    MDagPath mCameraPath;
+    bool mUseViewMatrix;
+    MMatrix mViewMatrix;
+    bool mUseProjectionMatrix;
+    MMatrix mProjectionMatrix;
+    bool mUseNearClippingPlane;
+    double mClipNear;
+    bool mUseFarClippingPlane;
+    double mClipFar;
+    bool mUseHiddenCameraList;
+};
+
+class MClearOperation {
+public:
+    enum ClearMask {
+        kClearNone = 0,
+        kClearColor = 1 << 0,
+        kClearDepth = 1 << 1,
+        kClearStencil = 1 << 2,
+        kClearAll = ~0
+    };
+    MClearOperation() : mMask(kClearAll), mClearGradient(false) {
+        for (int i = 0; i < 4; i++) { mClearColor[i] = 0.0f; mClearColor2[i] = 0.0f; }
+    }
+    unsigned int mask() const { return mMask; }
+    void setMask(unsigned int mask) { mMask = mask; }
+    void setClearColor(float value[4]) { for (int i = 0; i < 4; i++) mClearColor[i] = value[i]; }
+    void setClearColor2(float value[4]) { for (int i = 0; i < 4; i++) mClearColor2[i] = value[i]; }
+    void setClearGradient(bool value) { mClearGradient = value; }
+    const float* clearColor() const { return mClearColor; }
+    bool clearGradient() const { return mClearGradient; }
+private:
+    unsigned int mMask;
+    float mClearColor[4];
+    float mClearColor2[4];
+    bool mClearGradient;
+};
+
+class MRenderOperation {
+public:
+    enum MRenderOperationType {
+        kClear = 0,
+        kSceneRender,
+        kQuadRender,
+        kUserDefined,
+        kHUDRender,
+        kPresentTarget
+    };
+    MRenderOperation(const MString& name) : mName(name), mOperationType(kUserDefined) {}
+    virtual ~MRenderOperation() {}
+
+    virtual MRenderTarget* const* targetOverrideList(unsigned int& listSize) { listSize = 0; return nullptr; }
+    virtual bool enableSRGBWrite() { return false; }
+    virtual const MFloatPoint* viewportRectangleOverride() { return nullptr; }
+
+    const MString& name() const { return mName; }
+    MRenderOperationType operationType() const { return mOperationType; }
+
+protected:
+    MString mName;
+    MRenderOperationType mOperationType;
+};
+
+class MSceneRender : public MRenderOperation {
+public:
+    enum MSceneFilterOption {
+        kNoSceneFilterOverride = 0,
+        kRenderPreSceneUIItems = 1 << 0,
+        kRenderOpaqueShadedItems = 1 << 1,
+        kRenderTransparentShadedItems = 1 << 2,
+        kRenderShadedItems = kRenderOpaqueShadedItems | kRenderTransparentShadedItems,
+        kRenderPostSceneUIItems = 1 << 3,
+        kRenderUIItems = kRenderPreSceneUIItems | kRenderPostSceneUIItems,
+        kRenderNonShadedItems = 1 << 4,
+        kRenderAllItems = ~0
+    };
+    MSceneRender(const MString& name) : MRenderOperation(name) { mOperationType = kSceneRender; }
+
+    virtual void preRender() {}
+    virtual void postRender() {}
+    virtual MSceneFilterOption renderFilterOverride() { return kNoSceneFilterOverride; }
+    virtual const MSelectionList* objectSetOverride() { return nullptr; }
+    virtual const MCameraOverride* cameraOverride() { return nullptr; }
+    virtual MClearOperation& clearOperation() { return mClearOperation; }
+    virtual const MShaderInstance* shaderOverride() { return nullptr; }
+
+protected:
+    MClearOperation mClearOperation;
+};
+
+class MQuadRender : public MRenderOperation {
+public:
+    MQuadRender(const MString& name) : MRenderOperation(name) { mOperationType = kQuadRender; }
+
+    virtual const MShaderInstance* shader() { return nullptr; }
+    virtual MClearOperation& clearOperation() { return mClearOperation; }
+    virtual const MBlendState* blendStateOverride() { return nullptr; }
+    virtual const MDepthStencilState* depthStencilStateOverride() { return nullptr; }
+    virtual const MRasterizerState* rasterizerStateOverride() { return nullptr; }
+
+protected:
+    MClearOperation mClearOperation;
+};
+
+class MUserRenderOperation : public MRenderOperation {
+public:
+    MUserRenderOperation(const MString& name) : MRenderOperation(name) { mOperationType = kUserDefined; }
+
+    virtual MStatus execute(const MDrawContext& drawContext) = 0;
+    virtual const MCameraOverride* cameraOverride() { return nullptr; }
+    virtual bool hasUIDrawables() const { return false; }
+    virtual void addUIDrawables(MUIDrawManager& drawManager, const MFrameContext& frameContext) {}
+    virtual bool requiresLightData() const { return false; }
+};
+
+class MHUDRender : public MRenderOperation {
+public:
+    MHUDRender() : MRenderOperation("HUD") { mOperationType = kHUDRender; }
+
+    virtual bool hasUIDrawables() const { return false; }
+    virtual void addUIDrawables(MUIDrawManager& drawManager2D, const MFrameContext& frameContext) {}
+};
+
+class MPresentTarget : public MRenderOperation {
+public:
+    MPresentTarget(const MString& name) : MRenderOperation(name) { mOperationType = kPresentTarget; }
+};
+
+class MRenderOverride {
+public:
+    MRenderOverride(const MString& name) : mName(name) {}
+    virtual ~MRenderOverride() {}
+
+    virtual DrawAPI supportedDrawAPIs() const { return kOpenGL; }
+    virtual MStatus setup(const MString& destination) { return MS::kSuccess; }
+    virtual MStatus cleanup() { return MS::kSuccess; }
+    virtual bool startOperationIterator() = 0;
+    virtual MRenderOperation* renderOperation() = 0;
+    virtual bool nextRenderOperation() = 0;
+    virtual MString uiName() const { return MString(); }
+
+    const MString& name() const { return mName; }
+    const MFrameContext* getFrameContext() const;
+
+private:
+    MString mName;
+};
+
+class MRenderer {
+public:
+    static MRenderer* theRenderer(bool initializeRenderer = true);
+
+    const MShaderManager* getShaderManager() const;
+    const MRenderTargetManager* getRenderTargetManager() const { return &mTargetManager; }
+
+    MStatus registerOverride(const MRenderOverride* override);
+    MStatus deregisterOverride(const MRenderOverride* override);
+    const MRenderOverride* findRenderOverride(const MString& name);
+
+    DrawAPI drawAPI() const { return mDrawAPI; }
+    bool drawAPIIsOpenGL() const { return mDrawAPI != kDirectX11; }
+    void* GPUDeviceHandle() const { return nullptr; }
+    MStatus outputTargetSize(int& width, int& height) const {
+        int x, y;
+        return mDrawContext.getViewportDimensions(x, y, width, height);
+    }
+
+    // stand-in only: the single frame/draw context shared by every override
+    MDrawContext& standinDrawContext() { return mDrawContext; }
+    void standinSetDrawAPI(DrawAPI api) { mDrawAPI = api; }
+
+private:
+    MRenderer();
+    ~MRenderer();
+    MRenderTargetManager mTargetManager;
+    MShaderManager* mShaderManager;
+    MDrawContext mDrawContext;
+    std::vector<const MRenderOverride*> mOverrides;
+    DrawAPI mDrawAPI;
+};
+
+}  // namespace MHWRender
+
+// the devkit makes the render classes reachable without the namespace
+using namespace MHWRender;
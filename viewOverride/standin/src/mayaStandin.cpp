@@ -0,0 +1,181 @@
+// Title         mayaStandin.cpp
+// Summary       Definitions for the stand-in Maya devkit
+// Copyright     2020 Artineering and/or its licensors
+// License       MIT
+
+#include <set>
+#include <string>
+#include <cstdlib>
+#include <maya/MGlobal.h>
+#include <maya/MPxCommand.h>
+#include <maya/MShaderManager.h>
+#include <maya/MViewport2Renderer.h>
+
+/////////////////////////////////////////////////////////////////////
+/// Stand-in Maya devkit
+///
+/// Minimal host-side implementation of the devkit classes used by
+/// the viewOverride plugin. Nothing is drawn, but every call that
+/// would allocate or compile on the GPU is counted so per-frame CPU
+/// overhead and reallocation paths can be measured without Maya.
+///
+/////////////////////////////////////////////////////////////////////
+
+const MMatrix MMatrix::identity = MMatrix();
+MString MPxCommand::sResult;
+
+MString MGlobal::executeCommandStringResult(const MString& command, bool, bool, MStatus* status) {
+    if (status) *status = MS::kSuccess;
+    if (command.indexW("pluginInfo") >= 0) {
+        return MString("./plug-ins/viewOverride.so");
+    }
+    if (command.indexW("vp2RenderingEngine") >= 0) {
+        return MString("OpenGLCoreProfileCompat");
+    }
+    return MString();
+}
+
+MStatus MGlobal::executeCommand(const MString&, bool, bool) {
+    return MS::kSuccess;
+}
+
+namespace MHWRender {
+
+// RENDER TARGETS
+static size_t standinBytesPerPixel(MRasterFormat format) {
+    switch (format) {
+    case kR8_UNORM: return 1;
+    case kR16_FLOAT: return 2;
+    case kD24S8: case kD24X8: case kD32_FLOAT: case kR24G8: case kR24X8:
+    case kR32_FLOAT: case kR16G16_FLOAT: case kR16G16_SNORM: case kR16G16_UNORM:
+    case kR8G8B8A8_UNORM: case kR10G10B10A2_UNORM: return 4;
+    case kR32G32_FLOAT: case kR16G16B16A16_FLOAT: return 8;
+    case kR32G32B32A32_FLOAT: return 16;
+    default: return 4;
+    }
+}
+
+MStatus MRenderTarget::updateDescription(const MRenderTargetDescription& targetDescription) {
+    if (!mDescription.compatibleWithDescription(targetDescription)) {
+        mAllocationCount++;
+        MRenderer::theRenderer()->getRenderTargetManager()->mAllocations++;
+    }
+    mDescription = targetDescription;
+    return MS::kSuccess;
+}
+
+void* MRenderTarget::rawData(int& rowPitch, size_t& slicePitch) {
+    rowPitch = (int)(mDescription.width() * standinBytesPerPixel(mDescription.rasterFormat()));
+    slicePitch = (size_t)rowPitch * mDescription.height();
+    return std::calloc(slicePitch ? slicePitch : 1, 1);
+}
+
+void MRenderTarget::freeRawData(void* data) {
+    std::free(data);
+}
+
+MRenderTarget* MRenderTargetManager::acquireRenderTarget(const MRenderTargetDescription& targetDescription) const {
+    mLiveTargets++;
+    mAllocations++;
+    return new MRenderTarget(targetDescription);
+}
+
+void MRenderTargetManager::releaseRenderTarget(MRenderTarget* target) const {
+    if (target) {
+        mLiveTargets--;
+        delete target;
+    }
+}
+
+// SHADERS
+static std::set<std::string>& standinEffectCache() {
+    static std::set<std::string> cache;
+    return cache;
+}
+
+static std::string standinEffectKey(const MString& effect, const MString& technique,
+    const MShaderCompileMacro* macros, unsigned int numberOfMacros) {
+    std::string key = std::string(effect.asChar()) + "|" + technique.asChar();
+    for (unsigned int i = 0; i < numberOfMacros; i++) {
+        key += std::string("|") + macros[i].mName.asChar() + "=" + macros[i].mDefinition.asChar();
+    }
+    return key;
+}
+
+MShaderInstance* MShaderManager::getEffectsFileShader(const MString& effectsFileName, const MString& techniqueName,
+    const MShaderCompileMacro* macros, const unsigned int numberOfMacros, bool useEffectCache,
+    MShaderInstance::DrawCallback preCb, MShaderInstance::DrawCallback postCb) const {
+    std::string key = standinEffectKey(effectsFileName, techniqueName, macros, numberOfMacros);
+    if (!useEffectCache || standinEffectCache().insert(key).second) {
+        mCompilations++;
+    }
+    return new MShaderInstance(effectsFileName, techniqueName, preCb, postCb);
+}
+
+MShaderInstance* MShaderManager::getEffectsBufferShader(const void* buffer, unsigned int size, const MString& techniqueName,
+    const MShaderCompileMacro* macros, const unsigned int numberOfMacros, bool useEffectCache) const {
+    if (!buffer || size == 0) {
+        return nullptr;
+    }
+    mCompilations++;
+    return new MShaderInstance(MString("<buffer>"), techniqueName);
+}
+
+void MShaderManager::releaseShader(MShaderInstance* shader) const {
+    delete shader;
+}
+
+MStatus MShaderManager::removeEffectFromCache(const MString& effectsFileName, const MString& techniqueName,
+    const MShaderCompileMacro* macros, const unsigned int numberOfMacros) const {
+    standinEffectCache().erase(standinEffectKey(effectsFileName, techniqueName, macros, numberOfMacros));
+    return MS::kSuccess;
+}
+
+// RENDERER
+MRenderer::MRenderer() : mShaderManager(new MShaderManager()), mDrawAPI(kOpenGLCoreProfile) {}
+
+MRenderer::~MRenderer() {
+    delete mShaderManager;
+}
+
+MRenderer* MRenderer::theRenderer(bool initializeRenderer) {
+    static MRenderer renderer;
+    return &renderer;
+}
+
+const MShaderManager* MRenderer::getShaderManager() const {
+    return mShaderManager;
+}
+
+MStatus MRenderer::registerOverride(const MRenderOverride* override) {
+    if (!override || findRenderOverride(override->name())) {
+        return MS::kFailure;
+    }
+    mOverrides.push_back(override);
+    return MS::kSuccess;
+}
+
+MStatus MRenderer::deregisterOverride(const MRenderOverride* override) {
+    for (size_t i = 0; i < mOverrides.size(); i++) {
+        if (mOverrides[i] == override) {
+            mOverrides.erase(mOverrides.begin() + i);
+            return MS::kSuccess;
+        }
+    }
+    return MS::kFailure;
+}
+
+const MRenderOverride* MRenderer::findRenderOverride(const MString& name) {
+    for (const MRenderOverride* o : mOverrides) {
+        if (o->name() == name) {
+            return o;
+        }
+    }
+    return nullptr;
+}
+
+const MFrameContext* MRenderOverride::getFrameContext() const {
+    return &MRenderer::theRenderer()->standinDrawContext();
+}
+
+}  // namespace MHWRender
@@ -0,0 +1,153 @@
+// Title         viewOverrideBenchmark.cpp
+// Summary       viewOverride per-frame CPU microbenchmarks against the stand-in devkit
+// Copyright     2020 Artineering and/or its licensors
+// License       MIT
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include "viewOverride.h"
+#include "viewOverrideImageDiff.h"
+
+/////////////////////////////////////////////////////////////////////
+/// Microbenchmarks of the per-frame CPU overhead of the override
+///
+/// viewOverrideBenchmark [--quick]
+///
+/// 1. setup() of an unchanged panel
+/// 2. setup() while resizing within the size bucket of the targets
+/// 3. setup() while growing new panels across size buckets
+/// 4. setup() alternating between two panels
+/// 5. Operation iterator
+/// 6. setup() of an unchanged panel with the frame cache
+/// 7. Golden image comparison of a 4K RGBA image per kernel
+///
+/// Nothing is drawn by the stand-in devkit, so these only measure
+/// the CPU side of the override and the allocations it requests.
+///
+/////////////////////////////////////////////////////////////////////
+
+typedef std::chrono::steady_clock Clock;
+
+static void setViewport(int width, int height) {
+    MHWRender::MRenderer::theRenderer()->standinDrawContext().standinSetViewportDimensions(0, 0, width, height);
+}
+
+static unsigned long long allocations() {
+    return MHWRender::MRenderer::theRenderer()->getRenderTargetManager()->standinAllocations();
+}
+
+static void report(const char *name, Clock::time_point start, unsigned int frames, unsigned long long allocated) {
+    double ns = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+    printf("%-32s %10.1f ns/frame %8.3f allocations/frame\n", name, ns / frames, (double)allocated / frames);
+}
+
+static void iterate(viewOverride *override) {
+    if (override->startOperationIterator()) {
+        do {
+            override->renderOperation();
+        } while (override->nextRenderOperation());
+    }
+}
+
+int main(int argc, char **argv) {
+    bool quick = (argc > 1) && (strcmp(argv[1], "--quick") == 0);
+    const unsigned int frames = quick ? 500 : 20000;
+
+    viewOverride *override = new viewOverride("viewOverride");
+    MHWRender::MRenderer::theRenderer()->registerOverride(override);
+    setViewport(1920, 1080);
+    override->setup("modelPanel4");  // warm up (builds the graph and targets)
+    override->cleanup();
+
+    // 1. unchanged panel
+    unsigned long long allocated = allocations();
+    Clock::time_point start = Clock::now();
+    for (unsigned int i = 0; i < frames; i++) {
+        override->setup("modelPanel4");
+        override->cleanup();
+    }
+    report("setup (steady)", start, frames, allocations() - allocated);
+
+    // 2. resize within the size bucket (e.g., dragging a splitter slowly)
+    allocated = allocations();
+    start = Clock::now();
+    for (unsigned int i = 0; i < frames; i++) {
+        setViewport(1800 + (i % 64), 1000 + (i % 64));
+        override->setup("modelPanel4");
+        override->cleanup();
+    }
+    report("setup (resize within bucket)", start, frames, allocations() - allocated);
+
+    // 3. grow across size buckets (a new panel every 10 frames, as held targets don't shrink right away)
+    allocated = allocations();
+    start = Clock::now();
+    for (unsigned int i = 0; i < frames; i++) {
+        setViewport(640 + 128 * (i % 10), 360 + 64 * (i % 10));
+        override->setup("benchmarkPanel" + MString(std::to_string(i / 10).c_str()));
+        override->cleanup();
+    }
+    report("setup (grow across buckets)", start, frames, allocations() - allocated);
+
+    // 4. two panels with their own targets
+    setViewport(1920, 1080);
+    allocated = allocations();
+    start = Clock::now();
+    for (unsigned int i = 0; i < frames; i++) {
+        override->setup((i % 2) ? "modelPanel1" : "modelPanel4");
+        override->cleanup();
+    }
+    report("setup (two panels)", start, frames, allocations() - allocated);
+
+    // 5. operation iterator
+    override->setup("modelPanel4");
+    start = Clock::now();
+    for (unsigned int i = 0; i < frames; i++) {
+        iterate(override);
+    }
+    report("operation iterator", start, frames, 0);
+    override->cleanup();
+
+    // 6. unchanged panel reusing its image (e.g., a background viewport)
+    override->enableFrameCache(true);
+    override->setup("modelPanel4");
+    override->cleanup();
+    allocated = allocations();
+    start = Clock::now();
+    for (unsigned int i = 0; i < frames; i++) {
+        override->setup("modelPanel4");
+        override->cleanup();
+    }
+    report("setup (frame cache)", start, frames, allocations() - allocated);
+    override->enableFrameCache(false);
+
+    // 7. golden image comparison (e.g., of captures in CI)
+    DiffImage golden, test;
+    golden.width = test.width = 3840;
+    golden.height = test.height = 2160;
+    golden.channels = test.channels = { "A", "B", "G", "R" };
+    golden.pixels.assign(4 * golden.width * golden.height, 0.5f);
+    test.pixels = golden.pixels;
+    for (size_t i = 0; i < test.pixels.size(); i += 97) {
+        test.pixels[i] += 0.01f;
+    }
+    std::vector<float> heat;
+    const unsigned int images = quick ? 1 : 20;
+    for (int kernel = ImageDiff::kScalar; kernel < ImageDiff::kKernelCount; kernel++) {
+        if (!ImageDiff::supported((ImageDiff::Kernel)kernel)) {
+            continue;
+        }
+        start = Clock::now();
+        for (unsigned int i = 0; i < images; i++) {
+            ImageDiff::compare(golden, test, DiffTolerance(), &heat, (ImageDiff::Kernel)kernel);
+        }
+        double ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count() / images;
+        printf("%-32s %10.2f ms/image  %8.1f Mpixels/s\n", (std::string("image diff 4K (") + ImageDiff::kernelName((ImageDiff::Kernel)kernel) + ")").c_str(),
+            ms, golden.width * golden.height / (ms * 1000.0));
+    }
+
+    MHWRender::MRenderer::theRenderer()->deregisterOverride(override);
+    delete override;
+    return 0;
+}
@@ -0,0 +1,1061 @@
+// Title         viewOverrideTests.cpp
+// Summary       viewOverride tests against the stand-in devkit
+// Copyright     2020 Artineering and/or its licensors
+// License       MIT
+
+#include <string>
+#include <chrono>
+#include <thread>
+#include <fstream>
+#include <iterator>
+#include <cmath>
+#include <cstdio>
+#include <limits>
+#include <vector>
+#include <iostream>
+#include <algorithm>
+#include <maya/MShaderManager.h>
+#include <maya/MEventMessage.h>
+#include <maya/MFnDagNode.h>
+#include "viewOverride.h"
+#include "viewOverrideImageDiff.h"
+#include "viewOverrideOperations.h"
+
+/////////////////////////////////////////////////////////////////////
+/// Tests of the override logic that doesn't need a GPU, i.e., graph
+/// culling and aliasing, render target pooling and statistics.
+/// Run through ctest in the stand-in build (see CMakeLists.txt).
+///
+/////////////////////////////////////////////////////////////////////
+
+static int sFailures = 0;
+
+#define CHECK(condition) \
+    if (!(condition)) { \
+        std::cerr << __FILE__ << ":" << __LINE__ << ": CHECK(" #condition ") failed" << std::endl; \
+        sFailures++; \
+    }
+
+// draws a frame of the destination and returns the names of the operations
+static std::vector<std::string> drawFrame(viewOverride *override, const MString &destination) {
+    std::vector<std::string> names;
+    override->setup(destination);
+    if (override->startOperationIterator()) {
+        do {
+            MHWRender::MRenderOperation *operation = override->renderOperation();
+            names.push_back(operation->name().asChar());
+            if (operation->operationType() == MHWRender::MRenderOperation::kQuadRender) {
+                ((MHWRender::MQuadRender*)operation)->shader();  // as Viewport 2.0 does when drawing
+            }
+        } while (override->nextRenderOperation());
+    }
+    override->cleanup();
+    return names;
+}
+
+static bool contains(const std::vector<std::string> &names, const std::string &name) {
+    return std::find(names.begin(), names.end(), name) != names.end();
+}
+
+static void setViewport(int width, int height) {
+    MHWRender::MRenderer::theRenderer()->standinDrawContext().standinSetViewportDimensions(0, 0, width, height);
+}
+
+
+void testGraphCulling(viewOverride *override) {
+    setViewport(960, 540);
+    std::vector<std::string> names = drawFrame(override, "modelPanel4");
+    CHECK(names.size() == 5);
+    CHECK(names.front() == "viewOverride_Scene");
+    CHECK(names[1] == "viewOverride_Scene_Transparent");  // transparent items to color and depth only
+    override->setup("modelPanel4");
+    if (override->startOperationIterator()) {
+        do {
+            MHWRender::MRenderOperation *operation = override->renderOperation();
+            unsigned int targetCount = 0;
+            if (operation->name() == "viewOverride_Scene") {
+                ((SceneRender*)operation)->targetOverrideList(targetCount);
+                CHECK(targetCount == 3);
+            } else if (operation->name() == "viewOverride_Scene_Transparent") {
+                ((SceneRender*)operation)->targetOverrideList(targetCount);
+                CHECK(targetCount == 2);
+            }
+        } while (override->nextRenderOperation());
+    }
+    override->cleanup();
+    CHECK(names.back() == "viewOverride_Present");
+    CHECK(!contains(names, "viewOverride_Quad"));  // nothing to debug while showing the color target
+
+    override->changeActiveTarget(viewOverride::kNormals);
+    names = drawFrame(override, "modelPanel4");
+    CHECK(contains(names, "viewOverride_Quad"));
+    override->changeActiveTarget(viewOverride::kColor);
+
+    override->enableOIT(true);
+    names = drawFrame(override, "modelPanel4");
+    CHECK(contains(names, "viewOverride_OIT_Scene"));
+    CHECK(contains(names, "viewOverride_OIT_Composite"));
+    CHECK(!contains(names, "viewOverride_Scene_Transparent"));  // OIT draws the transparent items instead
+    // the transparent items are drawn by the accumulation override, blended around its draws
+    SceneRender *oitOp = nullptr;
+    if (override->startOperationIterator()) {
+        do {
+            if (override->renderOperation()->name() == "viewOverride_OIT_Scene") {
+                oitOp = (SceneRender*)override->renderOperation();
+            }
+        } while (override->nextRenderOperation());
+    }
+    CHECK(oitOp && oitOp->shaderFileName() == "oitAccumulate" && oitOp->blendState());
+    if (oitOp) {
+        MHWRender::MShaderInstance *accumulate = const_cast<MHWRender::MShaderInstance*>(oitOp->shaderOverride());
+        CHECK(accumulate && accumulate->standinPreDrawCallback() && accumulate->standinPostDrawCallback());
+        if (accumulate && accumulate->standinPreDrawCallback()) {
+            MHWRender::MDrawContext &context = MHWRender::MRenderer::theRenderer()->standinDrawContext();
+            accumulate->standinPreDrawCallback()(context, MHWRender::MRenderItemList(), accumulate);
+            CHECK(context.getStateManager()->getBlendState() == oitOp->blendState());
+            accumulate->standinPostDrawCallback()(context, MHWRender::MRenderItemList(), accumulate);
+            CHECK(context.getStateManager()->getBlendState() == nullptr);
+        }
+    }
+    override->enableOIT(false);
+    names = drawFrame(override, "modelPanel4");
+    CHECK(!contains(names, "viewOverride_OIT_Scene"));
+    // a single scene render draws all items (and reproduces the sorting bug with more than two targets)
+    override->enableSplitTransparency(false);
+    names = drawFrame(override, "modelPanel4");
+    CHECK(names.size() == 4 && !contains(names, "viewOverride_Scene_Transparent"));
+    override->enableSplitTransparency(true);
+
+    // a single quad replaces the debug quad and the UI in the tiled view
+    override->changeActiveTarget(viewOverride::kNormals);
+    override->showTiles(true);
+    names = drawFrame(override, "modelPanel4");
+    CHECK(contains(names, "viewOverride_Tiles"));
+    CHECK(!contains(names, "viewOverride_Quad"));
+    CHECK(!contains(names, "viewOverride_Scene_UI"));
+    CHECK(names.back() == "viewOverride_Present");
+    override->showTiles(false);
+    override->changeActiveTarget(viewOverride::kColor);
+    names = drawFrame(override, "modelPanel4");
+    CHECK(!contains(names, "viewOverride_Tiles"));
+}
+
+
+void testTargetAliasing() {
+    RenderGraph graph;
+    MHWRender::MRenderTargetDescription description("target", 1, 1, 0, MHWRender::kR16G16B16A16_FLOAT, 1, false);
+    int color = graph.addTarget(description);
+    int first = graph.addTarget(description, 1, true);
+    int second = graph.addTarget(description, 1, true);
+    graph.addPass(new QuadRender("first", "quadDebug", "debug"), { first }, {});
+    graph.addPass(new QuadRender("firstRead", "quadDebug", "debug"), { color }, { first });
+    graph.addPass(new QuadRender("second", "quadDebug", "debug"), { second }, { color });
+    graph.addPass(new QuadRender("secondRead", "quadDebug", "debug"), { color }, { second });
+    graph.addPass(new PresentTarget("present"), { color }, { color }, true);
+    graph.compile();
+    CHECK(graph.compiledPasses().size() == 5);
+    CHECK(graph.alias(color) == color);       // persistent
+    CHECK(graph.alias(second) == first);      // lifetimes don't overlap
+}
+
+
+void testTargetPool(viewOverride *override) {
+    const MHWRender::MRenderTargetManager *targetManager = MHWRender::MRenderer::theRenderer()->getRenderTargetManager();
+    setViewport(1000, 700);
+    drawFrame(override, "modelPanel1");
+    unsigned long long allocations = targetManager->standinAllocations();
+    // resizing within the size bucket doesn't reallocate
+    setViewport(1010, 710);
+    drawFrame(override, "modelPanel1");
+    CHECK(targetManager->standinAllocations() == allocations);
+    // outgrowing it does
+    setViewport(1300, 710);
+    drawFrame(override, "modelPanel1");
+    CHECK(targetManager->standinAllocations() > allocations);
+    CHECK(override->targetPool().misses() > 0);
+    CHECK(override->targetPool().hits() > 0);
+}
+
+
+void testGBufferLayout(viewOverride *override) {
+    setViewport(1024, 768);
+    override->changeActiveTarget(viewOverride::kNormals);
+    drawFrame(override, "modelPanel4");
+    unsigned long long fullBytes = override->naiveBytes();
+    override->setGBufferLayout(viewOverride::kNormalsOctahedral);
+    drawFrame(override, "modelPanel4");
+    CHECK(override->naiveBytes() == fullBytes - 1024 * 768 * 12);  // 16 -> 4 bytes per pixel
+    override->setGBufferLayout(viewOverride::kNormalsFull);
+    override->changeActiveTarget(viewOverride::kColor);
+    drawFrame(override, "modelPanel4");
+}
+
+
+void testSceneLayouts(viewOverride *override) {
+    setViewport(1024, 768);
+    drawFrame(override, "modelPanel4");
+    unsigned long long normalsBytes = override->naiveBytes();
+    override->setSceneLayout(viewOverride::kSceneColorDepth);
+    drawFrame(override, "modelPanel4");
+    CHECK(override->naiveBytes() == normalsBytes - 1024 * 768 * 16);  // without the RGBA32F normals
+    override->setSceneLayout(viewOverride::kSceneAOVs);
+    drawFrame(override, "modelPanel4");
+    CHECK(override->naiveBytes() == normalsBytes + 2 * 1024 * 768 * 8);  // two RGBA16F AOVs
+    override->setSceneLayout(viewOverride::kSceneNormals);
+    drawFrame(override, "modelPanel4");
+    CHECK(override->naiveBytes() == normalsBytes);
+
+    // the stand-in has no GPU timestamps, so a comparison stops right away
+    override->compareSceneLayouts(viewOverride::kSceneColorDepth, viewOverride::kSceneAOVs, 100);
+    CHECK(override->comparingSceneLayouts());
+    drawFrame(override, "modelPanel4");
+    CHECK(!override->comparingSceneLayouts());
+    CHECK(!override->gpuProfilerEnabled());  // restored
+    CHECK(override->sceneLayout() == viewOverride::kSceneNormals);
+}
+
+
+void testABTest() {
+    ABTest test;
+    test.start(4);
+    int sides[4];
+    for (unsigned int i = 0; i < 4; i++) {
+        sides[i] = test.nextSide();
+    }
+    CHECK(sides[0] == 0 && sides[1] == 1 && sides[2] == 0 && sides[3] == 1);
+    CHECK(test.running());  // results still in flight
+    for (unsigned int i = 0; i < GPUProfiler::kLatency; i++) {
+        CHECK(test.nextSide() == -1);
+    }
+    CHECK(!test.running());
+    test.record(0, 1.0, 2.0);
+    test.record(0, 3.0, 4.0);
+    test.record(1, 4.0, 6.0);
+    test.record(-1, 100.0, 100.0);  // frame outside of the comparison
+    ABSummary summary = test.summary();
+    CHECK(summary.frames[0] == 2 && summary.frames[1] == 1);
+    CHECK(summary.sceneTime[0] == 2.0 && summary.sceneTime[1] == 4.0);
+    CHECK(summary.frameTime[0] == 3.0 && summary.frameTime[1] == 6.0);
+}
+
+
+void testAblationBenchmark() {
+    std::vector<AblationConfig> configs(2);
+    configs[0].name = "baseline";
+    configs[1].name = "disable pass";
+    configs[1].disabledPass = 3;
+    AblationBenchmark benchmark;
+    benchmark.start(configs, 2);
+    std::vector<int> issued;
+    for (unsigned int i = 0; i < 2 * (AblationBenchmark::kWarmupFrames + 2); i++) {
+        issued.push_back(benchmark.nextConfig());
+        benchmark.recordCPU(issued.back(), issued.back() ? 3.0f : 1.0f);
+    }
+    CHECK(issued.front() == 0 && issued.back() == 1 && benchmark.currentConfig() == 1);
+    CHECK(benchmark.running());  // results still in flight
+    for (unsigned int i = 0; i < GPUProfiler::kLatency; i++) {
+        CHECK(benchmark.nextConfig() == -1);
+    }
+    CHECK(!benchmark.running());
+    // warmup frames aren't measured
+    benchmark.recordGPU(1, 100.0, { "pass" }, { 100.0 });
+    benchmark.recordGPU(1, 100.0, { "pass" }, { 100.0 });
+    benchmark.recordGPU(1, 2.0, { "pass", "other" }, { 1.5, 0.5 });
+    benchmark.recordGPU(-1, 100.0, {}, {});  // frame outside of the benchmark
+    const std::vector<AblationResult> &results = benchmark.results();
+    CHECK(results.size() == 2 && results[1].config.disabledPass == 3);
+    CHECK(results[0].cpu.summary().count == 2 && results[0].cpu.summary().mean == 1.0f);
+    CHECK(results[1].cpu.summary().mean == 3.0f);
+    CHECK(results[0].gpuFrames == 0 && results[1].gpuFrames == 1 && results[1].gpuFrameSum == 2.0);
+    CHECK(results[1].passNames.size() == 2 && results[1].passSums[0] == 1.5);
+    const char *path = "ablationBenchmarkTest.json";
+    CHECK(benchmark.writeReport(path));
+    std::ifstream file(path);
+    std::string report((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    file.close();
+    CHECK(report.find("\"name\": \"disable pass\"") != std::string::npos);
+    CHECK(report.find("\"deltaMeanMs\": 2") != std::string::npos);
+    CHECK(report.find("\"gpuMeanMs\": null") != std::string::npos);  // baseline without GPU timings
+    CHECK(report.find("\"other\": 0.5") != std::string::npos);
+    std::remove(path);
+}
+
+
+// timestamps resolve once the frame they were issued in is over, each slot times its passes at 1 ms per slot ring
+class MockTimerBackend : public GPUTimerBackend {
+public:
+    unsigned int frame = 0;
+    std::vector<unsigned int> ended = std::vector<unsigned int>(GPUProfiler::kLatency * GPUProfiler::kMaxPanels, 0);
+    void beginFrame(unsigned int) override {}
+    void timestamp(unsigned int, unsigned int) override {}
+    void endFrame(unsigned int slot) override { ended[slot] = frame; }
+    bool resolve(unsigned int slot, unsigned int count, std::vector<double> &milliseconds) override {
+        if (ended[slot] >= frame) {
+            return false;
+        }
+        milliseconds.assign(count - 1, 1.0 + slot / GPUProfiler::kLatency);
+        return true;
+    }
+    void abandon() override {}
+};
+
+
+void testGPUProfiler() {
+    // panels drawn one after the other in every frame keep their own slots and pass times
+    GPUProfiler profiler;
+    MockTimerBackend *backend = new MockTimerBackend();
+    profiler.setBackend(backend);
+    profiler.setEnabled(true);
+    const char *panels[GPUProfiler::kMaxPanels] = { "modelPanel1", "modelPanel2", "modelPanel3", "modelPanel4" };
+    std::vector<int> passes = { 0, 1, 2 };
+    for (unsigned int frame = 1; frame <= 3 * GPUProfiler::kLatency; frame++) {
+        backend->frame = frame;
+        for (unsigned int p = 0; p < GPUProfiler::kMaxPanels; p++) {
+            CHECK(profiler.beginFrame(panels[p], passes));
+            for (unsigned int i = 0; i < profiler.timedPasses(); i++) {
+                profiler.timestamp(i);
+            }
+            if (frame > GPUProfiler::kLatency) {
+                CHECK(profiler.passTime(1) == 1.0 + p && profiler.resolvedFrameTime() == 2.0 * (1.0 + p));
+            }
+        }
+    }
+    CHECK(profiler.droppedFrames() == 0);
+    // graphs over the cap only time their first passes
+    passes.resize(GPUProfiler::kMaxTimestamps + 5);
+    CHECK(profiler.beginFrame(panels[0], passes) && profiler.timedPasses() == GPUProfiler::kMaxTimestamps);
+}
+
+
+void testQuadParameters() {
+    QuadRender quadOp("parameters", "quadDebug", "debug");
+    int channels = quadOp.addParameter("gColorChannels", QuadParameter::kFloat4);
+    int encoding = quadOp.addParameter("gNormalEncoding", QuadParameter::kInt);
+    const MHWRender::MShaderInstance *shader = quadOp.shader();
+    CHECK(shader->standinParameterUpdates() == 2);  // all parameters reach a new instance
+    float values[4] = { 1.0f, 1.0f, 1.0f, 0.0f };
+    quadOp.setParameter(channels, values);
+    quadOp.setParameter(channels, values);
+    quadOp.setParameter(encoding, 0);
+    quadOp.shader();
+    CHECK(shader->standinParameterUpdates() == 3);  // only the changed value
+    quadOp.shader();
+    CHECK(shader->standinParameterUpdates() == 3);  // nothing changed
+    quadOp.setParameter(encoding, 1);
+    quadOp.shader();
+    CHECK(shader->standinParameterUpdates() == 4);
+}
+
+
+void testShaderPermutations(viewOverride *override) {
+    const MHWRender::MShaderManager *shaderMgr = MHWRender::MRenderer::theRenderer()->getShaderManager();
+    QuadRender quadOp("permutations", "quadDebug", "debug");
+    int alpha = quadOp.addPermutation({ { "ALPHA_ONLY", "1" } });
+    unsigned long long compilations = shaderMgr->standinCompilations();
+    const MHWRender::MShaderInstance *shader = quadOp.shader();
+    CHECK(shaderMgr->standinCompilations() == compilations + 2);  // all permutations up front
+    quadOp.setPermutation(alpha);
+    CHECK(quadOp.shader() != shader);
+    quadOp.setPermutation(0);
+    CHECK(quadOp.shader() == shader);
+    CHECK(shaderMgr->standinCompilations() == compilations + 2);
+
+    // switching between the debug modes never compiles
+    override->changeActiveTarget(viewOverride::kDepth);
+    drawFrame(override, "modelPanel4");
+    compilations = shaderMgr->standinCompilations();
+    for (unsigned int target = 0; target < viewOverride::kTargetCount; target++) {
+        override->changeActiveTarget(target);
+        override->showChannels(true, true, true, target % 2 == 0);
+        drawFrame(override, "modelPanel4");
+        override->showChannels(true, true, true, false);
+    }
+    CHECK(shaderMgr->standinCompilations() == compilations);
+    override->changeActiveTarget(viewOverride::kColor);
+}
+
+
+void testChannelMasks(viewOverride *override) {
+    // masks are kept per target
+    override->changeActiveTarget(viewOverride::kNormals);
+    override->showChannels(true, false, false, false);
+    override->changeActiveTarget(viewOverride::kColor);
+    std::vector<std::string> names = drawFrame(override, "modelPanel4");
+    CHECK(!contains(names, "viewOverride_Quad"));  // the color target still shows all channels
+    override->showChannels(false, false, false, true);
+    names = drawFrame(override, "modelPanel4");
+    CHECK(contains(names, "viewOverride_Quad"));
+    override->showChannels(true, true, true, false);
+    override->changeActiveTarget(viewOverride::kNormals);
+    override->showChannels(true, true, true, false);
+    override->changeActiveTarget(viewOverride::kColor);
+}
+
+
+void testShaderReload() {
+    // the shipped effects are valid
+    std::string buffer, error;
+    CHECK(ShaderWatcher::preprocess(SHADER_DIR, "quadDebug.ogsfx", buffer, error));
+    CHECK(ShaderWatcher::preprocess(SHADER_DIR, "quadDebug10.fx", buffer, error));
+    CHECK(ShaderWatcher::preprocess(SHADER_DIR, "quadCopy.ogsfx", buffer, error));
+    CHECK(ShaderWatcher::preprocess(SHADER_DIR, "quadCopy10.fx", buffer, error));
+    CHECK(ShaderWatcher::preprocess(SHADER_DIR, "quadUpscale.ogsfx", buffer, error));
+    CHECK(ShaderWatcher::preprocess(SHADER_DIR, "quadUpscale10.fx", buffer, error));
+    CHECK(ShaderWatcher::preprocess(SHADER_DIR, "oitComposite.ogsfx", buffer, error));
+    CHECK(ShaderWatcher::preprocess(SHADER_DIR, "oitAccumulate.ogsfx", buffer, error));
+    CHECK(ShaderWatcher::preprocess(SHADER_DIR, "oitAccumulate10.fx", buffer, error));
+
+    // edits are picked up by the watcher and broken ones are reported
+    std::string directory = "./";
+    ShaderWatcher watcher;
+    watcher.start(directory, { "watcherTest" });
+    std::this_thread::sleep_for(std::chrono::milliseconds(2 * ShaderWatcher::kPollInterval));
+    std::ofstream("watcherTest.ogsfx") << "technique main { pass p0 { }\n";
+    std::vector<ShaderSource> sources;
+    for (int i = 0; i < 40 && sources.empty(); i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        watcher.collect(sources);
+    }
+    watcher.stop();
+    std::remove("watcherTest.ogsfx");
+    CHECK(sources.size() == 1);
+    if (!sources.empty()) {
+        CHECK(sources[0].effect == "watcherTest");
+        CHECK(sources[0].extension == ".ogsfx");
+        CHECK(!sources[0].error.empty());  // unbalanced braces
+    }
+
+    // a failed compile keeps the previous shader instance
+    QuadRender quadOp("reload", "quadDebug", "debug");
+    const MHWRender::MShaderInstance *shader = quadOp.shader();
+    CHECK(!quadOp.reloadShader("", 0));
+    CHECK(quadOp.shader() == shader);
+    CHECK(quadOp.reloadShader(buffer.c_str(), (unsigned int)buffer.size()));
+    CHECK(quadOp.shader() != nullptr);
+}
+
+
+void testResolutionScaler() {
+    ResolutionScaler scaler;
+    CHECK(scaler.update(100.0f) == 1.0f);  // disabled without a budget
+    scaler.setBudget(10.0f);
+    for (int i = 0; i < 20; i++) {
+        scaler.update(40.0f);
+    }
+    CHECK(scaler.scale() == ResolutionScaler::kMinScale);
+    scaler.update(1000.0f);  // first frame after the viewport was idle
+    CHECK(scaler.scale() == 1.0f);
+    scaler.update(20.0f);
+    CHECK(scaler.scale() < 1.0f);
+    for (int i = 0; i < 50; i++) {
+        scaler.update(5.0f);
+    }
+    CHECK(scaler.scale() == 1.0f);
+}
+
+
+void testDynamicResolution(viewOverride *override) {
+    setViewport(1024, 768);
+    std::vector<std::string> names = drawFrame(override, "modelPanel4");
+    unsigned long long fullBytes = override->naiveBytes();
+    // over budget, the scene renders at a lower resolution and is upscaled before the UI
+    override->setResolutionBudget(10.0f);
+    for (int i = 0; i < 20; i++) {
+        override->frameStats().record(40.0f);
+        names = drawFrame(override, "modelPanel4");
+    }
+    CHECK(override->resolutionScale() == ResolutionScaler::kMinScale);
+    CHECK(contains(names, "viewOverride_Upscale"));
+    CHECK(names[names.size() - 3] == "viewOverride_Scene_UI");
+    for (unsigned int i = 0; i < TargetPool::kShrinkCooldown; i++) {
+        override->frameStats().record(40.0f);
+        drawFrame(override, "modelPanel4");
+    }
+    CHECK(override->naiveBytes() < fullBytes);  // once the scene targets shrank
+    // back to full resolution (and no upscale) after an idle frame
+    override->frameStats().record(1000.0f);
+    names = drawFrame(override, "modelPanel4");
+    CHECK(!contains(names, "viewOverride_Upscale"));
+    CHECK(override->naiveBytes() == fullBytes);
+    override->setResolutionBudget(0.0f);
+    override->frameStats().reset();
+}
+
+
+void testFrameCache(viewOverride *override) {
+    MHWRender::MDrawContext &context = MHWRender::MRenderer::theRenderer()->standinDrawContext();
+    size_t callbacks = MMessage::standinCallbackCount();
+    setViewport(1024, 768);
+    override->enableFrameCache(true);
+    std::vector<std::string> names = drawFrame(override, "modelPanel4");
+    CHECK(contains(names, "viewOverride_Scene"));
+    CHECK(!override->frameCached());
+    // nothing changed, only the HUD and present operations run over the cached image
+    unsigned long long allocations = MHWRender::MRenderer::theRenderer()->getRenderTargetManager()->standinAllocations();
+    names = drawFrame(override, "modelPanel4");
+    CHECK(override->frameCached());
+    CHECK(names.size() == 2);
+    CHECK(names.front() == "HUD");
+    CHECK(names.back() == "viewOverride_Present");
+    CHECK(MHWRender::MRenderer::theRenderer()->getRenderTargetManager()->standinAllocations() == allocations);
+    // each panel keeps its own image
+    names = drawFrame(override, "modelPanel1");
+    CHECK(!override->frameCached());
+    names = drawFrame(override, "modelPanel4");
+    CHECK(override->frameCached());
+
+    // camera, viewport, display style and scene changes draw the panel again
+    MMatrix view;
+    view(3, 2) = -10.0;
+    context.standinSetMatrices(view, MMatrix());
+    drawFrame(override, "modelPanel4");
+    CHECK(!override->frameCached());
+    drawFrame(override, "modelPanel4");
+    CHECK(override->frameCached());
+    setViewport(1000, 768);
+    drawFrame(override, "modelPanel4");
+    CHECK(!override->frameCached());
+    context.standinSetDisplayStyle(MHWRender::MFrameContext::kWireFrame);
+    drawFrame(override, "modelPanel4");
+    CHECK(!override->frameCached());
+    MMessage::standinEmit("SelectionChanged");
+    drawFrame(override, "modelPanel4");
+    CHECK(!override->frameCached());
+    size_t watched = MMessage::standinCallbackCount();
+    MObject shape = MFnDagNode::standinCreateShape("pSphereShape1", MBoundingBox(MPoint(-1.0, -1.0, -1.0), MPoint(1.0, 1.0, 1.0)));
+    MMessage::standinEmit("nodeAdded", shape);  // watches the dirty messages of the new node
+    CHECK(MMessage::standinCallbackCount() == watched + 1);
+    drawFrame(override, "modelPanel4");
+    CHECK(!override->frameCached());
+    drawFrame(override, "modelPanel4");
+    CHECK(override->frameCached());
+    MMessage::standinEmit("nodeDirty", shape);
+    drawFrame(override, "modelPanel4");
+    CHECK(!override->frameCached());
+    // utility nodes aren't watched, they dirty the nodes they are connected to
+    MObject utility = MFnDagNode::standinCreateNode("multiplyDivide1", 0);
+    MMessage::standinEmit("nodeAdded", utility);
+    CHECK(MMessage::standinCallbackCount() == watched + 1);
+    // and the callbacks of deleted nodes are removed
+    for (int i = 0; i < 3; i++) {
+        MObject material = MFnDagNode::standinCreateNode("lambert" + MString(std::to_string(i + 2).c_str()), 1u << MFn::kLambert);
+        MMessage::standinEmit("nodeAdded", material);
+        CHECK(MMessage::standinCallbackCount() == watched + 2);
+        MMessage::standinEmit("nodeRemoved", material);
+    }
+    MMessage::standinEmit("nodeRemoved", shape);
+    CHECK(MMessage::standinCallbackCount() == watched);
+    drawFrame(override, "modelPanel4");
+    CHECK(!override->frameCached());
+
+    override->enableFrameCache(false);
+    CHECK(MMessage::standinCallbackCount() == callbacks);
+    drawFrame(override, "modelPanel4");
+    drawFrame(override, "modelPanel4");
+    CHECK(!override->frameCached());
+    context.standinSetMatrices(MMatrix(), MMatrix());
+    context.standinSetDisplayStyle(MHWRender::MFrameContext::kGouraudShaded);
+}
+
+
+void testProxyObjects(viewOverride *override) {
+    MHWRender::MDrawContext &context = MHWRender::MRenderer::theRenderer()->standinDrawContext();
+    size_t callbacks = MMessage::standinCallbackCount();
+    setViewport(1024, 768);
+    MStringArray patterns;
+    patterns.append("*_proxy");
+    override->setProxyObjects(patterns);
+    MObject camera = MFnDagNode::standinCreateTransform("persp");
+    MObject cameraShape = MFnDagNode::standinCreateShape("perspShape", MBoundingBox(), 1u << MFn::kCamera);
+    MFnDagNode::standinAddChild(camera, cameraShape);
+    MMessage::standinEmit("nodeAdded", camera);
+    MMessage::standinEmit("nodeAdded", cameraShape);
+    drawFrame(override, "modelPanel4");
+    CHECK(!override->proxyDrawn());  // nothing to compare the camera with yet
+    // the scene renders only draw the proxy set while the camera moves, which dirties the camera nodes
+    MMatrix view;
+    for (int i = 1; i <= 3; i++) {
+        view(3, 2) = -1.0 * i;
+        context.standinSetMatrices(view, MMatrix());
+        MMessage::standinEmit("nodeDirty", camera);
+        MMessage::standinEmit("nodeDirty", cameraShape);
+        drawFrame(override, "modelPanel4");
+        CHECK(override->proxyDrawn());
+    }
+    CHECK(override->startOperationIterator());
+    const MSelectionList *objectSet = ((MHWRender::MSceneRender*)override->renderOperation())->objectSetOverride();
+    CHECK(objectSet && objectSet->length() == 1);
+    // all objects once it stopped, or if the scene changed
+    std::vector<std::string> names = drawFrame(override, "modelPanel4");
+    CHECK(!override->proxyDrawn() && contains(names, "viewOverride_Scene"));
+    CHECK(override->startOperationIterator());
+    CHECK(((MHWRender::MSceneRender*)override->renderOperation())->objectSetOverride() == nullptr);
+    view(3, 2) = -5.0;
+    context.standinSetMatrices(view, MMatrix());
+    MMessage::standinEmit("nodeAdded");
+    drawFrame(override, "modelPanel4");
+    CHECK(!override->proxyDrawn());
+    override->setProxyObjects(MStringArray());
+    CHECK(MMessage::standinCallbackCount() == callbacks);
+    view(3, 2) = -6.0;
+    context.standinSetMatrices(view, MMatrix());
+    drawFrame(override, "modelPanel4");
+    CHECK(!override->proxyDrawn());
+    context.standinSetMatrices(MMatrix(), MMatrix());
+}
+
+
+void testPartialRedraw(viewOverride *override) {
+    // screen rectangles of bounds, with a lower left origin
+    MMatrix identity;
+    DirtyRect rect;
+    CHECK(DirtyRegion::project(MBoundingBox(MPoint(-0.5, -0.5, 0.0), MPoint(0.5, 0.5, 0.5)), identity, 100, 100, rect));
+    CHECK(rect.x == 25 && rect.y == 25 && rect.width == 50 && rect.height == 50);
+    rect.pad(30, 100, 100);
+    CHECK(rect.x == 0 && rect.width == 100);
+    MMatrix perspective;
+    perspective(2, 3) = -1.0;  // w = -z, the camera looks down -z
+    perspective(3, 3) = 0.0;
+    CHECK(!DirtyRegion::project(MBoundingBox(MPoint(-1.0, -1.0, -1.0), MPoint(1.0, 1.0, 1.0)), perspective, 100, 100, rect));
+    // the crop matrix maps the rectangle to the whole clip space
+    DirtyRect crop;
+    crop.x = 25;
+    crop.y = 50;
+    crop.width = 50;
+    crop.height = 25;
+    MMatrix cropMatrix = DirtyRegion::cropMatrix(crop, 100, 100);
+    CHECK(std::fabs(0.5 * cropMatrix(0, 0) + cropMatrix(3, 0) - 1.0) < 1e-6);  // right
+    CHECK(std::fabs(0.0 * cropMatrix(1, 1) + cropMatrix(3, 1) + 1.0) < 1e-6);  // bottom
+    CHECK(std::fabs(0.5 * cropMatrix(1, 1) + cropMatrix(3, 1) - 1.0) < 1e-6);  // top
+
+    size_t callbacks = MMessage::standinCallbackCount();
+    setViewport(1024, 768);
+    override->setPartialRedraw(0.25f);
+    CHECK(MMessage::standinCallbackCount() > callbacks);
+    MObject shape = MFnDagNode::standinCreateShape("pCubeShape1", MBoundingBox(MPoint(-0.1, -0.1, -0.1), MPoint(0.1, 0.1, 0.1)));
+    MObject transform = MFnDagNode::standinCreateTransform("pCube1");
+    MFnDagNode::standinAddChild(transform, shape);
+    MMessage::standinEmit("nodeAdded", transform);
+    MMessage::standinEmit("nodeAdded", shape);
+    std::vector<std::string> names = drawFrame(override, "modelPanel4");
+    CHECK(!contains(names, "viewOverride_Partial_Clear") && override->redrawnFraction() == 1.0f);
+    // the first change of a shape redraws everything, its bounds weren't known where it was drawn
+    MMessage::standinEmit("nodeDirty", shape);
+    names = drawFrame(override, "modelPanel4");
+    CHECK(!contains(names, "viewOverride_Partial_Clear"));
+    // dragging its transform only redraws around its old and new bounds, over the last image
+    MMatrix world;
+    world(3, 0) = 0.2;
+    MFnDagNode::standinSetWorldMatrix(shape, world);
+    MMessage::standinEmit("nodeDirty", transform);
+    names = drawFrame(override, "modelPanel4");
+    CHECK(contains(names, "viewOverride_Partial_Clear") && contains(names, "viewOverride_Scene"));
+    CHECK(override->redrawnFraction() > 0.0f && override->redrawnFraction() < 0.25f);
+    const DirtyRect &partial = override->partialRectangle();
+    CHECK(partial.x < 512 && partial.x + partial.width > 563 && partial.width < 512);
+    CHECK(override->startOperationIterator());
+    CHECK(std::string(override->renderOperation()->name().asChar()) == "viewOverride_Partial_Clear");
+    CHECK(override->nextRenderOperation());
+    MHWRender::MSceneRender *sceneOp = (MHWRender::MSceneRender*)override->renderOperation();
+    CHECK(sceneOp->clearOperation().mask() == (unsigned int)MHWRender::MClearOperation::kClearNone);
+    CHECK(sceneOp->viewportRectangleOverride() != nullptr);
+    CHECK(sceneOp->cameraOverride() && sceneOp->cameraOverride()->mUseProjectionMatrix);
+    // OIT draws and composites the whole frame, even if enabled after a redrawable frame
+    override->enableOIT(true);
+    world(3, 0) = 0.1;
+    MFnDagNode::standinSetWorldMatrix(shape, world);
+    MMessage::standinEmit("nodeDirty", transform);
+    names = drawFrame(override, "modelPanel4");
+    CHECK(!contains(names, "viewOverride_Partial_Clear") && override->redrawnFraction() == 1.0f);
+    override->enableOIT(false);
+    drawFrame(override, "modelPanel4");
+    world(3, 0) = 0.2;
+    MFnDagNode::standinSetWorldMatrix(shape, world);
+    MMessage::standinEmit("nodeDirty", transform);
+    names = drawFrame(override, "modelPanel4");
+    CHECK(contains(names, "viewOverride_Partial_Clear"));
+    // other changes (e.g., a material), or moves over the threshold, redraw everything
+    MObject material = MFnDagNode::standinCreateNode("lambert2", 1u << MFn::kLambert);
+    MMessage::standinEmit("nodeAdded", material);
+    drawFrame(override, "modelPanel4");
+    MMessage::standinEmit("nodeDirty", material);
+    names = drawFrame(override, "modelPanel4");
+    CHECK(!contains(names, "viewOverride_Partial_Clear") && override->redrawnFraction() == 1.0f);
+    world(3, 0) = -0.9;
+    world(3, 1) = -0.9;
+    MFnDagNode::standinSetWorldMatrix(shape, world);
+    MMessage::standinEmit("nodeDirty", shape);
+    names = drawFrame(override, "modelPanel4");
+    CHECK(!contains(names, "viewOverride_Partial_Clear"));
+    // and the camera moving
+    world(3, 0) = 0.8;
+    MFnDagNode::standinSetWorldMatrix(shape, world);
+    MMessage::standinEmit("nodeDirty", shape);
+    MMatrix view;
+    view(3, 2) = -1.0;
+    MHWRender::MRenderer::theRenderer()->standinDrawContext().standinSetMatrices(view, MMatrix());
+    names = drawFrame(override, "modelPanel4");
+    CHECK(!contains(names, "viewOverride_Partial_Clear"));
+    MHWRender::MRenderer::theRenderer()->standinDrawContext().standinSetMatrices(MMatrix(), MMatrix());
+    override->setPartialRedraw(0.0f);
+    CHECK(MMessage::standinCallbackCount() == callbacks);
+    drawFrame(override, "modelPanel4");
+}
+
+
+void testProgressiveAccumulation(viewOverride *override) {
+    setViewport(1024, 768);
+    override->setProgressiveSamples(4);
+    std::vector<std::string> names = drawFrame(override, "modelPanel4");
+    CHECK(!contains(names, "viewOverride_Accumulate"));  // interactive frames stay cheap
+    // still frames accumulate jittered scene renders
+    std::vector<MMatrix> projections;
+    for (unsigned int i = 0; i < 4; i++) {
+        names = drawFrame(override, "modelPanel4");
+        CHECK(contains(names, "viewOverride_Scene"));
+        CHECK(contains(names, "viewOverride_Accumulate"));
+        CHECK(contains(names, "viewOverride_Resolve"));
+        CHECK(override->startOperationIterator());
+        const MHWRender::MCameraOverride *camera = ((MHWRender::MSceneRender*)override->renderOperation())->cameraOverride();
+        CHECK(camera && camera->mUseProjectionMatrix);
+        if (camera) {
+            projections.push_back(camera->mProjectionMatrix);
+        }
+    }
+    CHECK(projections.size() == 4 && projections[0] != projections[1] && projections[0] != MMatrix());
+    // converged, the accumulated image is copied back for the UI without rendering the scene
+    names = drawFrame(override, "modelPanel4");
+    CHECK(!contains(names, "viewOverride_Scene"));
+    CHECK(!contains(names, "viewOverride_Accumulate"));
+    CHECK(contains(names, "viewOverride_Resolve"));
+    CHECK(contains(names, "viewOverride_Scene_UI"));
+    // and cached with the frame cache
+    override->enableFrameCache(true);
+    names = drawFrame(override, "modelPanel4");
+    CHECK(override->frameCached());
+    // a change starts over
+    MMessage::standinEmit("SelectionChanged");
+    names = drawFrame(override, "modelPanel4");
+    CHECK(!contains(names, "viewOverride_Accumulate"));
+    names = drawFrame(override, "modelPanel4");
+    CHECK(contains(names, "viewOverride_Accumulate"));
+    override->enableFrameCache(false);
+    override->setProgressiveSamples(0);
+    names = drawFrame(override, "modelPanel4");
+    CHECK(!contains(names, "viewOverride_Resolve"));
+}
+
+
+void testPassAblation(viewOverride *override) {
+    setViewport(1024, 768);
+    const char *path = "passAblationTest.json";
+    unsigned int sceneLayout = override->sceneLayout();
+    unsigned int gBufferLayout = override->gBufferLayout();
+    std::vector<std::string> names = drawFrame(override, "modelPanel4");
+    CHECK(contains(names, "viewOverride_Scene_UI"));
+    CHECK(override->benchmarkAblations(path, 3) == MStatus::kSuccess);
+    const AblationBenchmark &benchmark = override->ablationBenchmark();
+    unsigned int roots = contains(names, "viewOverride_Present") ? 1 : 0;
+    CHECK(benchmark.configCount() == 1 + names.size() - roots + (viewOverride::kLayoutCount - 1) + (viewOverride::kSceneLayoutCount - 1));
+    bool disabledDrawn = false;
+    for (unsigned int frame = 0; frame < 1000 && override->benchmarkingAblations(); frame++) {
+        names = drawFrame(override, "modelPanel4");
+        if (override->benchmarkingAblations() && benchmark.results()[benchmark.currentConfig()].config.name == "disable viewOverride_Scene_UI") {
+            disabledDrawn = disabledDrawn || contains(names, "viewOverride_Scene_UI");
+        }
+    }
+    CHECK(!override->benchmarkingAblations() && !disabledDrawn);
+    for (const AblationResult &result : benchmark.results()) {
+        CHECK(result.cpu.summary().count == 3);
+    }
+    // the configuration is restored and the report written
+    CHECK(override->sceneLayout() == sceneLayout && override->gBufferLayout() == gBufferLayout);
+    names = drawFrame(override, "modelPanel4");
+    CHECK(contains(names, "viewOverride_Scene_UI"));
+    std::ifstream file(path);
+    std::string report((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    file.close();
+    CHECK(report.find("\"name\": \"baseline\"") != std::string::npos);
+    CHECK(report.find("\"name\": \"disable viewOverride_Scene\"") != std::string::npos);
+    CHECK(report.find("\"name\": \"mrtLayout 0\"") != std::string::npos);
+    std::remove(path);
+    // stopped without a report
+    CHECK(override->benchmarkAblations(path, 3) == MStatus::kSuccess);
+    for (unsigned int i = 0; i < 10; i++) {
+        drawFrame(override, "modelPanel4");
+    }
+    CHECK(override->benchmarkAblations(path, 0) == MStatus::kSuccess);
+    CHECK(!override->benchmarkingAblations());
+    CHECK(override->sceneLayout() == sceneLayout && override->gBufferLayout() == gBufferLayout);
+    names = drawFrame(override, "modelPanel4");
+    CHECK(contains(names, "viewOverride_Scene") && contains(names, "viewOverride_Scene_UI"));
+    std::remove(path);
+}
+
+
+void testDepthPyramid(viewOverride *override) {
+    // levels halve the scene size (rounded up) down to a single texel: 500x300 ... 1x1
+    setViewport(1000, 600);
+    std::vector<std::string> names = drawFrame(override, "modelPanel4");
+    CHECK(!contains(names, "viewOverride_HiZ_0"));
+    override->enableDepthPyramid(true);
+    names = drawFrame(override, "modelPanel4");
+    CHECK(override->depthPyramidLevels() == 10);
+    CHECK(contains(names, "viewOverride_HiZ_9") && !contains(names, "viewOverride_HiZ_10"));
+    size_t first = std::find(names.begin(), names.end(), "viewOverride_HiZ_0") - names.begin();
+    size_t scene = std::find(names.begin(), names.end(), "viewOverride_Scene") - names.begin();
+    size_t ui = std::find(names.begin(), names.end(), "viewOverride_Scene_UI") - names.begin();
+    CHECK(scene < first && first < ui && names[first + 1] == "viewOverride_HiZ_1");
+    MStringArray levelTimes;
+    override->depthPyramidTimes(levelTimes);
+    CHECK(levelTimes.length() == 10 && levelTimes[3] == "viewOverride_HiZ_3 63x38");
+    CHECK(levelTimes.length() == 10 && levelTimes[9] == "viewOverride_HiZ_9 1x1");
+    // each level renders into the sub-rectangle of its own size bucket
+    override->setup("modelPanel4");
+    if (override->startOperationIterator()) {
+        do {
+            MHWRender::MRenderOperation *operation = override->renderOperation();
+            if (operation->name() == "viewOverride_HiZ_3") {
+                const MFloatPoint *rect = ((QuadRender*)operation)->viewportRectangleOverride();
+                CHECK(rect && rect->z == 63.0f / 128.0f && rect->w == 38.0f / 128.0f);
+            }
+        } while (override->nextRenderOperation());
+    }
+    override->cleanup();
+    override->enableDepthPyramid(false);
+    names = drawFrame(override, "modelPanel4");
+    CHECK(!contains(names, "viewOverride_HiZ_0") && override->depthPyramidLevels() == 0);
+}
+
+
+void testOverdraw(viewOverride *override) {
+    // reduced (sum, max, pixels above the threshold, pixels)
+    const float reduced[4] = { 20.0f, 5.0f, 3.0f, 10.0f };
+    OverdrawSummary summary = OverdrawStats::summarize(reduced);
+    CHECK(summary.valid && summary.pixels == 10 && summary.meanLayers == 2.0f);
+    CHECK(summary.maxLayers == 5.0f && summary.aboveFraction == 0.3f);
+    const float empty[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+    CHECK(!OverdrawStats::summarize(empty).valid);
+    // all fragments: instrumentation scene render, heatmap and the reduction chain down to the staging target
+    setViewport(1000, 600);
+    override->setOverdrawMode(viewOverride::kOverdrawFragments, 4);
+    std::vector<std::string> names = drawFrame(override, "modelPanel4");
+    CHECK(contains(names, "viewOverride_Overdraw") && !contains(names, "viewOverride_Overdraw_Transparent"));
+    CHECK(contains(names, "viewOverride_Overdraw_Stats_0") && contains(names, "viewOverride_Overdraw_Stats_4"));
+    size_t count = std::find(names.begin(), names.end(), "viewOverride_Overdraw") - names.begin();
+    size_t heatmap = std::find(names.begin(), names.end(), "viewOverride_Overdraw_Heatmap") - names.begin();
+    size_t ui = std::find(names.begin(), names.end(), "viewOverride_Scene_UI") - names.begin();
+    CHECK(count < heatmap && heatmap < ui);
+    // transparent layers only
+    override->setOverdrawMode(viewOverride::kOverdrawTransparent, 4);
+    names = drawFrame(override, "modelPanel4");
+    CHECK(!contains(names, "viewOverride_Overdraw") && contains(names, "viewOverride_Overdraw_Transparent"));
+    CHECK(contains(names, "viewOverride_Overdraw_Heatmap") && contains(names, "viewOverride_Overdraw_Stats_4"));
+    override->setOverdrawMode(viewOverride::kOverdrawOff, 4);
+    names = drawFrame(override, "modelPanel4");
+    CHECK(!contains(names, "viewOverride_Overdraw_Transparent") && !contains(names, "viewOverride_Overdraw_Heatmap"));
+    CHECK(!contains(names, "viewOverride_Overdraw_Stats_0") && !override->overdrawSummary().valid);
+}
+
+
+void testCapture(viewOverride *override) {
+    // encoders
+    CHECK(CaptureImage::halfToFloat(0x3C00) == 1.0f);
+    CHECK(CaptureImage::halfToFloat(0xC000) == -2.0f);
+    CaptureImage image;
+    image.path = "image.exr";
+    image.channels = "RGBA";
+    image.format = MHWRender::kR16G16B16A16_FLOAT;
+    image.width = 3;
+    image.height = 2;
+    image.data.assign(3 * 2 * 8, 0);
+    std::vector<unsigned char> file;
+    std::string error;
+    CHECK(image.encode(file, error));
+    const unsigned char exrMagic[4] = { 0x76, 0x2f, 0x31, 0x01 };
+    CHECK(file.size() > 8 && std::equal(exrMagic, exrMagic + 4, file.begin()));
+    CHECK(std::string(file.begin() + 8, file.begin() + 16) == "channels");
+    image.path = "image.png";
+    CHECK(image.encode(file, error));
+    const unsigned char pngEnd[8] = { 'I', 'E', 'N', 'D', 0xAE, 0x42, 0x60, 0x82 };  // chunk type and CRC
+    CHECK(file.size() > 8 && file[1] == 'P' && std::equal(pngEnd, pngEnd + 8, file.end() - 8));
+    CHECK(file[19] == 3 && file[23] == 2);  // big-endian width and height
+    image.path = "image.jpg";
+    CHECK(!image.encode(file, error) && !error.empty());
+
+    // the targets of the captured panel are copied every frame and read back kLatency frames later
+    setViewport(640, 480);
+    CHECK(override->captureFrames("capture.jpg", 2) == MStatus::kFailure);
+    CHECK(override->captureFrames("captureTest.png", 2) == MStatus::kSuccess);
+    std::vector<std::string> names = drawFrame(override, "modelPanel4");
+    CHECK(contains(names, "viewOverride_Capture_Color"));
+    CHECK(contains(names, "viewOverride_Capture_Depth"));
+    CHECK(contains(names, "viewOverride_Capture_Normals"));
+    names = drawFrame(override, "modelPanel1");  // other panels aren't captured
+    CHECK(!contains(names, "viewOverride_Capture_Color"));
+    names = drawFrame(override, "modelPanel4");
+    CHECK(contains(names, "viewOverride_Capture_Color"));
+    CHECK(override->frameCapture().framesLeft() == 0);
+    CHECK(override->frameCapture().framesInFlight() == 2);
+    for (unsigned int i = 0; i < FrameCapture::kLatency; i++) {
+        names = drawFrame(override, "modelPanel4");
+        CHECK(!contains(names, "viewOverride_Capture_Color"));
+    }
+    CHECK(!override->frameCapture().active());
+    override->frameCapture().writer().wait();
+    CHECK(override->frameCapture().writer().written() == 6);
+    CHECK(override->frameCapture().writer().failed() == 0);
+    const char *files[] = { "captureTest.color.0001.png", "captureTest.depth.0001.png", "captureTest.normals.0001.png",
+        "captureTest.color.0002.png", "captureTest.depth.0002.png", "captureTest.normals.0002.png" };
+    for (const char *fileName : files) {
+        std::ifstream captured(fileName, std::ios::binary | std::ios::ate);
+        CHECK(captured && captured.tellg() > 640 * 480);
+        captured.close();
+        std::remove(fileName);
+    }
+}
+
+
+void testImageDiff() {
+    // the SIMD kernels match the scalar one, with a tail of pixels and more channels than a vector
+    DiffImage golden, test;
+    golden.width = test.width = 37;
+    golden.height = test.height = 19;
+    golden.channels = test.channels = { "A", "B", "G", "R", "Z" };
+    golden.pixels.resize(golden.channels.size() * golden.width * golden.height);
+    test.pixels.resize(golden.pixels.size());
+    unsigned int seed = 1;
+    for (size_t i = 0; i < golden.pixels.size(); i++) {
+        seed = seed * 1664525u + 1013904223u;
+        golden.pixels[i] = (seed >> 8) / 16777216.0f;
+        test.pixels[i] = golden.pixels[i] + ((i % 7 == 0) ? 0.01f : 0.0f);
+    }
+    DiffTolerance tolerance;
+    DiffResult scalar = ImageDiff::compare(golden, test, tolerance, nullptr, ImageDiff::kScalar);
+    CHECK(scalar.error.empty() && !scalar.passed);
+    CHECK(scalar.pixels == 37 * 19 && scalar.overTolerance > 0 && scalar.overTolerance < scalar.pixels);
+    CHECK(scalar.ssim < 1.0 && scalar.minSSIM <= scalar.ssim);
+    for (int kernel = ImageDiff::kSSE2; kernel < ImageDiff::kKernelCount; kernel++) {
+        if (!ImageDiff::supported((ImageDiff::Kernel)kernel)) {
+            continue;
+        }
+        std::vector<float> heat;
+        DiffResult result = ImageDiff::compare(golden, test, tolerance, &heat, (ImageDiff::Kernel)kernel);
+        CHECK(result.overTolerance == scalar.overTolerance);
+        CHECK(result.maxDifference == scalar.maxDifference);
+        CHECK(std::abs(result.rmse - scalar.rmse) < 1e-6);
+        CHECK(std::abs(result.ssim - scalar.ssim) < 1e-4);
+        CHECK(heat.size() == 37 * 19);
+    }
+
+    // identical images, NaNs and mismatched sizes
+    DiffResult same = ImageDiff::compare(golden, golden, tolerance);
+    CHECK(same.passed && same.rmse == 0.0 && same.ssim == 1.0 && same.overTolerance == 0);
+    test.pixels = golden.pixels;
+    test.pixels[5] = std::numeric_limits<float>::quiet_NaN();
+    CHECK(ImageDiff::compare(golden, test, tolerance).overTolerance == 1);
+    test.width = 36;
+    CHECK(!ImageDiff::compare(golden, test, tolerance).error.empty());
+
+    // zlib stream with fixed Huffman codes
+    const unsigned char compressed[] = { 0x78, 0xda, 0x4b, 0xcf, 0xcf, 0x49, 0x49, 0xcd, 0x53, 0x48, 0x47, 0xa1,
+        0x32, 0x73, 0x13, 0xd3, 0x53, 0x51, 0xc8, 0x94, 0xcc, 0xb4, 0x34, 0x00, 0x60, 0xc4, 0x0f, 0xce };
+    std::vector<unsigned char> inflated;
+    CHECK(DiffImage::inflate(compressed, sizeof(compressed), inflated));
+    CHECK(std::string(inflated.begin(), inflated.end()) == "golden golden golden image image image diff");
+
+    // captured files read back
+    CaptureImage image;
+    image.channels = "RGBA";
+    image.format = MHWRender::kR8G8B8A8_UNORM;
+    image.width = 3;
+    image.height = 2;
+    image.data = { 255, 0, 0, 255, 0, 255, 0, 255, 0, 0, 255, 255, 51, 51, 51, 0, 0, 0, 0, 0, 255, 255, 255, 255 };
+    const char *paths[] = { "imageDiffTest.png", "imageDiffTest.exr" };
+    for (const char *path : paths) {
+        image.path = path;
+        std::vector<unsigned char> file;
+        std::string error;
+        if (std::string(path).find(".exr") != std::string::npos) {
+            image.format = MHWRender::kR32G32B32A32_FLOAT;
+            std::vector<float> values(image.data.begin(), image.data.end());
+            for (float &value : values) {
+                value /= 255.0f;
+            }
+            image.data.assign((unsigned char*)values.data(), (unsigned char*)(values.data() + values.size()));
+        }
+        CHECK(image.encode(file, error));
+        std::ofstream(path, std::ios::binary).write((const char*)file.data(), file.size());
+        DiffImage read;
+        CHECK(DiffImage::read(path, read, error));
+        CHECK(read.width == 3 && read.height == 2 && read.channels.size() == 4);
+        unsigned int red = (unsigned int)(std::find(read.channels.begin(), read.channels.end(), "R") - read.channels.begin());
+        CHECK(red < 4 && read.plane(red)[0] == 1.0f && std::abs(read.plane(red)[3] - 0.2f) < 1e-3f);
+        std::remove(path);
+    }
+    DiffImage missing;
+    std::string error;
+    CHECK(!DiffImage::read("imageDiffMissing.png", missing, error) && !error.empty());
+    // a file truncated right after a chunk header
+    const unsigned char truncated[16] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n', 0, 0, 0, 13, 'I', 'H', 'D', 'R' };
+    std::ofstream("imageDiffTruncated.png", std::ios::binary).write((const char*)truncated, sizeof(truncated));
+    error.clear();
+    CHECK(!DiffImage::read("imageDiffTruncated.png", missing, error) && !error.empty());
+    std::remove("imageDiffTruncated.png");
+}
+
+
+void testFrameTimeStats() {
+    FrameTimeStats stats;
+    CHECK(stats.summary().count == 0);
+    for (unsigned int i = 0; i < 2 * FrameTimeStats::kCapacity; i++) {
+        stats.record((i % 100 == 99) ? 50.0f : 10.0f);
+    }
+    FrameTimeSummary summary = stats.summary();
+    CHECK(summary.count == FrameTimeStats::kCapacity);
+    CHECK(summary.p50 == 10.0f);
+    CHECK(summary.max == 50.0f);
+    CHECK(summary.hitches == 20);
+}
+
+
+int main() {
+    viewOverride *override = new viewOverride("viewOverride");
+    MHWRender::MRenderer::theRenderer()->registerOverride(override);
+
+    testGraphCulling(override);
+    testTargetAliasing();
+    testTargetPool(override);
+    testGBufferLayout(override);
+    testSceneLayouts(override);
+    testABTest();
+    testAblationBenchmark();
+    testGPUProfiler();
+    testQuadParameters();
+    testShaderPermutations(override);
+    testChannelMasks(override);
+    testShaderReload();
+    testFrameTimeStats();
+    testResolutionScaler();
+    testDynamicResolution(override);
+    testFrameCache(override);
+    testProgressiveAccumulation(override);
+    testProxyObjects(override);
+    testPartialRedraw(override);
+    testPassAblation(override);
+    testDepthPyramid(override);
+    testOverdraw(override);
+    testCapture(override);
+    testImageDiff();
+
+    MHWRender::MRenderer::theRenderer()->deregisterOverride(override);
+    delete override;
+    CHECK(MHWRender::MRenderer::theRenderer()->getRenderTargetManager()->standinLiveTargets() == 0);
+
+    if (sFailures) {
+        std::cerr << sFailures << " check(s) failed" << std::endl;
+        return 1;
+    }
+    std::cout << "All tests passed" << std::endl;
+    return 0;
+}
@@ -0,0 +1,228 @@
+// Title         viewOverrideDiff.cpp
+// Summary       viewOverride golden image comparison tool
+// Copyright     2020 Artineering and/or its licensors
+// License       MIT
+
+#include <mutex>
+#include <chrono>
+#include <atomic>
+#include <thread>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <dirent.h>
+#include <sys/stat.h>
+#include "viewOverrideImageDiff.h"
+
+/////////////////////////////////////////////////////////////////////
+/// Compares captured images against golden images without Maya
+///
+/// viewOverrideDiff [options] golden test
+///
+/// golden and test are .exr or .png files, or directories whose images
+/// are compared by file name (e.g., captures of viewOverride -cap).
+/// Images are compared on all hardware threads and each comparison
+/// runs the SIMD kernels of ImageDiff. Exits with 0 if all images
+/// match, 1 if any differs and 2 if any couldn't be compared.
+///
+/////////////////////////////////////////////////////////////////////
+
+namespace {
+    struct Comparison {
+        std::string name;
+        DiffResult result;
+    };
+
+    bool isDirectory(const std::string &path) {
+        struct stat info;
+        return stat(path.c_str(), &info) == 0 && S_ISDIR(info.st_mode);
+    }
+
+    bool isImage(const std::string &name) {
+        std::string extension = name.size() > 4 ? name.substr(name.size() - 4) : "";
+        std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+        return extension == ".exr" || extension == ".png";
+    }
+
+    std::vector<std::string> listImages(const std::string &directory) {
+        std::vector<std::string> names;
+        DIR *dir = opendir(directory.c_str());
+        if (!dir) {
+            return names;
+        }
+        while (dirent *entry = readdir(dir)) {
+            std::string name = entry->d_name;
+            if (isImage(name)) {
+                names.push_back(name);
+            }
+        }
+        closedir(dir);
+        std::sort(names.begin(), names.end());
+        return names;
+    }
+
+    std::string fileName(const std::string &path) {
+        size_t slash = path.find_last_of('/');
+        return (slash == std::string::npos) ? path : path.substr(slash + 1);
+    }
+
+    void usage() {
+        printf("usage: viewOverrideDiff [options] golden test\n"
+            "  golden and test are .exr or .png files, or directories compared by file name\n"
+            "  -t, --tolerance <value>   largest channel difference of a matching pixel (default 1/255)\n"
+            "  -p, --pixels <fraction>   fraction of the pixels allowed over the tolerance (default 0)\n"
+            "  -s, --ssim <value>        lowest mean SSIM of the luminance (default 0.99)\n"
+            "  -m, --heatmap <dir>       writes <name>.diff.png heatmaps of the differing images\n"
+            "      --heat-scale <value>  difference shown in yellow by the heatmaps (default 0.1)\n"
+            "  -j, --jobs <count>        images compared in parallel (default: hardware threads)\n"
+            "  -k, --kernel <name>       scalar, sse2 or avx2 (default: fastest supported)\n"
+            "  -q, --quiet               only prints differing images and the summary\n");
+    }
+}
+
+
+int main(int argc, char **argv) {
+    DiffTolerance tolerance;
+    std::string heatmapDirectory;
+    float heatScale = 0.1f;
+    unsigned int jobs = std::max(1u, std::thread::hardware_concurrency());
+    ImageDiff::Kernel kernel = ImageDiff::kBest;
+    bool quiet = false;
+    std::vector<std::string> paths;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = (i + 1 < argc);
+        if ((arg == "-t" || arg == "--tolerance") && hasValue) {
+            tolerance.channel = (float)atof(argv[++i]);
+        } else if ((arg == "-p" || arg == "--pixels") && hasValue) {
+            tolerance.pixels = atof(argv[++i]);
+        } else if ((arg == "-s" || arg == "--ssim") && hasValue) {
+            tolerance.ssim = atof(argv[++i]);
+        } else if ((arg == "-m" || arg == "--heatmap") && hasValue) {
+            heatmapDirectory = argv[++i];
+        } else if (arg == "--heat-scale" && hasValue) {
+            heatScale = (float)atof(argv[++i]);
+        } else if ((arg == "-j" || arg == "--jobs") && hasValue) {
+            jobs = std::max(1, atoi(argv[++i]));
+        } else if ((arg == "-k" || arg == "--kernel") && hasValue) {
+            std::string name = argv[++i];
+            kernel = ImageDiff::kKernelCount;
+            for (int k = 0; k < ImageDiff::kKernelCount; k++) {
+                if (name == ImageDiff::kernelName((ImageDiff::Kernel)k)) {
+                    kernel = (ImageDiff::Kernel)k;
+                }
+            }
+            if (kernel == ImageDiff::kKernelCount || !ImageDiff::supported(kernel)) {
+                fprintf(stderr, "kernel %s is not supported on this CPU\n", name.c_str());
+                return 2;
+            }
+        } else if (arg == "-q" || arg == "--quiet") {
+            quiet = true;
+        } else if (arg == "-h" || arg == "--help") {
+            usage();
+            return 0;
+        } else if (!arg.empty() && arg[0] == '-') {
+            fprintf(stderr, "unknown option %s\n", arg.c_str());
+            usage();
+            return 2;
+        } else {
+            paths.push_back(arg);
+        }
+    }
+    if (kernel == ImageDiff::kBest) {
+        kernel = ImageDiff::bestKernel();
+    }
+    if (paths.size() != 2) {
+        usage();
+        return 2;
+    }
+
+    // pairs of golden and test images
+    std::vector<std::string> names;
+    std::string goldenDirectory, testDirectory;
+    if (isDirectory(paths[0])) {
+        goldenDirectory = paths[0] + "/";
+        testDirectory = paths[1] + "/";
+        names = listImages(paths[0]);
+    } else {
+        names.push_back(fileName(paths[0]));
+        goldenDirectory = paths[0].substr(0, paths[0].size() - names[0].size());
+        testDirectory = paths[1].substr(0, paths[1].size() - fileName(paths[1]).size());
+        if (fileName(paths[1]) != names[0]) {
+            names[0] = "";  // two files with different names
+        }
+    }
+    if (names.empty()) {
+        fprintf(stderr, "no .exr or .png images in %s\n", paths[0].c_str());
+        return 2;
+    }
+
+    // compare on all workers, the images are read and compared by the same thread
+    std::vector<Comparison> comparisons(names.size());
+    std::atomic<size_t> next{ 0 };
+    std::atomic<unsigned long long> pixels{ 0 };
+    std::mutex heatmapMutex;
+    auto compare = [&]() {
+        std::vector<float> heat;
+        DiffImage golden, test;
+        for (size_t i = next++; i < names.size(); i = next++) {
+            Comparison &comparison = comparisons[i];
+            std::string goldenPath = names[i].empty() ? paths[0] : goldenDirectory + names[i];
+            std::string testPath = names[i].empty() ? paths[1] : testDirectory + names[i];
+            comparison.name = names[i].empty() ? fileName(paths[1]) : names[i];
+            std::string error;
+            if (!DiffImage::read(goldenPath, golden, error) || !DiffImage::read(testPath, test, error)) {
+                comparison.result.error = error;
+                continue;
+            }
+            bool writeHeatmap = !heatmapDirectory.empty();
+            comparison.result = ImageDiff::compare(golden, test, tolerance, writeHeatmap ? &heat : nullptr, kernel);
+            pixels += comparison.result.pixels;
+            if (writeHeatmap && comparison.result.error.empty() && !comparison.result.passed) {
+                CaptureImage image;
+                ImageDiff::heatmap(heat, golden.width, golden.height, heatScale, image);
+                image.path = heatmapDirectory + "/" + comparison.name.substr(0, comparison.name.size() - 4) + ".diff.png";
+                std::vector<unsigned char> file;
+                if (image.encode(file, error)) {
+                    FILE *stream = fopen(image.path.c_str(), "wb");
+                    if (stream) {
+                        fwrite(file.data(), 1, file.size(), stream);
+                        fclose(stream);
+                    }
+                }
+            }
+        }
+    };
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+    for (unsigned int i = 1; i < std::min(jobs, (unsigned int)names.size()); i++) {
+        workers.push_back(std::thread(compare));
+    }
+    compare();
+    for (std::thread &worker : workers) {
+        worker.join();
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    unsigned int passed = 0, failed = 0, errors = 0;
+    for (const Comparison &comparison : comparisons) {
+        const DiffResult &result = comparison.result;
+        if (!result.error.empty()) {
+            errors++;
+            printf("ERROR %s: %s\n", comparison.name.c_str(), result.error.c_str());
+            continue;
+        }
+        result.passed ? passed++ : failed++;
+        if (!quiet || !result.passed) {
+            printf("%s %s rmse %.6f max %.6f over %llu (%.4f%%) ssim %.5f (min %.5f)\n", result.passed ? "PASS" : "FAIL",
+                comparison.name.c_str(), result.rmse, result.maxDifference, result.overTolerance,
+                100.0 * result.overTolerance / std::max(1ull, result.pixels), result.ssim, result.minSSIM);
+        }
+    }
+    printf("%u passed, %u failed, %u errors in %.2f s (%.1f Mpixels/s, %s kernel)\n", passed, failed, errors, seconds,
+        pixels / 1.0e6 / std::max(seconds, 1.0e-9), ImageDiff::kernelName(kernel));
+    return errors ? 2 : failed ? 1 : 0;
+}
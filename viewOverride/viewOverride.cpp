@@ -3,7 +3,13 @@
 // Copyright     2020 Artineering and/or its licensors
 // License       MIT
 
+#include <cmath>
+#include <fstream>
+#include <algorithm>
 #include <maya/MGlobal.h>
+#include <maya/M3dView.h>
+#include <maya/MFnCamera.h>
+#include <maya/MUiMessage.h>
 #include <maya/MShaderManager.h>
 #include "viewOverride.h"
 #include "viewOverrideOperations.h"
@@ -24,8 +30,119 @@
 /// As it can be seen, transparent objects are not sorted according
 /// to depth, as opaque objects are. If the Scene Render is changed
 /// to only output to two textures, the transparent objects are 
-/// sorted correctly. To reproduce and test this, change line 51 in
-/// viewOverrideOperations.cpp
+/// sorted correctly. To reproduce and test this, change the layout
+/// of the scene render targets:
+/// viewOverride -mrt 0;  // color and depth
+/// viewOverride -mrt 1;  // color, depth and normals (default)
+/// viewOverride -mrt 2;  // color, depth, normals and two AOVs
+/// The cost of each layout can be compared on the GPU over N frames:
+/// viewOverride -ab 0 2 600;
+///
+/// By default, the opaque items are drawn to all targets of the
+/// layout and the transparent items by a second scene render to the
+/// color and depth targets only, where Maya still sorts them and they
+/// don't write (or pay the bandwidth of) the other targets. A single
+/// scene render drawing all items reproduces the sorting bug:
+/// viewOverride -sts false;
+///
+/// Alternatively, weighted blended order-independent transparency
+/// (OIT) can be enabled, which doesn't depend on sorting at all:
+/// viewOverride -oit true;
+/// The scene render then only draws opaque items and a transparent
+/// scene render accumulates into the accumulation (weighted color)
+/// and revealage (coverage) targets, which a quad composites over
+/// the color target. The transparent scene render draws with the
+/// oitAccumulate shader override, which sums the weighted
+/// premultiplied color into the accumulation target (One, One) and
+/// the coverage into the revealage target (One, InvSrcColor), bound
+/// by its draw callbacks. The override replaces the materials, so
+/// transparent items are drawn with a single color and opacity.
+///
+/// The operations are declared to a render graph together with the
+/// targets they read and write, which culls any operation whose
+/// outputs are never consumed before the present operation, e.g.,
+/// the debug quad while the color target is shown.
+///
+/// Each panel (destination) draws into its own set of render targets,
+/// which is only resized when that panel outgrows the size bucket of
+/// its targets and released once the panel is destroyed. Transient
+/// targets whose lifetimes don't overlap within the frame share the
+/// same allocation.
+///
+/// The normals target can be packed to reduce the bandwidth and memory
+/// of the scene render (materials need to write the same encoding):
+/// viewOverride -gb 0;  // RGBA32F xyz normals (default)
+/// viewOverride -gb 1;  // RG16F octahedral normals
+/// viewOverride -gb 2;  // RGBA8 normals * 0.5 + 0.5 and roughness
+/// The debug quad decodes the normals when showing the normals target.
+///
+/// All targets can be shown side by side by a single quad, with depth
+/// linearized and normals remapped to [0, 1]. The channel mask set with
+/// viewOverride -c applies to the active target in both views:
+/// viewOverride -tiles true;
+///
+/// GPU timestamps can be placed between the operations to show the
+/// GPU time of each operation in the HUD (a few frames delayed):
+/// viewOverride -gpu true;
+///
+/// Shaders of the quad operations can be reloaded as their files are
+/// saved, without stalling the viewport on file access and without
+/// losing the shader if an edit doesn't compile:
+/// viewOverride -hr true;
+///
+/// The HUD also keeps the last 1024 frame times to show percentiles
+/// and hitches, which can be exported to compare builds:
+/// viewOverride -stats "frameTimes.json";  // or .csv
+///
+/// The scene can be rendered at a lower resolution while the frame
+/// time exceeds a budget (in ms) and upscaled by a quad before the UI
+/// is drawn, returning to full resolution once the viewport is idle:
+/// viewOverride -drs 33.3;
+///
+/// Panels that are redrawn without any change to their camera, size,
+/// display style or the scene (e.g., background viewports) can reuse
+/// their last image, so that only the HUD and present operations run:
+/// viewOverride -fc true;
+///
+/// Instead of multisampling every frame, still frames can be refined
+/// by accumulating N scene renders with sub-pixel jittered projections:
+/// viewOverride -pa 16;
+///
+/// The color, depth and normals targets of the next frames can be
+/// written to disk without stalling the viewport, as they are copied
+/// and read back a few frames late and written on worker threads:
+/// viewOverride -cap "C:/captures/shot.exr" 100;  // or .png
+///
+/// A min/max depth pyramid (Hi-Z) can be built from the depth target
+/// by a chain of quads, each reducing 2x2 texels of the previous level,
+/// for screen-space effects to sample instead of the full depth:
+/// viewOverride -hiz true;
+///
+/// The layers drawn per pixel (all fragments, or the transparent
+/// layers in front of the opaque depth) can be counted by a scene
+/// render with an instrumentation shader and shown as a heatmap, with
+/// their mean, max and share above N layers reduced on the GPU:
+/// viewOverride -od 1 4;  // or 2 for transparent layers, 0 to stop
+///
+/// While only the camera moves, the scene renders can draw a reduced
+/// set of objects (e.g., proxies or low LODs), matched by name once
+/// and kept until the scene changes, and the full scene once the
+/// camera stopped:
+/// viewOverride -px "*_proxy";  // or "" to always draw all objects
+///
+/// If only a few shapes changed since a panel was drawn (e.g., one
+/// object being moved), the scene and UI are drawn again only within
+/// the screen rectangle of their bounds before and after the change,
+/// over the image of the last frame, unless the rectangle covers more
+/// than a fraction of the viewport:
+/// viewOverride -pr 0.25;  // or 0 to always redraw the whole viewport
+///
+/// To decide which operations are worth their cost, each operation
+/// of the current pipeline can be disabled in turn, and each G-buffer
+/// and MRT layout measured, over N frames each. The frame times of
+/// every configuration and their difference to the baseline are then
+/// written to a JSON report:
+/// viewOverride -pab "C:/ablation.json" 300;
 ///
 /////////////////////////////////////////////////////////////////////
 
@@ -63,53 +180,66 @@ viewOverride::viewOverride(const MString & name)
         }
     }
 
-    // initialize operations
-    for (unsigned int i = 0; i < renderOperations::kOperationCount; i++) {
-        mOperations[i] = nullptr;
-    }
-    cout << "Operations initialized" << endl;
-
-    // initialize render targets
+    // initialize render targets (declared to the graph in renderTargets order)
     unsigned int tWidth = 1;
     unsigned int tHeight = 1;
     int MSAA = 0;
     unsigned arraySliceCount = 1;
     bool isCubeMap = false;
-    mTargetDescriptions[renderTargets::kColor] = MHWRender::MRenderTargetDescription("colorTarget", tWidth, tHeight, MSAA, MHWRender::kR16G16B16A16_FLOAT, arraySliceCount, isCubeMap);
-    mTargetDescriptions[renderTargets::kDepth] = MHWRender::MRenderTargetDescription("depthTarget", tWidth, tHeight, MSAA, MHWRender::kD24S8, arraySliceCount, isCubeMap);
-    mTargetDescriptions[renderTargets::kNormals] = MHWRender::MRenderTargetDescription("normalsTarget", tWidth, tHeight, MSAA, MHWRender::kR32G32B32A32_FLOAT, arraySliceCount, isCubeMap);
-    // acquire render targets
-    MHWRender::MRenderer* theRenderer = MHWRender::MRenderer::theRenderer();
-    if (theRenderer) {
-        const MRenderTargetManager *targetManager = theRenderer->getRenderTargetManager();
-        if (targetManager) {
-            for (unsigned int i = 0; i < renderTargets::kTargetCount; i++) {
-                mTargets[i] = targetManager->acquireRenderTarget(mTargetDescriptions[i]);
-            }
+    bool transient = true;  // contents only needed within the frame, may share allocations
+    bool scaled = true;     // rendered at the dynamic resolution scale
+    mGraph.addTarget(MHWRender::MRenderTargetDescription("colorTarget", tWidth, tHeight, MSAA, MHWRender::kR16G16B16A16_FLOAT, arraySliceCount, isCubeMap), 1, !transient, scaled);
+    mGraph.addTarget(MHWRender::MRenderTargetDescription("depthTarget", tWidth, tHeight, MSAA, MHWRender::kD24S8, arraySliceCount, isCubeMap), 1, !transient, scaled);
+    mGraph.addTarget(MHWRender::MRenderTargetDescription("normalsTarget", tWidth, tHeight, MSAA, MHWRender::kR32G32B32A32_FLOAT, arraySliceCount, isCubeMap), 1, transient, scaled);
+    mGraph.addTarget(MHWRender::MRenderTargetDescription("oitAccumTarget", tWidth, tHeight, MSAA, MHWRender::kR16G16B16A16_FLOAT, arraySliceCount, isCubeMap), 1, transient, scaled);
+    mGraph.addTarget(MHWRender::MRenderTargetDescription("oitRevealageTarget", tWidth, tHeight, MSAA, MHWRender::kR16_FLOAT, arraySliceCount, isCubeMap), 1, transient, scaled);
+    mGraph.addTarget(MHWRender::MRenderTargetDescription("debugTilesTarget", tWidth, tHeight, MSAA, MHWRender::kR8G8B8A8_UNORM, arraySliceCount, isCubeMap), 1, !transient, scaled);
+    mGraph.addTarget(MHWRender::MRenderTargetDescription("aov0Target", tWidth, tHeight, MSAA, MHWRender::kR16G16B16A16_FLOAT, arraySliceCount, isCubeMap), 1, transient, scaled);
+    mGraph.addTarget(MHWRender::MRenderTargetDescription("aov1Target", tWidth, tHeight, MSAA, MHWRender::kR16G16B16A16_FLOAT, arraySliceCount, isCubeMap), 1, transient, scaled);
+    mGraph.addTarget(MHWRender::MRenderTargetDescription("upscaledColorTarget", tWidth, tHeight, MSAA, MHWRender::kR16G16B16A16_FLOAT, arraySliceCount, isCubeMap), 1, !transient, !scaled);
+    mGraph.addTarget(MHWRender::MRenderTargetDescription("upscaledDepthTarget", tWidth, tHeight, MSAA, MHWRender::kD24S8, arraySliceCount, isCubeMap), 1, !transient, !scaled);
+    mGraph.addTarget(MHWRender::MRenderTargetDescription("accumulationTarget", tWidth, tHeight, MSAA, MHWRender::kR32G32B32A32_FLOAT, arraySliceCount, isCubeMap), 1, !transient, scaled);
+    for (unsigned int i = 0; i < kDepthPyramidLevels; i++) {
+        MString name = "depthPyramid" + MString(std::to_string(i).c_str()) + "Target";
+        mGraph.addTarget(MHWRender::MRenderTargetDescription(name, tWidth, tHeight, MSAA, MHWRender::kR32G32_FLOAT, arraySliceCount, isCubeMap), 2u << i, transient, scaled);
+        mDepthPyramidPasses[i] = -1;
+        mDepthPyramidInputParameters[i] = -1;
+        mDepthPyramidSizeParameters[i] = -1;
+    }
+    mGraph.addTarget(MHWRender::MRenderTargetDescription("overdrawTarget", tWidth, tHeight, MSAA, MHWRender::kR32_FLOAT, arraySliceCount, isCubeMap), 1, transient, scaled);
+    mGraph.addTarget(MHWRender::MRenderTargetDescription("transparentLayersTarget", tWidth, tHeight, MSAA, MHWRender::kR32_FLOAT, arraySliceCount, isCubeMap), 1, transient, scaled);
+    mGraph.addTarget(MHWRender::MRenderTargetDescription("overdrawDepthTarget", tWidth, tHeight, MSAA, MHWRender::kD24S8, arraySliceCount, isCubeMap), 1, transient, scaled);
+    unsigned int statsDivisor = 1;
+    for (unsigned int i = 0; i < OverdrawStats::kLevels; i++) {
+        statsDivisor *= OverdrawStats::kReduction;
+        if (i + 1 < OverdrawStats::kLevels) {  // the last reduction writes into a staging target
+            MString name = "overdrawStats" + MString(std::to_string(i).c_str()) + "Target";
+            mGraph.addTarget(MHWRender::MRenderTargetDescription(name, tWidth, tHeight, MSAA, MHWRender::kR32G32B32A32_FLOAT, arraySliceCount, isCubeMap), statsDivisor, transient, scaled);
         }
+        mOverdrawStatsPasses[i] = -1;
+        mOverdrawStatsInputParameters[i] = -1;
+        mOverdrawStatsSizeParameters[i] = -1;
+    }
+    // render targets are acquired per panel in setup()
+
+    // show all channels of every target
+    for (unsigned int i = 0; i < renderTargets::kTargetCount; i++) {
+        mChannels.insert(mChannels.end(), { 1.0f, 1.0f, 1.0f, 0.0f });
+        mTileTexParameters[i] = -1;
+        mTileChannelsParameters[i] = -1;
     }
     cout << "Render targets initialized" << endl;
 }
 
-// On destruction all operations are deleted.
+// On destruction all operations are deleted (by the graph).
 viewOverride::~viewOverride() {
-    // get renderer and target manager
-    MHWRender::MRenderer* theRenderer = MHWRender::MRenderer::theRenderer();
-    const MHWRender::MRenderTargetManager* targetManager = theRenderer->getRenderTargetManager();
-    // delete operations
-	for (unsigned int i=0; i<renderOperations::kOperationCount; i++){
-		if (mOperations[i]) {
-			delete mOperations[i];
-			mOperations[i] = nullptr;
-		}
-	}
-    // delete targets
-    for (unsigned int i = 0; i < renderTargets::kTargetCount; i++) {
-        if (mTargets[i]) {
-            if (targetManager) {
-                targetManager->releaseRenderTarget(mTargets[i]);
-            }
-        }
+    mShaderWatcher.stop();
+    mCapture.stop();
+    mCapture.release(mTargetPool);
+    mOverdrawStats.release(mTargetPool);
+    // delete targets of all panels
+    while (!mTargetSets.empty()) {
+        mReleaseTargetSet(mTargetSets.begin()->second);
     }
 }
 	
@@ -126,33 +256,92 @@ MHWRender::DrawAPI viewOverride::supportedDrawAPIs() const {
 // - renderOperation() : will be called to return the current operation
 // - nextRenderOperation() : when this returns false we've returned all operations
 //
+// The operations are the compiled (culled) passes of the render graph,
+// preceded by timestamp operations when the GPU profiler is enabled
+//
 bool viewOverride::startOperationIterator() {
 	mCurrentOperation = 0;
-	return true;
+	return !mOperationList.empty();
 }
 
 MHWRender::MRenderOperation*
 viewOverride::renderOperation() {
-	if (mCurrentOperation >= 0 && mCurrentOperation < renderOperations::kOperationCount) {
-		if (mOperations[mCurrentOperation]) {
-			return mOperations[mCurrentOperation];
-		}
+	if (mCurrentOperation >= 0 && mCurrentOperation < (int)mOperationList.size()) {
+		return mOperationList[mCurrentOperation];
 	}
 	return NULL;
 }
 
 bool viewOverride::nextRenderOperation() {
 	mCurrentOperation++;
-	if (mCurrentOperation < renderOperations::kOperationCount) {
+	if (mCurrentOperation < (int)mOperationList.size()) {
 		return true;
 	}
 	return false;
 }
 
 void viewOverride::resetShaderInstances() {
-    for (unsigned i = 0; i < renderOperations::kOperationCount; i++) {
-        if (mOperations[i]->operationType() == MRenderOperation::kQuadRender) {
-            static_cast<QuadRender*>(mOperations[i])->clearShaderInstance();
+    for (unsigned i = 0; i < mGraph.passCount(); i++) {
+        MHWRender::MRenderOperation *operation = mGraph.operation(i);
+        if (operation && operation->operationType() == MRenderOperation::kQuadRender) {
+            static_cast<QuadRender*>(operation)->clearShaderInstance();
+        } else if (operation && operation->operationType() == MRenderOperation::kSceneRender) {
+            static_cast<SceneRender*>(operation)->clearShaderInstance();
+        }
+    }
+    invalidateFrameCache();
+}
+
+void viewOverride::enableShaderReload(bool enable) {
+    if (!enable) {
+        mShaderWatcher.stop();
+        return;
+    }
+    if (mGraph.passCount() == 0) {
+        mBuildGraph();
+    }
+    // watch the effects of all quad operations and scene shader overrides
+    std::vector<std::string> effects;
+    for (unsigned int i = 0; i < mGraph.passCount(); i++) {
+        MHWRender::MRenderOperation *operation = mGraph.operation(i);
+        if (operation && operation->operationType() == MRenderOperation::kQuadRender) {
+            effects.push_back(static_cast<QuadRender*>(operation)->shaderFileName().asChar());
+        } else if (operation && operation->operationType() == MRenderOperation::kSceneRender) {
+            const MString &effect = static_cast<SceneRender*>(operation)->shaderFileName();
+            if (effect.length() > 0) {
+                effects.push_back(effect.asChar());
+            }
+        }
+    }
+    MString shaderPath = mEnvironment + "shaders/";
+    mShaderWatcher.start(shaderPath.asChar(), effects);
+    cout << "Watching shaders in: " << shaderPath << endl;
+}
+
+// Compiles the sources of the effects that changed on disk (validated by the watcher thread)
+void viewOverride::mReloadShaders() {
+    std::vector<ShaderSource> sources;
+    mShaderWatcher.collect(sources);
+    bool openGL = MHWRender::MRenderer::theRenderer()->drawAPIIsOpenGL();
+    for (unsigned int s = 0; s < sources.size(); s++) {
+        const ShaderSource &source = sources[s];
+        if ((source.extension == ".ogsfx") != openGL) {
+            continue;  // effect of the other draw API
+        }
+        if (!source.error.empty()) {
+            cerr << "Shader not reloaded, " << source.error.c_str() << endl;
+            continue;
+        }
+        for (unsigned int i = 0; i < mGraph.passCount(); i++) {
+            MHWRender::MRenderOperation *operation = mGraph.operation(i);
+            if (operation && operation->operationType() == MRenderOperation::kQuadRender) {
+                QuadRender *quadOp = static_cast<QuadRender*>(operation);
+                if (source.effect == quadOp->shaderFileName().asChar()
+                    && quadOp->reloadShader(source.buffer.c_str(), (unsigned int)source.buffer.size())) {
+                    cout << "Shader reloaded: " << quadOp->shaderFileName() << endl;
+                    invalidateFrameCache();
+                }
+            }
         }
     }
 }
@@ -163,108 +352,850 @@ void viewOverride::changeActiveTarget(unsigned int targetIdx) {
     }
 }
 
+// Sets the channel mask of the active target
 void viewOverride::showChannels(bool r, bool g, bool b, bool a) {
+    float *channels = &mChannels[mActiveTarget * 4];
+    channels[0] = r ? 1.0f : 0.0f;
+    channels[1] = g ? 1.0f : 0.0f;
+    channels[2] = b ? 1.0f : 0.0f;
+    channels[3] = a ? 1.0f : 0.0f;
+}
+
+// Index of the debug quad permutation: visualization (color, depth, normals in each layout) * 2 + alpha only
+unsigned int viewOverride::mDebugMode() const {
+    unsigned int visualization = 0;
+    if (mActiveTarget == renderTargets::kDepth) {
+        visualization = 1;
+    } else if (mActiveTarget == renderTargets::kNormals) {
+        visualization = 2 + mGBufferLayout;
+    }
+    bool alphaOnly = mChannels[mActiveTarget * 4 + 3] > 0.0f;
+    return visualization * 2 + (alphaOnly ? 1 : 0);
+}
+
+void viewOverride::showTiles(bool enable) {
+    mTilesShown = enable;
+}
+
+void viewOverride::enableOIT(bool enable) {
+    mOITEnabled = enable;
+}
+
+void viewOverride::enableSplitTransparency(bool enable) {
+    mSplitTransparency = enable;
+}
+
+void viewOverride::setGBufferLayout(unsigned int layout) {
+    if (layout < gBufferLayouts::kLayoutCount) {
+        mGBufferLayout = layout;
+    }
+}
+
+void viewOverride::setSceneLayout(unsigned int layout) {
+    if (layout < sceneLayouts::kSceneLayoutCount) {
+        mSceneLayout = layout;
+    }
+}
+
+// The layouts alternate every frame and the GPU profiler tags the timings with the layout
+// they were rendered with, so the scene needs to be redrawn continuously (e.g., playback)
+void viewOverride::compareSceneLayouts(unsigned int layoutA, unsigned int layoutB, unsigned int frames) {
+    if (layoutA >= sceneLayouts::kSceneLayoutCount || layoutB >= sceneLayouts::kSceneLayoutCount) {
+        return;
+    }
+    if (mAblation.running()) {
+        cerr << "Scene layout comparison: a pass ablation benchmark is running" << endl;
+        return;
+    }
+    if (!mLayoutTest.running()) {
+        mTestProfiler = mGPUProfiler.enabled();
+    }
+    mTestLayouts[0] = layoutA;
+    mTestLayouts[1] = layoutB;
+    mGPUProfiler.setEnabled(true);
+    mLayoutTest.start(frames);
+}
+
+void viewOverride::mFinishLayoutComparison() {
+    enableGPUProfiler(mTestProfiler);
+    ABSummary summary = mLayoutTest.summary();
+    if (!summary.frames[0] || !summary.frames[1]) {
+        cerr << "Scene layout comparison: no GPU timings were collected" << endl;
+        return;
+    }
+    double difference = summary.sceneTime[1] - summary.sceneTime[0];
+    double percentage = (summary.sceneTime[0] > 0.0) ? 100.0 * difference / summary.sceneTime[0] : 0.0;
+    char buffer[200];
+    sprintf(buffer, "Scene layout %u: %.3f ms (%u frames), layout %u: %.3f ms (%u frames), difference %+.3f ms (%+.1f%%), all operations %+.3f ms",
+        mTestLayouts[0], summary.sceneTime[0], summary.frames[0], mTestLayouts[1], summary.sceneTime[1], summary.frames[1],
+        difference, percentage, summary.frameTime[1] - summary.frameTime[0]);
+    cout << buffer << endl;
+}
+
+// The configurations are measured one after the other over consecutive frames, so the viewport
+// is redrawn continuously until the report is written. The operations are the ones compiled by
+// the last frame (e.g., with OIT or the depth pyramid if they are enabled), except for roots.
+MStatus viewOverride::benchmarkAblations(const std::string &path, unsigned int frames) {
+    if (mAblation.running()) {
+        mAblation.stop();
+        mAblationPath.clear();  // stopped or restarted, no report
+        mFinishAblation();
+    }
+    if (frames == 0) {
+        return MStatus::kSuccess;
+    }
+    if (mLayoutTest.running()) {
+        cerr << "Pass ablation: a scene layout comparison is running" << endl;
+        return MStatus::kFailure;
+    }
+    if (mGraph.compiledPasses().empty()) {
+        cerr << "Pass ablation: no frame was drawn with the override yet" << endl;
+        return MStatus::kFailure;
+    }
+    if (!std::ofstream(path.c_str())) {
+        cerr << "Pass ablation: couldn't write " << path << endl;
+        return MStatus::kFailure;
+    }
+    std::vector<AblationConfig> configs;
+    AblationConfig baseline;
+    baseline.name = "baseline";
+    baseline.gBufferLayout = mGBufferLayout;
+    baseline.sceneLayout = mSceneLayout;
+    configs.push_back(baseline);
+    const std::vector<int> &passes = mGraph.compiledPasses();
+    for (unsigned int i = 0; i < passes.size(); i++) {
+        if (!mGraph.pass(passes[i]).root) {
+            AblationConfig config = baseline;
+            config.name = std::string("disable ") + mGraph.operation(passes[i])->name().asChar();
+            config.disabledPass = passes[i];
+            configs.push_back(config);
+        }
+    }
+    for (unsigned int layout = 0; layout < gBufferLayouts::kLayoutCount; layout++) {
+        if (layout != mGBufferLayout) {
+            AblationConfig config = baseline;
+            config.name = "gBufferLayout " + std::to_string(layout);
+            config.gBufferLayout = layout;
+            configs.push_back(config);
+        }
+    }
+    for (unsigned int layout = 0; layout < sceneLayouts::kSceneLayoutCount; layout++) {
+        if (layout != mSceneLayout) {
+            AblationConfig config = baseline;
+            config.name = "mrtLayout " + std::to_string(layout);
+            config.sceneLayout = layout;
+            configs.push_back(config);
+        }
+    }
+    mAblationLayouts[0] = mGBufferLayout;
+    mAblationLayouts[1] = mSceneLayout;
+    mAblationProfiler = mGPUProfiler.enabled();
+    mGPUProfiler.setEnabled(true);
+    mAblationPath = path;
+    mAblationConfig = -1;
+    mAblation.start(configs, frames);
+    cout << "Pass ablation: " << configs.size() << " configurations of " << frames << " frames" << endl;
+    return MStatus::kSuccess;
+}
+
+// Times the last issued frame from setup to setup, restores what its configuration changed and
+// applies the configuration of this frame (the disabled pass is applied before the graph compiles)
+int viewOverride::mStepAblation() {
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    if (mAblationConfig >= 0) {
+        mAblation.recordCPU(mAblationConfig, std::chrono::duration<float, std::milli>(now - mAblationTime).count());
+    }
+    mAblationTime = now;
+    if (mAblationPass >= 0) {
+        mGraph.setEnabled(mAblationPass, mAblationPassEnabled);
+        mAblationPass = -1;
+    }
+    mAblationConfig = mAblation.nextConfig();
+    const AblationConfig *config = (mAblationConfig >= 0) ? &mAblation.results()[mAblationConfig].config : nullptr;
+    mGBufferLayout = config ? config->gBufferLayout : mAblationLayouts[0];
+    mSceneLayout = config ? config->sceneLayout : mAblationLayouts[1];
+    return mAblationConfig;
+}
+
+void viewOverride::mFinishAblation() {
+    if (mAblationPass >= 0) {
+        mGraph.setEnabled(mAblationPass, mAblationPassEnabled);
+        mAblationPass = -1;
+    }
+    mAblationConfig = -1;
+    mGBufferLayout = mAblationLayouts[0];
+    mSceneLayout = mAblationLayouts[1];
+    enableGPUProfiler(mAblationProfiler);
+    if (mAblationPath.empty()) {
+        return;
+    }
+    const std::vector<AblationResult> &results = mAblation.results();
+    float baseline = results.empty() ? 0.0f : results[0].cpu.summary().mean;
+    for (unsigned int i = 0; i < results.size(); i++) {
+        FrameTimeSummary stats = results[i].cpu.summary();
+        char buffer[200];
+        sprintf(buffer, "Pass ablation %s: %.3f ms (%+.3f ms), p95 %.3f ms, %u frames",
+            results[i].config.name.c_str(), stats.mean, stats.mean - baseline, stats.p95, stats.count);
+        cout << buffer << endl;
+    }
+    if (!mAblation.writeReport(mAblationPath)) {
+        cerr << "Pass ablation: couldn't write " << mAblationPath << endl;
+    }
+    mAblationPath.clear();
+}
+
+void viewOverride::setResolutionBudget(float milliseconds) {
+    mScaler.setBudget(milliseconds);
+    mScaledFrame = mFrameStats.frames();  // only adapt to frames drawn with the new budget
+}
+
+void viewOverride::enableFrameCache(bool enable) {
+    mFrameCacheEnabled = enable;
+    mUpdateSceneWatcher();
+}
+
+void viewOverride::setProgressiveSamples(unsigned int samples) {
+    mProgressiveSamples = std::min(samples, kMaxProgressiveSamples);
+    mUpdateSceneWatcher();
+}
+
+void viewOverride::setProxyObjects(const MStringArray &objects) {
+    mProxyPatterns = objects;
+    mProxySet.clear();
+    mProxyVersion = 0;  // matched on the next navigation
+    mUpdateSceneWatcher();
+}
+
+// Objects matching the proxy patterns, matched again only once the scene changed (e.g., nodes added)
+const MSelectionList* viewOverride::mUpdateProxySet() {
+    if (mProxyVersion != mSceneWatcher.version()) {
+        mProxySet.clear();
+        for (unsigned int i = 0; i < mProxyPatterns.length(); i++) {
+            mProxySet.add(mProxyPatterns[i]);  // patterns without a match add nothing
+        }
+        mProxyVersion = mSceneWatcher.version();
+    }
+    return mProxySet.isEmpty() ? nullptr : &mProxySet;
+}
+
+void viewOverride::setPartialRedraw(float areaThreshold) {
+    mPartialThreshold = std::max(0.0f, std::min(areaThreshold, 1.0f));
+    mUpdateSceneWatcher();
+}
+
+void viewOverride::enableDepthPyramid(bool enable) {
+    mDepthPyramidEnabled = enable;
+}
+
+// Number of levels halving width x height (rounded up) down to a single texel
+unsigned int viewOverride::sDepthPyramidLevels(unsigned int width, unsigned int height) {
+    unsigned int levels = 0;
+    while ((width > 1 || height > 1) && levels < kDepthPyramidLevels) {
+        width = (width + 1) / 2;
+        height = (height + 1) / 2;
+        levels++;
+    }
+    return levels;
+}
+
+void viewOverride::setOverdrawMode(unsigned int mode, unsigned int threshold) {
+    mOverdrawMode = std::min(mode, (unsigned int)overdrawModes::kOverdrawModeCount - 1);
+    mOverdrawThreshold = threshold;
+    if (mOverdrawMode == overdrawModes::kOverdrawOff) {
+        mOverdrawStats.release(mTargetPool);
+        if (mHUDPass >= 0) {
+            ((HUDOperation*)mGraph.operation(mHUDPass))->setOverdrawStats(MString());
+        }
+    }
+    invalidateFrameCache();
+}
+
+// Sizes and GPU times of the levels built by the last frame as "name widthxheight time" (in milliseconds)
+void viewOverride::depthPyramidTimes(MStringArray &levelTimes) {
+    levelTimes.clear();
+    for (unsigned int i = 0; i < mDepthPyramidLevelCount; i++) {
+        char buffer[64];
+        sprintf(buffer, " %ux%u", mDepthPyramidSizes[i + 1][0], mDepthPyramidSizes[i + 1][1]);
+        MString levelTime = mGraph.operation(mDepthPyramidPasses[i])->name() + buffer;
+        double time = mGPUProfiler.passTime(mDepthPyramidPasses[i]);
+        if (time >= 0.0) {
+            sprintf(buffer, " %.3f", time);
+            levelTime += buffer;
+        }
+        levelTimes.append(levelTime);
+    }
+}
+
+MStatus viewOverride::captureFrames(const std::string &path, unsigned int frames) {
+    std::string error;
+    if (!mCapture.start(path, frames, error)) {
+        cerr << "Frames not captured, " << error.c_str() << endl;
+        return MStatus::kFailure;
+    }
+    if (!mCapture.active()) {
+        mCapture.release(mTargetPool);
+    }
+    return MStatus::kSuccess;
+}
+
+// The scene is only watched while still frames are detected, i.e., to cache or refine them,
+// to tell camera navigation from scene changes (proxy objects) or to locate changes (partial redraw)
+void viewOverride::mUpdateSceneWatcher() {
+    if (mFrameCacheEnabled || mProgressiveSamples > 0 || mProxyPatterns.length() > 0 || mPartialThreshold > 0.0f) {
+        mSceneWatcher.start();
+    } else {
+        mSceneWatcher.stop();
+    }
+}
+
+// Radical inverse of the index in the base (Halton sequence), in [0, 1)
+double viewOverride::sHalton(unsigned int index, unsigned int base) {
+    double result = 0.0;
+    double fraction = 1.0 / base;
+    while (index > 0) {
+        result += fraction * (index % base);
+        index /= base;
+        fraction /= base;
+    }
+    return result;
+}
+
+void viewOverride::enableGPUProfiler(bool enable) {
+    mGPUProfiler.setEnabled(enable);
+    if (!enable && mHUDPass >= 0) {
+        ((HUDOperation*)mGraph.operation(mHUDPass))->setPassTimes(MStringArray());
+    }
+}
+
+// GPU times of the compiled passes as "name time" (in milliseconds)
+void viewOverride::gpuPassTimes(MStringArray &passTimes) {
+    passTimes.clear();
+    const std::vector<int> &passes = mGraph.compiledPasses();
+    for (unsigned int i = 0; i < passes.size(); i++) {
+        double time = mGPUProfiler.passTime(passes[i]);
+        if (time >= 0.0) {
+            char buffer[32];
+            sprintf(buffer, " %.3f", time);
+            passTimes.append(mGraph.operation(passes[i])->name() + buffer);
+        }
+    }
+}
+
+
+// Acquires a new set of render targets for the given destination (panel)
+viewOverride::TargetSet* viewOverride::mAcquireTargetSet(const MString &destination) {
+    TargetSet *targetSet = new TargetSet();
+    targetSet->override = this;
+    targetSet->destination = destination.asChar();
+    // release the targets when the panel goes away (offscreen destinations have no panel)
+    MStatus status;
+    targetSet->panelCallback = MUiMessage::add3dViewDestroyMsgCallback(destination, sPanelDestroyed, targetSet, &status);
+    targetSet->hasPanelCallback = (status == MS::kSuccess);
+    mTargetSets[targetSet->destination] = targetSet;
+    cout << "Render targets acquired for: " << destination << endl;
+    return targetSet;
+}
+
+// Releases the render targets of a destination (panel)
+void viewOverride::mReleaseTargetSet(TargetSet *targetSet) {
+    if (targetSet->hasPanelCallback) {
+        MMessage::removeCallback(targetSet->panelCallback);
+    }
+    for (unsigned int i = 0; i < targetSet->pooled.size(); i++) {
+        mTargetPool.release(targetSet->pooled[i]);
+    }
+    if (mCapture.destination() == targetSet->destination) {
+        mCapture.stop();  // the panel won't be drawn again to read back its captures
+        mCapture.release(mTargetPool);
+    }
+    if (mTargets == targetSet->targets.data()) {
+        mTargets = nullptr;
+        mViewportRect = nullptr;
+        mScaledRect = nullptr;
+    }
+    mTargetSets.erase(targetSet->destination);
+    delete targetSet;
+}
+
+void viewOverride::sPanelDestroyed(void *clientData) {
+    TargetSet *targetSet = static_cast<TargetSet*>(clientData);
+    cout << "Render targets released for: " << targetSet->destination.c_str() << endl;
+    targetSet->override->mReleaseTargetSet(targetSet);
+}
+
+// Returns the render targets of the destination (panel), acquiring them for new panels
+viewOverride::TargetSet* viewOverride::mFindTargetSet(const MString &destination) {
+    std::map<std::string, TargetSet*>::iterator it = mTargetSets.find(destination.asChar());
+    if (it != mTargetSets.end()) {
+        return it->second;
+    }
+    return mAcquireTargetSet(destination);
+}
 
+// Checks if the scene, camera, viewport and display style didn't change since the panel was
+// last drawn, in which case its targets still hold (a lower quality version of) this frame
+bool viewOverride::mUnchanged(TargetSet *targetSet, bool &sceneChanged, bool &viewChanged) {
+    sceneChanged = true;
+    viewChanged = true;
+    if (!mSceneWatcher.running() || mLayoutTest.running() || mAblation.running()) {
+        targetSet->cacheValid = false;  // comparisons need every frame to be drawn
+        return false;
+    }
+    const MFrameContext *frameContext = this->getFrameContext();
+    FrameKey key;
+    key.version = mSceneWatcher.version();
+    key.viewProjection = frameContext->getMatrix(MHWRender::MFrameContext::kViewProjMtx);
+    frameContext->getViewportDimensions(key.viewport[0], key.viewport[1], key.viewport[2], key.viewport[3]);
+    key.displayStyle = frameContext->getDisplayStyle();
+    bool unchanged = targetSet->cacheValid && (key == targetSet->cacheKey);
+    sceneChanged = !targetSet->cacheValid || (key.version != targetSet->cacheKey.version);
+    viewChanged = !targetSet->cacheValid || !key.sameView(targetSet->cacheKey);
+    targetSet->drawnVersion = targetSet->cacheValid ? targetSet->cacheKey.version : 0;
+    targetSet->cacheKey = key;
+    targetSet->cacheValid = true;  // drawn by this frame otherwise
+    return unchanged;
 }
 
+// Screen rectangle of the shapes that changed since the panel was drawn, where they were and where
+// they are, false if anything else changed or a shape can't be projected. The bounds of the changed
+// shapes are kept as drawn, a shape changing for the first time can't be located where it was.
+bool viewOverride::mDirtyRegion(TargetSet *targetSet, const MMatrix &viewProjection, int width, int height, DirtyRect &rect) {
+    rect = DirtyRect();
+    std::vector<MObjectHandle> shapes;
+    bool localized = mSceneWatcher.dirtyShapes(targetSet->drawnVersion, shapes);
+    for (const MObjectHandle &shape : shapes) {
+        MBoundingBox bounds;
+        bool known = DirtyRegion::worldBounds(shape, bounds);
+        std::map<unsigned int, MBoundingBox>::iterator drawn = targetSet->drawnBounds.find(shape.hashCode());
+        DirtyRect before, after;
+        localized = localized && known && (drawn != targetSet->drawnBounds.end())
+            && DirtyRegion::project(drawn->second, viewProjection, width, height, before)
+            && DirtyRegion::project(bounds, viewProjection, width, height, after);
+        rect.merge(before);
+        rect.merge(after);
+        if (known) {
+            targetSet->drawnBounds[shape.hashCode()] = bounds;
+        } else if (drawn != targetSet->drawnBounds.end()) {
+            targetSet->drawnBounds.erase(drawn);
+        }
+    }
+    rect.pad(DirtyRegion::kPadding, width, height);
+    return localized;
+}
 
-// Updates the render targets based on the current frame context (viewport)
-MStatus viewOverride::mUpdateRenderTargets(){
+// Updates the render targets of the destination based on the current frame context (viewport)
+// The target pool only reallocates targets that outgrow their size bucket (or shrink after a
+// cooldown), so each panel keeps its own allocations and renders into a sub-rectangle of them.
+// Cached frames keep the allocations untouched, as they present their contents.
+MStatus viewOverride::mUpdateRenderTargets(TargetSet *targetSet){
     const MFrameContext *frameContext = this->getFrameContext();
     
     int x, y, width, height;
     frameContext->getViewportDimensions(x, y, width, height);
-    for (unsigned int i = 0; i < renderTargets::kTargetCount; i++) {
-        mTargetDescriptions[i].setWidth(width);
-        mTargetDescriptions[i].setHeight(height);
-        mTargets[i]->updateDescription(mTargetDescriptions[i]);
+
+    // acquire targets declared since the set was created
+    for (unsigned int i = (unsigned int)targetSet->pooled.size(); i < mGraph.targetCount(); i++) {
+        MHWRender::MRenderTargetDescription description = mGraph.target(i).description;
+        description.setName(description.name() + "_" + MString(targetSet->destination.c_str()));
+        targetSet->pooled.push_back(PooledTarget());
+        mTargetPool.acquire(targetSet->pooled[i], description);
+        targetSet->targets.push_back(targetSet->pooled[i].target);
     }
 
+    // scaled targets are sized to the scaled viewport (dynamic resolution, see setup())
+    mNaiveBytes = 0;
+    mAliasedBytes = 0;
+    for (unsigned int i = 0; i < mGraph.targetCount(); i++) {
+        // targets not used by the compiled graph, or aliased to another target, are kept minimal
+        const GraphTarget &target = mGraph.target(i);
+        bool used = mGraph.targetUsed(i);
+        bool allocated = used && (mGraph.alias(i) == (int)i);
+        unsigned int viewWidth = target.scaled ? mScaledWidth : (unsigned int)width;
+        unsigned int viewHeight = target.scaled ? mScaledHeight : (unsigned int)height;
+        unsigned int tWidth = allocated ? (viewWidth + target.sizeDivisor - 1) / target.sizeDivisor : 1;
+        unsigned int tHeight = allocated ? (viewHeight + target.sizeDivisor - 1) / target.sizeDivisor : 1;
+        if (!mFrameCached) {
+            mTargetPool.setFormat(targetSet->pooled[i], target.description.rasterFormat());
+            mTargetPool.fit(targetSet->pooled[i], tWidth, tHeight);
+        }
+    }
+    for (unsigned int i = 0; i < mGraph.targetCount(); i++) {
+        const PooledTarget &pooled = targetSet->pooled[mGraph.alias(i)];
+        targetSet->targets[i] = pooled.target;
+        if (mGraph.targetUsed(i)) {
+            mNaiveBytes += TargetPool::bytes(pooled.description);
+            mAliasedBytes += (mGraph.alias(i) == (int)i) ? TargetPool::bytes(pooled.description) : 0;
+        }
+    }
+    mTargets = targetSet->targets.data();
+
+    // render into the requested sub-rectangle of the bucketed targets
+    const MHWRender::MRenderTargetDescription &colorDescription = targetSet->pooled[renderTargets::kColor].description;
+    const MHWRender::MRenderTargetDescription &fullDescription = mScaling ?
+        targetSet->pooled[mGraph.alias(renderTargets::kUpscaledColor)].description : colorDescription;
+    mViewportRect = sSubRectangle(fullDescription, width, height, targetSet->viewportRect);
+    mScaledRect = sSubRectangle(colorDescription, mScaledWidth, mScaledHeight, targetSet->scaledRect);
+
+    // the upscale quad maps viewport pixels to the scaled sub-rectangle
+    mScaleParams[0] = (float)mScaledWidth / (float)width;
+    mScaleParams[1] = (float)mScaledHeight / (float)height;
+    mScaleParams[2] = 1.0f / (float)colorDescription.width();
+    mScaleParams[3] = 1.0f / (float)colorDescription.height();
+    mSourceSize[0] = (float)mScaledWidth;
+    mSourceSize[1] = (float)mScaledHeight;
+
     return MS::kSuccess;
 }
 
-// setup() runs every frame and we can make sure that the rendering
-// pipeline is properly set up and ready for rendering
+// Normalized sub-rectangle of a bucketed target covering width x height pixels (nullptr if all of it)
+const MFloatPoint* viewOverride::sSubRectangle(const MHWRender::MRenderTargetDescription &description,
+    unsigned int width, unsigned int height, MFloatPoint &rect) {
+    if (description.width() == width && description.height() == height) {
+        return nullptr;
+    }
+    rect = MFloatPoint(0.0f, 0.0f, (float)width / (float)description.width(), (float)height / (float)description.height());
+    return &rect;
+}
+
+// Declares the operations to the render graph with the targets they write (outputs)
+// and read or draw over (inputs). The graph assigns the targets to the operations.
 //
-//	- One scene render operation to draw the scene.
+//  - One quad operator to clear the rectangle of a partial redraw (optional)
+//	- One scene render operation to draw the scene (the opaque items if transparency is split)
+//  - One scene render operation to draw the transparent items to color and depth (optional)
+//  - One scene render and quad operation for order-independent transparency (optional)
+//  - One quad operator per level of the min/max depth pyramid (optional)
+//  - Two scene render and six quad operators to count, reduce and show overdraw (optional)
+//  - Two quad operators to accumulate jittered frames and copy back the result (optional)
+//  - Three quad operators to copy the scene targets into staging targets (capture)
 //  - One quad operator to debug the scene render targets
+//  - One quad operator to show all targets side by side (optional)
+//  - One quad operator to upscale the scene to the viewport (dynamic resolution)
 //	- One HUD render operation to draw the HUD over the scene
 //	- One presentation operation to be able to see the results in the viewport
+MStatus viewOverride::mBuildGraph() {
+    cout << "Defining render operations" << endl;
+    // Partial Clear Operation (color and depth within the redrawn rectangle, kept everywhere else)
+    QuadRender *quadOp = new QuadRender("viewOverride_Partial_Clear", "quadClear", "clear");
+    MHWRender::MDepthStencilStateDesc clearDepthDesc;
+    clearDepthDesc.depthEnable = true;
+    clearDepthDesc.depthWriteEnable = true;
+    clearDepthDesc.depthFunc = MHWRender::MStateManager::kCompareAlways;
+    quadOp->setDepthStencilState(clearDepthDesc);
+    mPartialClearPass = mGraph.addPass(quadOp,
+        { renderTargets::kColor, renderTargets::kDepth },
+        { renderTargets::kColor, renderTargets::kDepth });
+    mGraph.setEnabled(mPartialClearPass, false);
+    // Scene Operations
+    SceneRender *sceneOp = new SceneRender("viewOverride_Scene",
+        MHWRender::MSceneRender::kRenderShadedItems,
+        MHWRender::MClearOperation::kClearAll);
+    mScenePass = mGraph.addPass(sceneOp,
+        { renderTargets::kColor, renderTargets::kDepth, renderTargets::kNormals }, {});
+    // Transparent Scene Operation (transparent items over the opaque ones, two targets are sorted correctly)
+    sceneOp = new SceneRender("viewOverride_Scene_Transparent",
+        MHWRender::MSceneRender::kRenderTransparentShadedItems,
+        MHWRender::MClearOperation::kClearNone);
+    sceneOp->setTargetCount(2);
+    mTransparentScenePass = mGraph.addPass(sceneOp,
+        { renderTargets::kColor, renderTargets::kDepth },
+        { renderTargets::kColor, renderTargets::kDepth });
+    // OIT Scene Operation (transparent items only, keeps the opaque depth)
+    sceneOp = new SceneRender("viewOverride_OIT_Scene",
+        MHWRender::MSceneRender::kRenderTransparentShadedItems,
+        MHWRender::MClearOperation::kClearColor);
+    // weighted color summed into the accumulation target, coverage into the revealage target
+    sceneOp->setShaderOverride("oitAccumulate", "accumulate");
+    MHWRender::MBlendStateDesc accumulateBlend;
+    accumulateBlend.independentBlendEnable = true;
+    for (unsigned int i = 0; i < 2; i++) {
+        accumulateBlend.targetBlends[i].blendEnable = true;
+        accumulateBlend.targetBlends[i].sourceBlend = MHWRender::MBlendState::kOne;
+        accumulateBlend.targetBlends[i].destinationBlend = (i == 0) ? MHWRender::MBlendState::kOne : MHWRender::MBlendState::kInvSourceColor;
+        accumulateBlend.targetBlends[i].alphaSourceBlend = MHWRender::MBlendState::kOne;
+        accumulateBlend.targetBlends[i].alphaDestinationBlend = (i == 0) ? MHWRender::MBlendState::kOne : MHWRender::MBlendState::kInvSourceAlpha;
+    }
+    sceneOp->setBlendState(accumulateBlend);
+    mOITScenePass = mGraph.addPass(sceneOp,
+        { renderTargets::kOITAccum, renderTargets::kDepth, renderTargets::kOITRevealage }, {});
+    mGraph.setReadOnly(mOITScenePass, { renderTargets::kDepth });
+    // OIT Composite Operation (premultiplied over the color target)
+    quadOp = new QuadRender("viewOverride_OIT_Composite", "oitComposite", "composite");
+    MHWRender::MBlendStateDesc blendDesc;
+    blendDesc.targetBlends[0].blendEnable = true;
+    blendDesc.targetBlends[0].sourceBlend = MHWRender::MBlendState::kOne;
+    blendDesc.targetBlends[0].destinationBlend = MHWRender::MBlendState::kInvSourceAlpha;
+    blendDesc.targetBlends[0].alphaSourceBlend = MHWRender::MBlendState::kOne;
+    blendDesc.targetBlends[0].alphaDestinationBlend = MHWRender::MBlendState::kInvSourceAlpha;
+    quadOp->setBlendState(blendDesc);
+    mAccumTexParameter = quadOp->addParameter("gAccumTex", QuadParameter::kTarget);
+    mRevealageTexParameter = quadOp->addParameter("gRevealageTex", QuadParameter::kTarget);
+    mOITCompositePass = mGraph.addPass(quadOp,
+        { renderTargets::kColor },
+        { renderTargets::kColor, renderTargets::kOITAccum, renderTargets::kOITRevealage });
+    // Depth Pyramid Operations (min/max of 2x2 texels of the depth, then of the previous level)
+    for (unsigned int i = 0; i < kDepthPyramidLevels; i++) {
+        quadOp = new QuadRender("viewOverride_HiZ_" + MString(std::to_string(i).c_str()), "quadHiZ", "reduce");
+        if (i == 0) {
+            quadOp->setPermutation(quadOp->addPermutation({ { "DEPTH_SOURCE", "1" } }));
+        }
+        mDepthPyramidInputParameters[i] = quadOp->addParameter("gInputTex", QuadParameter::kTarget);
+        mDepthPyramidSizeParameters[i] = quadOp->addParameter("gSourceSize", QuadParameter::kFloat4);
+        int source = (i == 0) ? (int)renderTargets::kDepth : (int)renderTargets::kDepthPyramid + (int)i - 1;
+        mDepthPyramidPasses[i] = mGraph.addPass(quadOp, { (int)renderTargets::kDepthPyramid + (int)i }, { source }, true);
+        mGraph.setEnabled(mDepthPyramidPasses[i], false);
+    }
+    // Overdraw Operations (layers counted by halving a target cleared to 1, see viewOverrideOverdraw.cpp)
+    const float overdrawClear[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
+    sceneOp = new SceneRender("viewOverride_Overdraw",
+        MHWRender::MSceneRender::kRenderShadedItems,
+        MHWRender::MClearOperation::kClearAll);
+    sceneOp->setShaderOverride("overdraw", "count");
+    sceneOp->setClearColor(overdrawClear);
+    sceneOp->setTargetCount(2);
+    mOverdrawPass = mGraph.addPass(sceneOp, { renderTargets::kOverdraw, renderTargets::kOverdrawDepth }, {});
+    mGraph.setEnabled(mOverdrawPass, false);
+    // transparent items only, behind the opaque depth of the scene
+    sceneOp = new SceneRender("viewOverride_Overdraw_Transparent",
+        MHWRender::MSceneRender::kRenderTransparentShadedItems,
+        MHWRender::MClearOperation::kClearColor);
+    sceneOp->setShaderOverride("overdraw", "count");
+    sceneOp->setClearColor(overdrawClear);
+    sceneOp->setTargetCount(2);
+    mTransparentLayersPass = mGraph.addPass(sceneOp, { renderTargets::kTransparentLayers, renderTargets::kDepth }, {});
+    mGraph.setReadOnly(mTransparentLayersPass, { renderTargets::kDepth });
+    mGraph.setEnabled(mTransparentLayersPass, false);
+    // statistics reduced by kReduction x kReduction texels, the last one into a staging target set every frame
+    for (unsigned int i = 0; i < OverdrawStats::kLevels; i++) {
+        quadOp = new QuadRender("viewOverride_Overdraw_Stats_" + MString(std::to_string(i).c_str()), "quadOverdraw", "reduce");
+        if (i == 0) {
+            quadOp->setPermutation(quadOp->addPermutation({ { "LAYER_SOURCE", "1" } }));
+            mOverdrawThresholdParameter = quadOp->addParameter("gOverdrawParams", QuadParameter::kFloat4);
+        }
+        mOverdrawStatsInputParameters[i] = quadOp->addParameter("gInputTex", QuadParameter::kTarget);
+        mOverdrawStatsSizeParameters[i] = quadOp->addParameter("gSourceSize", QuadParameter::kFloat4);
+        bool last = (i + 1 == OverdrawStats::kLevels);
+        std::vector<int> outputs;
+        if (!last) {
+            outputs.push_back((int)renderTargets::kOverdrawStats + (int)i);
+        }
+        std::vector<int> inputs;
+        if (i > 0) {
+            inputs.push_back((int)renderTargets::kOverdrawStats + (int)i - 1);  // the layers are set every frame
+        }
+        mOverdrawStatsPasses[i] = mGraph.addPass(quadOp, outputs, inputs, last);
+        mGraph.setEnabled(mOverdrawStatsPasses[i], false);
+    }
+    // Accumulate Operation (running average of the jittered color, the blend state is set every frame)
+    quadOp = new QuadRender("viewOverride_Accumulate", "quadCopy", "copy");
+    mAccumulateInputParameter = quadOp->addParameter("gInputTex", QuadParameter::kTarget);
+    mAccumulatePass = mGraph.addPass(quadOp,
+        { renderTargets::kAccumulation },
+        { renderTargets::kAccumulation, renderTargets::kColor });
+    // Resolve Operation (accumulated color back to the color target)
+    quadOp = new QuadRender("viewOverride_Resolve", "quadCopy", "copy");
+    mResolveInputParameter = quadOp->addParameter("gInputTex", QuadParameter::kTarget);
+    mResolvePass = mGraph.addPass(quadOp, { renderTargets::kColor }, { renderTargets::kAccumulation });
+    // Capture Operations (scene targets to the staging targets of the capture, which are set every frame)
+    const char *captureNames[FrameCapture::kSourceCount] = { "viewOverride_Capture_Color", "viewOverride_Capture_Depth", "viewOverride_Capture_Normals" };
+    const int captureSources[FrameCapture::kSourceCount] = { renderTargets::kColor, renderTargets::kDepth, renderTargets::kNormals };
+    for (unsigned int i = 0; i < FrameCapture::kSourceCount; i++) {
+        quadOp = new QuadRender(captureNames[i], "quadCopy", "copy");
+        mCaptureInputParameters[i] = quadOp->addParameter("gInputTex", QuadParameter::kTarget);
+        mCapturePasses[i] = mGraph.addPass(quadOp, {}, { captureSources[i] }, true);
+        mGraph.setEnabled(mCapturePasses[i], false);
+    }
+    // Heatmap Operation (layers of the overdraw mode over the color, input is set every frame)
+    quadOp = new QuadRender("viewOverride_Overdraw_Heatmap", "quadOverdraw", "heatmap");
+    mHeatmapInputParameter = quadOp->addParameter("gInputTex", QuadParameter::kTarget);
+    mHeatmapPass = mGraph.addPass(quadOp, { renderTargets::kColor }, {});
+    mGraph.setEnabled(mHeatmapPass, false);
+    // Quad Operations (input is set every frame to the active target)
+    quadOp = new QuadRender("viewOverride_Quad", "quadDebug", "debug");
+    mInputTexParameter = quadOp->addParameter("gInputTex", QuadParameter::kTarget);
+    mColorChannelsParameter = quadOp->addParameter("gColorChannels", QuadParameter::kFloat4);
+    mDepthParameter = quadOp->addParameter("gDepthParams", QuadParameter::kFloat4);
+    for (unsigned int mode = 0; mode < kDebugModeCount; mode++) {
+        // see mDebugMode()
+        unsigned int visualization = mode / 2;
+        std::string visualize = std::to_string((visualization < 2) ? visualization : 2);
+        std::string normalEncoding = std::to_string((visualization < 2) ? 0 : visualization - 2);
+        std::string alphaOnly = std::to_string(mode % 2);
+        mDebugPermutations[mode] = quadOp->addPermutation({
+            { "VISUALIZE", visualize.c_str() },
+            { "NORMAL_ENCODING", normalEncoding.c_str() },
+            { "ALPHA_ONLY", alphaOnly.c_str() } });
+    }
+    mDebugPass = mGraph.addPass(quadOp, { renderTargets::kColor }, {});
+    // Tiles Operation (all targets side by side, presented instead of the color target)
+    quadOp = new QuadRender("viewOverride_Tiles", "quadDebug", "tiles");
+    const char *tileTextures[renderTargets::kTargetCount] = { "gColorTex", "gDepthTex", "gNormalsTex", "gAccumTex", "gRevealageTex" };
+    for (unsigned int i = 0; i < renderTargets::kTargetCount; i++) {
+        mTileTexParameters[i] = quadOp->addParameter(tileTextures[i], QuadParameter::kTarget);
+        mTileChannelsParameters[i] = quadOp->addParameter("gTileChannels" + MString(std::to_string(i).c_str()), QuadParameter::kFloat4);
+    }
+    mTileDepthParameter = quadOp->addParameter("gDepthParams", QuadParameter::kFloat4);
+    mTileNormalEncodingParameter = quadOp->addParameter("gNormalEncoding", QuadParameter::kInt);
+    mTileSizeParameter = quadOp->addParameter("gTileParams", QuadParameter::kFloat4);
+    mTileCountParameter = quadOp->addParameter("gTileCount", QuadParameter::kInt);
+    mTilesPass = mGraph.addPass(quadOp, { renderTargets::kDebugTiles }, {});
+    // Upscale Operation (scaled color and depth to full resolution targets, inputs are set every frame)
+    quadOp = new QuadRender("viewOverride_Upscale", "quadUpscale", "upscale");
+    MHWRender::MDepthStencilStateDesc depthStencilDesc;
+    depthStencilDesc.depthEnable = true;
+    depthStencilDesc.depthWriteEnable = true;
+    depthStencilDesc.depthFunc = MHWRender::MStateManager::kCompareAlways;
+    quadOp->setDepthStencilState(depthStencilDesc);
+    mUpscaleColorParameter = quadOp->addParameter("gColorTex", QuadParameter::kTarget);
+    mUpscaleDepthParameter = quadOp->addParameter("gDepthTex", QuadParameter::kTarget);
+    mUpscaleScaleParameter = quadOp->addParameter("gScaleParams", QuadParameter::kFloat4);
+    mUpscaleSourceParameter = quadOp->addParameter("gSourceSize", QuadParameter::kFloat4);
+    mUpscalePass = mGraph.addPass(quadOp,
+        { renderTargets::kUpscaledColor, renderTargets::kUpscaledDepth },
+        { renderTargets::kColor, renderTargets::kDepth });
+    // Scene UI Operation
+    sceneOp = new SceneRender("viewOverride_Scene_UI",
+        MHWRender::MSceneRender::kRenderUIItems,
+        MHWRender::MClearOperation::kClearNone);
+    mUIPass = mGraph.addPass(sceneOp,
+        { renderTargets::kColor, renderTargets::kDepth },
+        { renderTargets::kColor, renderTargets::kDepth });
+    // HUD Operation
+    MString API = MGlobal::executeCommandStringResult("optionVar -q vp2RenderingEngine");
+    HUDOperation *hudOp = new HUDOperation(mUIName + " - " + API);
+    hudOp->setFrameStats(&mFrameStats);
+    mHUDPass = mGraph.addPass(hudOp,
+        { renderTargets::kColor, renderTargets::kDepth },
+        { renderTargets::kColor, renderTargets::kDepth });
+    // Present Operation
+    PresentTarget *presentOp = new PresentTarget("viewOverride_Present");
+    mPresentPass = mGraph.addPass(presentOp,
+        { renderTargets::kColor, renderTargets::kDepth },
+        { renderTargets::kColor, renderTargets::kDepth }, true);
+    cout << "Render operations defined successfully" << endl;
+    return MStatus::kSuccess;
+}
+
+// setup() runs every frame and we can make sure that the rendering
+// pipeline is properly set up and ready for rendering. The render graph
+// is only recompiled if the enabled operations or their inputs changed.
 MStatus viewOverride::setup( const MString & destination ) {
 	MHWRender::MRenderer *theRenderer = MHWRender::MRenderer::theRenderer();
 	if (!theRenderer)
 		return MStatus::kFailure;
 
-    // setup targets
-    mUpdateRenderTargets();
-
 	// Create a new set of operations as required
-    if (!mOperations[0]) {
-        cout << "Defining render operations" << endl;
-        // Scene Operations
-        mOperations[0] = new SceneRender("viewOverride_Scene",
-            MHWRender::MSceneRender::kRenderShadedItems,
-            MHWRender::MClearOperation::kClearAll);
-        SceneRender * sceneOp = dynamic_cast<SceneRender*>(mOperations[0]);
-        if (sceneOp) {
-            sceneOp->setTargetOverride(0, mTargets[renderTargets::kColor]);
-            sceneOp->setTargetOverride(1, mTargets[renderTargets::kDepth]);
-            sceneOp->setTargetOverride(2, mTargets[renderTargets::kNormals]);
-        }
-        // Quad Operations
-        mOperations[1] = new QuadRender("viewOverride_Quad", "quadDebug", "debug");
-        QuadRender * quadOp = dynamic_cast<QuadRender*>(mOperations[1]);
-        if (quadOp) {
-            quadOp->setTargetOverride(0, mTargets[renderTargets::kColor]);
-            quadOp->setTargetOverride(1, mTargets[renderTargets::kDepth]);
-            //quadOp->setEnabled(false);
-        }
-        // Scene UI Operation
-        mOperations[2] = new SceneRender("viewOverride_Scene_UI",
-            MHWRender::MSceneRender::kRenderUIItems,
-            MHWRender::MClearOperation::kClearNone);
-        sceneOp = dynamic_cast<SceneRender*>(mOperations[2]);
-        if (sceneOp) {
-            sceneOp->setTargetOverride(0, mTargets[renderTargets::kColor]);
-            sceneOp->setTargetOverride(1, mTargets[renderTargets::kDepth]);
-        }
-        // HUD Operation
-        MString API = MGlobal::executeCommandStringResult("optionVar -q vp2RenderingEngine");
-        mOperations[3] = new HUDOperation(mUIName + " - " + API);
-        HUDOperation * hudOp = dynamic_cast<HUDOperation*>(mOperations[3]);
-        if (hudOp) {
-            hudOp->setTargetOverride(0, mTargets[renderTargets::kColor]);
-            hudOp->setTargetOverride(1, mTargets[renderTargets::kDepth]);
-        }
-        // Present Operation
-        mOperations[4] = new PresentTarget("viewOverride_Present");
-        PresentTarget * presentOp = dynamic_cast<PresentTarget*>(mOperations[4]);
-        if (presentOp) {
-            presentOp->setTargetOverride(0, mTargets[renderTargets::kColor]);
-            presentOp->setTargetOverride(1, mTargets[renderTargets::kDepth]);
-        }
-        cout << "Render operations defined successfully" << endl;
-    }
-    // Test if all operations are initialized successfully
-    for (unsigned int i = 0; i < renderOperations::kOperationCount; i++) {
-        if (!mOperations[i]) {
-            cerr << "mOperation[" << i << "] could not be initialized correctly" << endl;
-            return MStatus::kFailure;
+    if (mGraph.passCount() == 0) {
+        MStatus status = mBuildGraph();
+        CHECK_MSTATUS_AND_RETURN_IT(status);
+    }
+
+    // swap in shaders that changed on disk
+    if (mShaderWatcher.running()) {
+        mReloadShaders();
+    }
+
+    // panels that didn't change since they were drawn are drawn at full resolution, refined by
+    // progressive accumulation and then only presented again (frame cache)
+    FrameState frame;
+    TargetSet *targetSet = mFindTargetSet(destination);
+    if (!targetSet) {
+        return MStatus::kFailure;
+    }
+    frame.targetSet = targetSet;
+    // pass ablation benchmark: every frame is drawn in full with the configuration being measured
+    frame.ablating = mAblation.running();
+    frame.ablationConfig = frame.ablating ? mStepAblation() : -1;
+    frame.unchanged = mUnchanged(targetSet, frame.sceneChanged, frame.viewChanged);
+    // captured frames draw the scene, even if the panel didn't change
+    frame.capturing = (mCapture.framesLeft() > 0) &&
+        (mCapture.destination().empty() || mCapture.destination() == targetSet->destination);
+    if (frame.capturing) {
+        frame.unchanged = false;
+    }
+    // the debug views show the targets of the frame, only the color is refined
+    const float *channels = &mChannels[mActiveTarget * 4];
+    bool defaultChannels = (channels[0] == 1.0f) && (channels[1] == 1.0f) && (channels[2] == 1.0f) && (channels[3] == 0.0f);
+    frame.debugShown = (mActiveTarget != renderTargets::kColor) || !defaultChannels;
+    frame.overdrawShown = (mOverdrawMode != overdrawModes::kOverdrawOff);
+    frame.refine = (mProgressiveSamples > 0) && !mTilesShown && !frame.debugShown && !frame.overdrawShown;
+    if (!frame.unchanged || !frame.refine) {
+        targetSet->samples = 0;
+    }
+    mFrameCached = mFrameCacheEnabled && frame.unchanged && targetSet->finalImage;
+    frame.resolving = frame.refine && frame.unchanged && !mFrameCached;
+    frame.accumulating = frame.resolving && (targetSet->samples < mProgressiveSamples);
+    frame.sceneDrawn = !mFrameCached && (!frame.resolving || frame.accumulating);
+    // targets of the scene render, alternating between two layouts while comparing them
+    frame.layoutSide = mLayoutTest.running() ? mLayoutTest.nextSide() : -1;
+    frame.sceneLayout = (frame.layoutSide >= 0) ? mTestLayouts[frame.layoutSide] : mSceneLayout;
+    // proxy objects: while navigating, the scene renders only draw the (cached) proxy set, the
+    // full scene is drawn again by the redraw scheduled once the camera stopped
+    bool navigating = frame.viewChanged && !frame.sceneChanged;  // only the camera or viewport changed
+    frame.proxySet = (navigating && !frame.capturing && mProxyPatterns.length() > 0) ? mUpdateProxySet() : nullptr;
+    mProxyDrawn = frame.sceneDrawn && (frame.proxySet != nullptr);
+    int viewX, viewY;
+    this->getFrameContext()->getViewportDimensions(viewX, viewY, frame.viewWidth, frame.viewHeight);
+
+    // passes of each feature (the resolution and the partial rectangle come first, the scene renders draw with them)
+    mConfigureDynamicResolution(frame);
+    mConfigurePartialRedraw(frame);
+    mConfigureScene(frame);
+    mConfigureTransparency(frame);
+    mConfigureProgressive(frame);
+    mConfigureCapture(frame);
+    mConfigureDebugViews(frame);
+    mConfigurePresentation();
+    mConfigureDepthPyramid(frame);
+    mConfigureOverdraw(frame);
+    // packed G-buffer layout of the normals target
+    mGraph.setTargetFormat(renderTargets::kNormals, sNormalsFormat(mGBufferLayout));
+    // pass ablation: the operation is measured without, whatever this frame enabled
+    if (frame.ablationConfig >= 0 && mAblation.results()[frame.ablationConfig].config.disabledPass >= 0) {
+        mAblationPass = mAblation.results()[frame.ablationConfig].config.disabledPass;
+        mAblationPassEnabled = mGraph.pass(mAblationPass).enabled;
+        mGraph.setEnabled(mAblationPass, false);
+    }
+    mGraph.compile();
+    mListOperations(frame);
+
+    // setup targets of the panel being drawn
+    MStatus status = mUpdateRenderTargets(targetSet);
+    CHECK_MSTATUS_AND_RETURN_IT(status);
+    mGraph.assignTargets(mTargets, mViewportRect, mScaledRect);
+
+    // targets and shader parameters of each feature (only changed values reach the shader instances)
+    mUpdatePartialRedraw(frame);
+    mUpdateTransparency();
+    mUpdateDepthPyramid(frame);
+    mUpdateOverdraw(frame);
+    mUpdateDebugViews();
+    mUpdateDynamicResolution();
+    mUpdateProgressive(frame);
+    mUpdateCapture(frame);
+    HUDOperation * hudOp = (HUDOperation*)mGraph.operation(mHUDPass);
+    hudOp->setResolutionScale(mScaling ? mScaler.scale() : 1.0f);
+    hudOp->setCached(mFrameCached || frame.partial);
+    // partial redraws need the full resolution scene and UI of the previous frame, with the HUD text it drew
+    if (!mFrameCached && !frame.partial) {
+        targetSet->redrawable = !mScaling && !mProxyDrawn && !mTilesShown && !frame.debugShown && !frame.overdrawShown && !mOITEnabled;
+        targetSet->hudVersion = hudOp->textVersion();
+    }
+
+    // draw the panel again until its image is final, unless the scene keeps changing (e.g., playback),
+    // until its captures are read back and until the pass ablation benchmark is done
+    targetSet->finalImage = !mScaling && !mProxyDrawn && (!frame.refine || targetSet->samples >= mProgressiveSamples);
+    bool redraw = !targetSet->finalImage && mSceneWatcher.running() && !frame.sceneChanged;
+    if (redraw || mAblation.running() || (mCapture.active() && mCapture.destination() == targetSet->destination)) {
+        M3dView view;
+        if (M3dView::getM3dViewFromModelPanel(destination, view) == MS::kSuccess) {
+            view.scheduleRefresh();
         }
-	}
-    // update shaders
-    QuadRender * quadOp = (QuadRender*)mOperations[renderOperations::kQuadRender];
-    // set shader parameters
-    MShaderInstance *shader = quadOp->shaderInstance();
-    if (shader) {
-        MRenderTargetAssignment targetAssignment{ mTargets[mActiveTarget] };
-        shader->setParameter("gInputTex", targetAssignment);
-        shader->setParameter("gColorChannels", mChannels[0]);
     }
 
     /*
     /// testing
-    MStringArray oT = mOperations[0]->outputTargets();
+    MStringArray oT = mGraph.operation(mScenePass)->outputTargets();
     cout << "Scene render outputs to: " << endl;
     for (unsigned int i = 0; i < oT.length(); i++) {
         cout << oT[i] << endl;
@@ -273,6 +1204,398 @@ MStatus viewOverride::setup( const MString & destination ) {
 	return MStatus::kSuccess;
 }
 
+MHWRender::MRasterFormat viewOverride::sNormalsFormat(unsigned int layout) {
+    static const MHWRender::MRasterFormat formats[gBufferLayouts::kLayoutCount] = {
+        MHWRender::kR32G32B32A32_FLOAT, MHWRender::kR16G16_FLOAT, MHWRender::kR8G8B8A8_UNORM };
+    return formats[layout];
+}
+
+void viewOverride::mConfigureScene(const FrameState &frame) {
+    static const std::vector<int> sceneOutputs[sceneLayouts::kSceneLayoutCount] = {
+        { renderTargets::kColor, renderTargets::kDepth },
+        { renderTargets::kColor, renderTargets::kDepth, renderTargets::kNormals },
+        { renderTargets::kColor, renderTargets::kDepth, renderTargets::kNormals, renderTargets::kSceneAOV0, renderTargets::kSceneAOV1 } };
+    static const std::vector<int> sceneInputs[2] = { {}, { renderTargets::kColor, renderTargets::kDepth } };
+    SceneRender * sceneOp = (SceneRender*)mGraph.operation(mScenePass);
+    mGraph.setEnabled(mScenePass, frame.sceneDrawn);
+    mGraph.setOutputs(mScenePass, sceneOutputs[frame.sceneLayout]);
+    sceneOp->setTargetCount((unsigned int)sceneOutputs[frame.sceneLayout].size());
+    // only the opaque items, if the transparent items have their own scene render
+    bool splitTransparency = mSplitTransparency && !mOITEnabled;
+    sceneOp->setSceneFilter((mOITEnabled || splitTransparency) ?
+        MHWRender::MSceneRender::kRenderOpaqueShadedItems : MHWRender::MSceneRender::kRenderShadedItems);
+    // partial redraws draw over the last image
+    mGraph.setInputs(mScenePass, sceneInputs[frame.partial ? 1 : 0]);
+    sceneOp->setClearMask(frame.partial ? MHWRender::MClearOperation::kClearNone : MHWRender::MClearOperation::kClearAll);
+    sceneOp->setCameraOverride(frame.sceneCamera);
+    sceneOp->setObjectSetOverride(frame.proxySet);
+}
+
+void viewOverride::mConfigureTransparency(const FrameState &frame) {
+    // split transparency: opaque scene render to the layout + transparent scene render to color and depth
+    // order-independent transparency: opaque scene render + transparent accumulation and composite
+    bool splitTransparency = mSplitTransparency && !mOITEnabled;
+    mGraph.setEnabled(mTransparentScenePass, splitTransparency && frame.sceneDrawn);
+    mGraph.setEnabled(mOITScenePass, mOITEnabled && frame.sceneDrawn);
+    mGraph.setEnabled(mOITCompositePass, mOITEnabled && frame.sceneDrawn);
+    const int scenePasses[2] = { mTransparentScenePass, mOITScenePass };
+    for (int pass : scenePasses) {
+        SceneRender * sceneOp = (SceneRender*)mGraph.operation(pass);
+        sceneOp->setCameraOverride(frame.sceneCamera);
+        sceneOp->setObjectSetOverride(frame.proxySet);
+    }
+}
+
+void viewOverride::mUpdateTransparency() {
+    if (mGraph.passCompiled(mOITCompositePass)) {
+        QuadRender * compositeOp = (QuadRender*)mGraph.operation(mOITCompositePass);
+        compositeOp->setParameter(mAccumTexParameter, mTargets[renderTargets::kOITAccum]);
+        compositeOp->setParameter(mRevealageTexParameter, mTargets[renderTargets::kOITRevealage]);
+    }
+}
+
+void viewOverride::mConfigureProgressive(const FrameState &frame) {
+    // jittered scene renders are blended into the accumulation target, which is copied back to
+    // the color target for the UI (also once it converged)
+    mGraph.setEnabled(mAccumulatePass, frame.accumulating);
+    mGraph.setEnabled(mResolvePass, frame.resolving);
+}
+
+void viewOverride::mUpdateProgressive(const FrameState &frame) {
+    if (frame.accumulating) {
+        // jitter the projection within the pixel and weigh the sample into the running average
+        const MFrameContext *frameContext = this->getFrameContext();
+        unsigned int sample = frame.targetSet->samples++;
+        MMatrix jitter;
+        jitter(3, 0) = 2.0 * (sHalton(sample + 1, 2) - 0.5) / std::max(frame.viewWidth, 1);
+        jitter(3, 1) = 2.0 * (sHalton(sample + 1, 3) - 0.5) / std::max(frame.viewHeight, 1);
+        mJitterCamera.mCameraPath = frameContext->getCurrentCameraPath();
+        mJitterCamera.mUseProjectionMatrix = true;
+        mJitterCamera.mProjectionMatrix = frameContext->getMatrix(MHWRender::MFrameContext::kProjectionMtx) * jitter;
+        QuadRender * accumulateOp = (QuadRender*)mGraph.operation(mAccumulatePass);
+        accumulateOp->setParameter(mAccumulateInputParameter, mTargets[renderTargets::kColor]);
+        MHWRender::MBlendStateDesc blendDesc;
+        blendDesc.targetBlends[0].blendEnable = true;
+        blendDesc.targetBlends[0].sourceBlend = MHWRender::MBlendState::kBlendFactor;
+        blendDesc.targetBlends[0].destinationBlend = MHWRender::MBlendState::kInvBlendFactor;
+        blendDesc.targetBlends[0].alphaSourceBlend = MHWRender::MBlendState::kBlendFactor;
+        blendDesc.targetBlends[0].alphaDestinationBlend = MHWRender::MBlendState::kInvBlendFactor;
+        for (unsigned int i = 0; i < 4; i++) {
+            blendDesc.blendFactor[i] = 1.0f / (float)(sample + 1);  // the first sample replaces the previous image
+        }
+        accumulateOp->setBlendState(blendDesc);
+    }
+    if (frame.resolving) {
+        ((QuadRender*)mGraph.operation(mResolvePass))->setParameter(mResolveInputParameter, mTargets[renderTargets::kAccumulation]);
+    }
+}
+
+void viewOverride::mConfigureCapture(FrameState &frame) {
+    // the scene targets are copied before the debug views and UI draw over them
+    frame.captureSources[FrameCapture::kNormalsSource] = (frame.sceneLayout != sceneLayouts::kSceneColorDepth);
+    for (unsigned int i = 0; i < FrameCapture::kSourceCount; i++) {
+        mGraph.setEnabled(mCapturePasses[i], frame.capturing && frame.captureSources[i]);
+    }
+}
+
+void viewOverride::mUpdateCapture(const FrameState &frame) {
+    if (!mCapture.active()) {
+        return;
+    }
+    // reads back the frame captured kLatency frames ago and points the copies to this frame's staging targets
+    MHWRender::MRasterFormat captureFormats[FrameCapture::kSourceCount] = {
+        MHWRender::kR16G16B16A16_FLOAT, MHWRender::kR32_FLOAT, sNormalsFormat(mGBufferLayout) };
+    bool signedNormals = (mGBufferLayout != gBufferLayouts::kNormalsCompact);
+    if (mCapture.beginFrame(frame.targetSet->destination, mTargetPool, mScaledWidth, mScaledHeight, captureFormats, frame.captureSources, signedNormals)) {
+        const int sourceTargets[FrameCapture::kSourceCount] = { renderTargets::kColor, renderTargets::kDepth, renderTargets::kNormals };
+        for (unsigned int i = 0; i < FrameCapture::kSourceCount; i++) {
+            if (mGraph.passCompiled(mCapturePasses[i])) {
+                const PooledTarget &staging = mCapture.staging(i);
+                QuadRender * copyOp = (QuadRender*)mGraph.operation(mCapturePasses[i]);
+                copyOp->setTargetOverride(0, staging.target);
+                copyOp->setViewportRectangle(sSubRectangle(staging.description, mScaledWidth, mScaledHeight, mCaptureRects[i]));
+                copyOp->setParameter(mCaptureInputParameters[i], mTargets[sourceTargets[i]]);
+            }
+        }
+    }
+}
+
+void viewOverride::mConfigureDebugViews(const FrameState &frame) {
+    // the debug quad does no useful work while showing all channels of the color target
+    mGraph.setEnabled(mDebugPass, frame.sceneDrawn && !mTilesShown && frame.debugShown);
+    static const std::vector<int> debugInputs[renderTargets::kTargetCount] = {
+        { renderTargets::kColor }, { renderTargets::kDepth }, { renderTargets::kNormals },
+        { renderTargets::kOITAccum }, { renderTargets::kOITRevealage } };
+    mGraph.setInputs(mDebugPass, debugInputs[mActiveTarget]);
+    // the tiles are presented instead of the color target (without UI, which wouldn't line up)
+    static const std::vector<int> tileInputs[2] = {
+        { renderTargets::kColor, renderTargets::kDepth, renderTargets::kNormals },
+        { renderTargets::kColor, renderTargets::kDepth, renderTargets::kNormals, renderTargets::kOITAccum, renderTargets::kOITRevealage } };
+    mGraph.setEnabled(mTilesPass, mTilesShown && frame.sceneDrawn);
+    mGraph.setInputs(mTilesPass, tileInputs[mOITEnabled ? 1 : 0]);
+}
+
+void viewOverride::mUpdateDebugViews() {
+    if (!mGraph.passCompiled(mDebugPass) && !mGraph.passCompiled(mTilesPass)) {
+        return;
+    }
+    const MFrameContext *frameContext = this->getFrameContext();
+    // parameters to linearize depth
+    float depthParams[4] = { 0.1f, 10000.0f, 0.0f, 0.0f };  // near, far, orthographic
+    MStatus cameraStatus;
+    MFnCamera camera(frameContext->getCurrentCameraPath(), &cameraStatus);
+    if (cameraStatus == MS::kSuccess) {
+        depthParams[0] = (float)camera.nearClippingPlane();
+        depthParams[1] = (float)camera.farClippingPlane();
+        depthParams[2] = camera.isOrtho() ? 1.0f : 0.0f;
+    }
+    if (mGraph.passCompiled(mDebugPass)) {
+        QuadRender * quadOp = (QuadRender*)mGraph.operation(mDebugPass);
+        quadOp->setParameter(mInputTexParameter, mTargets[mActiveTarget]);
+        quadOp->setParameter(mColorChannelsParameter, &mChannels[mActiveTarget * 4]);
+        quadOp->setParameter(mDepthParameter, depthParams);
+        quadOp->setPermutation(mDebugPermutations[mDebugMode()]);
+    }
+    if (mGraph.passCompiled(mTilesPass)) {
+        QuadRender * tilesOp = (QuadRender*)mGraph.operation(mTilesPass);
+        for (unsigned int i = 0; i < renderTargets::kTargetCount; i++) {
+            tilesOp->setParameter(mTileTexParameters[i], mTargets[i]);
+            tilesOp->setParameter(mTileChannelsParameters[i], &mChannels[i * 4]);
+        }
+        float tileParams[4] = { (float)mScaledWidth, (float)mScaledHeight, 3.0f, 2.0f };  // viewport size, columns, rows
+        tilesOp->setParameter(mTileDepthParameter, depthParams);
+        tilesOp->setParameter(mTileNormalEncodingParameter, (int)mGBufferLayout);
+        tilesOp->setParameter(mTileSizeParameter, tileParams);
+        tilesOp->setParameter(mTileCountParameter, mOITEnabled ? (int)renderTargets::kTargetCount : (int)renderTargets::kOITAccum);
+    }
+}
+
+void viewOverride::mConfigureDynamicResolution(const FrameState &frame) {
+    // adapt the scale to the last recorded frame time and upscale the scaled scene (or tiles)
+    // into the full resolution targets that the UI and HUD draw over
+    if (mScaler.budget() > 0.0f && mFrameStats.frames() != mScaledFrame) {
+        mScaledFrame = mFrameStats.frames();
+        if (!frame.unchanged) {
+            mScaler.update(mFrameStats.latest());  // still frames don't reflect interactive costs
+        }
+    }
+    mScaling = !frame.unchanged && (mScaler.scale() < 1.0f);  // still frames are drawn at full resolution
+    mScaledWidth = (unsigned int)frame.viewWidth;
+    mScaledHeight = (unsigned int)frame.viewHeight;
+    if (mScaling) {
+        mScaledWidth = std::max(1u, (unsigned int)std::lround(frame.viewWidth * mScaler.scale()));
+        mScaledHeight = std::max(1u, (unsigned int)std::lround(frame.viewHeight * mScaler.scale()));
+    }
+    static const std::vector<int> upscaleInputs[2] = {
+        { renderTargets::kColor, renderTargets::kDepth },
+        { renderTargets::kDebugTiles, renderTargets::kDepth } };
+    mGraph.setEnabled(mUpscalePass, mScaling && frame.sceneDrawn);
+    mGraph.setInputs(mUpscalePass, upscaleInputs[mTilesShown ? 1 : 0]);
+}
+
+void viewOverride::mUpdateDynamicResolution() {
+    if (mGraph.passCompiled(mUpscalePass)) {
+        QuadRender * upscaleOp = (QuadRender*)mGraph.operation(mUpscalePass);
+        upscaleOp->setParameter(mUpscaleColorParameter, mTargets[mTilesShown ? renderTargets::kDebugTiles : renderTargets::kColor]);
+        upscaleOp->setParameter(mUpscaleDepthParameter, mTargets[renderTargets::kDepth]);
+        upscaleOp->setParameter(mUpscaleScaleParameter, mScaleParams);
+        upscaleOp->setParameter(mUpscaleSourceParameter, mSourceSize);
+    }
+}
+
+void viewOverride::mConfigurePartialRedraw(FrameState &frame) {
+    // if only shapes changed, the scene and UI are drawn over the last image of the panel, within
+    // the rectangle of the shapes and with a projection cropped to it (the HUD keeps its text)
+    HUDOperation * hudOp = (HUDOperation*)mGraph.operation(mHUDPass);
+    const MFrameContext *frameContext = this->getFrameContext();
+    TargetSet *targetSet = frame.targetSet;
+    frame.partial = false;
+    if (mPartialThreshold > 0.0f && frame.sceneDrawn) {
+        const MMatrix viewProjection = frameContext->getMatrix(MHWRender::MFrameContext::kViewProjMtx);
+        bool localized = mDirtyRegion(targetSet, viewProjection, frame.viewWidth, frame.viewHeight, mPartialRect);
+        if (mPartialRect.empty()) {
+            mPartialRect.width = mPartialRect.height = 1;  // off screen, nothing to draw
+        }
+        double viewArea = std::max((double)frame.viewWidth * (double)frame.viewHeight, 1.0);
+        // the OIT passes draw and composite the whole frame
+        frame.partial = localized && !frame.viewChanged && targetSet->redrawable && !mScaling && !mOITEnabled
+            && !frame.capturing && !frame.accumulating
+            && (mPartialRect.area() <= mPartialThreshold * viewArea)
+            && (hudOp->textVersion() == targetSet->hudVersion)
+            && (mPartialRect.y + mPartialRect.height <= hudOp->textBottom() * frame.viewHeight);
+    }
+    mRedrawnFraction = frame.partial ? (float)(mPartialRect.area() / ((double)frame.viewWidth * (double)frame.viewHeight)) :
+        (frame.sceneDrawn ? 1.0f : 0.0f);
+    mGraph.setEnabled(mPartialClearPass, frame.partial);
+    if (frame.partial) {
+        mCropCamera.mCameraPath = frameContext->getCurrentCameraPath();
+        mCropCamera.mUseProjectionMatrix = true;
+        mCropCamera.mProjectionMatrix = frameContext->getMatrix(MHWRender::MFrameContext::kProjectionMtx) *
+            DirtyRegion::cropMatrix(mPartialRect, frame.viewWidth, frame.viewHeight);
+    }
+    // the scene renders draw with the cropped or the jittered projection (never both)
+    frame.sceneCamera = frame.partial ? &mCropCamera : (frame.accumulating ? &mJitterCamera : nullptr);
+    ((SceneRender*)mGraph.operation(mUIPass))->setCameraOverride(frame.partial ? &mCropCamera : nullptr);
+}
+
+void viewOverride::mUpdatePartialRedraw(const FrameState &frame) {
+    if (!frame.partial) {
+        return;
+    }
+    // the redrawn rectangle of the bucketed targets
+    const MHWRender::MRenderTargetDescription &colorDescription = frame.targetSet->pooled[renderTargets::kColor].description;
+    mPartialViewportRect = MFloatPoint(
+        (float)mPartialRect.x / (float)colorDescription.width(), (float)mPartialRect.y / (float)colorDescription.height(),
+        (float)mPartialRect.width / (float)colorDescription.width(), (float)mPartialRect.height / (float)colorDescription.height());
+    ((QuadRender*)mGraph.operation(mPartialClearPass))->setViewportRectangle(&mPartialViewportRect);
+    const int scenePasses[3] = { mScenePass, mTransparentScenePass, mUIPass };
+    for (int pass : scenePasses) {
+        ((SceneRender*)mGraph.operation(pass))->setViewportRectangle(&mPartialViewportRect);
+    }
+}
+
+void viewOverride::mConfigurePresentation() {
+    // the UI and HUD draw over the presented targets, the full resolution ones while scaling
+    static const std::vector<int> presentedTargets[2][2] = {
+        { { renderTargets::kColor, renderTargets::kDepth }, { renderTargets::kDebugTiles, renderTargets::kDepth } },
+        { { renderTargets::kUpscaledColor, renderTargets::kUpscaledDepth }, { renderTargets::kUpscaledColor, renderTargets::kUpscaledDepth } } };
+    const std::vector<int> &presented = presentedTargets[mScaling ? 1 : 0][mTilesShown ? 1 : 0];
+    mGraph.setEnabled(mUIPass, !mTilesShown && !mFrameCached);
+    mGraph.setOutputs(mUIPass, presentedTargets[mScaling ? 1 : 0][0]);
+    mGraph.setInputs(mUIPass, presentedTargets[mScaling ? 1 : 0][0]);
+    mGraph.setOutputs(mHUDPass, presented);
+    mGraph.setInputs(mHUDPass, presented);
+    mGraph.setOutputs(mPresentPass, presented);
+    mGraph.setInputs(mPresentPass, presented);
+}
+
+void viewOverride::mConfigureDepthPyramid(const FrameState &frame) {
+    // the levels down to a single texel reduce the scene depth before the UI draws into it
+    mDepthPyramidLevelCount = (mDepthPyramidEnabled && frame.sceneDrawn) ? sDepthPyramidLevels(mScaledWidth, mScaledHeight) : 0;
+    mDepthPyramidSizes[0][0] = mScaledWidth;
+    mDepthPyramidSizes[0][1] = mScaledHeight;
+    for (unsigned int i = 0; i < kDepthPyramidLevels; i++) {
+        mGraph.setEnabled(mDepthPyramidPasses[i], i < mDepthPyramidLevelCount);
+        mDepthPyramidSizes[i + 1][0] = (mDepthPyramidSizes[i][0] + 1) / 2;
+        mDepthPyramidSizes[i + 1][1] = (mDepthPyramidSizes[i][1] + 1) / 2;
+    }
+}
+
+void viewOverride::mUpdateDepthPyramid(const FrameState &frame) {
+    for (unsigned int i = 0; i < mDepthPyramidLevelCount; i++) {
+        // each level renders into the sub-rectangle of its own size bucket
+        int level = renderTargets::kDepthPyramid + (int)i;
+        float sourceSize[4] = { (float)mDepthPyramidSizes[i][0], (float)mDepthPyramidSizes[i][1], 0.0f, 0.0f };
+        QuadRender * reduceOp = (QuadRender*)mGraph.operation(mDepthPyramidPasses[i]);
+        reduceOp->setParameter(mDepthPyramidInputParameters[i], mTargets[(i == 0) ? (int)renderTargets::kDepth : level - 1]);
+        reduceOp->setParameter(mDepthPyramidSizeParameters[i], sourceSize);
+        reduceOp->setViewportRectangle(sSubRectangle(frame.targetSet->pooled[mGraph.alias(level)].description,
+            mDepthPyramidSizes[i + 1][0], mDepthPyramidSizes[i + 1][1], mDepthPyramidRects[i]));
+    }
+}
+
+void viewOverride::mConfigureOverdraw(FrameState &frame) {
+    // the layers are counted by an instrumentation scene render, shown by the heatmap
+    // and reduced to a single texel of statistics that is read back a few frames late
+    bool overdraw = frame.overdrawShown && frame.sceneDrawn;
+    frame.layerTarget = (mOverdrawMode == overdrawModes::kOverdrawTransparent) ?
+        (int)renderTargets::kTransparentLayers : (int)renderTargets::kOverdraw;
+    mGraph.setEnabled(mOverdrawPass, overdraw && (frame.layerTarget == renderTargets::kOverdraw));
+    mGraph.setEnabled(mTransparentLayersPass, overdraw && (frame.layerTarget == renderTargets::kTransparentLayers));
+    mGraph.setEnabled(mHeatmapPass, overdraw && !mTilesShown);
+    mGraph.setInputs(mHeatmapPass, { frame.layerTarget });
+    mGraph.setInputs(mOverdrawStatsPasses[0], { frame.layerTarget });
+    mOverdrawStatsSizes[0][0] = mScaledWidth;
+    mOverdrawStatsSizes[0][1] = mScaledHeight;
+    for (unsigned int i = 0; i < OverdrawStats::kLevels; i++) {
+        mGraph.setEnabled(mOverdrawStatsPasses[i], overdraw);
+        mOverdrawStatsSizes[i + 1][0] = (mOverdrawStatsSizes[i][0] + OverdrawStats::kReduction - 1) / OverdrawStats::kReduction;
+        mOverdrawStatsSizes[i + 1][1] = (mOverdrawStatsSizes[i][1] + OverdrawStats::kReduction - 1) / OverdrawStats::kReduction;
+    }
+}
+
+void viewOverride::mUpdateOverdraw(const FrameState &frame) {
+    if (!frame.overdrawShown || !frame.sceneDrawn) {
+        return;
+    }
+    if (mGraph.passCompiled(mHeatmapPass)) {
+        ((QuadRender*)mGraph.operation(mHeatmapPass))->setParameter(mHeatmapInputParameter, mTargets[frame.layerTarget]);
+    }
+    // the last reduction writes into this frame's staging target
+    MHWRender::MRenderTarget *staging = mOverdrawStats.beginFrame(mTargetPool);
+    float overdrawParams[4] = { (float)mOverdrawThreshold, 0.0f, 0.0f, 0.0f };
+    for (unsigned int i = 0; i < OverdrawStats::kLevels; i++) {
+        int level = renderTargets::kOverdrawStats + (int)i;
+        float sourceSize[4] = { (float)mOverdrawStatsSizes[i][0], (float)mOverdrawStatsSizes[i][1], 0.0f, 0.0f };
+        QuadRender * reduceOp = (QuadRender*)mGraph.operation(mOverdrawStatsPasses[i]);
+        reduceOp->setParameter(mOverdrawStatsInputParameters[i], mTargets[(i == 0) ? frame.layerTarget : level - 1]);
+        reduceOp->setParameter(mOverdrawStatsSizeParameters[i], sourceSize);
+        if (i == 0) {
+            reduceOp->setParameter(mOverdrawThresholdParameter, overdrawParams);
+        }
+        if (i + 1 < OverdrawStats::kLevels) {
+            reduceOp->setViewportRectangle(sSubRectangle(frame.targetSet->pooled[mGraph.alias(level)].description,
+                mOverdrawStatsSizes[i + 1][0], mOverdrawStatsSizes[i + 1][1], mOverdrawStatsRects[i]));
+        } else {
+            reduceOp->setTargetOverride(0, staging);
+            reduceOp->setViewportRectangle(nullptr);
+        }
+    }
+    const OverdrawSummary &summary = mOverdrawStats.summary();
+    char buffer[160];
+    sprintf(buffer, "%s: mean %.2f  max %.0f  > %u layers: %.1f%%",
+        (frame.layerTarget == renderTargets::kOverdraw) ? "Overdraw" : "Transparent layers",
+        summary.meanLayers, summary.maxLayers, mOverdrawThreshold, 100.0f * summary.aboveFraction);
+    ((HUDOperation*)mGraph.operation(mHUDPass))->setOverdrawStats(summary.valid ? MString(buffer) : MString());
+}
+
+void viewOverride::mListOperations(const FrameState &frame) {
+    // operations to iterate, each one preceded by a timestamp while profiling
+    const std::vector<int> &passes = mGraph.compiledPasses();
+    mOperationList.clear();
+    bool comparing = (frame.layoutSide >= 0);
+    bool profiling = mGPUProfiler.beginFrame(frame.targetSet->destination, passes, comparing ? frame.layoutSide : frame.ablationConfig);
+    for (unsigned int i = 0; i < passes.size(); i++) {
+        if (profiling && i < mGPUProfiler.timedPasses()) {
+            mOperationList.push_back(mGPUProfiler.operation(i));
+        }
+        mOperationList.push_back(mGraph.operation(passes[i]));
+    }
+    if (profiling) {
+        MStringArray passTimes;
+        gpuPassTimes(passTimes);
+        ((HUDOperation*)mGraph.operation(mHUDPass))->setPassTimes(passTimes);
+    }
+    // the resolved times feed the scene layout comparison and the pass ablation benchmark
+    if (comparing) {
+        if (profiling) {
+            mLayoutTest.record(mGPUProfiler.resolvedTag(), mGPUProfiler.resolvedTime(mScenePass), mGPUProfiler.resolvedFrameTime());
+        } else {
+            mLayoutTest.stop();  // no timestamps on this draw API
+        }
+        if (!mLayoutTest.running()) {
+            mFinishLayoutComparison();
+        }
+    }
+    if (frame.ablating) {
+        if (profiling) {
+            std::vector<std::string> passNames;
+            std::vector<double> passTimes;
+            for (unsigned int i = 0; i < mGraph.passCount(); i++) {
+                double time = mGPUProfiler.resolvedTime(i);
+                if (time >= 0.0) {
+                    passNames.push_back(mGraph.operation(i)->name().asChar());
+                    passTimes.push_back(time);
+                }
+            }
+            mAblation.recordGPU(mGPUProfiler.resolvedTag(), mGPUProfiler.resolvedFrameTime(), passNames, passTimes);
+        }
+        if (!mAblation.running()) {
+            mFinishAblation();
+        }
+    }
+}
+
 // On cleanup we just return for returning the list of operations for
 // the next render
 //
@@ -4,30 +4,74 @@
 // License       MIT
 
 #pragma once
+#include <map>
+#include <chrono>
+#include <string>
 #include <vector>
 #include <maya/MString.h>
+#include <maya/MStringArray.h>
+#include <maya/MMessage.h>
+#include <maya/MMatrix.h>
+#include <maya/MFloatPoint.h>
+#include <maya/MSelectionList.h>
 #include <maya/MViewport2Renderer.h>
 #include <maya/MRenderTargetManager.h>
+#include "viewOverrideCapture.h"
+#include "viewOverrideDirtyRegion.h"
+#include "viewOverrideGraph.h"
+#include "viewOverrideOverdraw.h"
+#include "viewOverrideProfiler.h"
+#include "viewOverrideScaling.h"
+#include "viewOverrideSceneWatcher.h"
+#include "viewOverrideShaderWatcher.h"
+#include "viewOverrideTargetPool.h"
 
 // Barebones override class derived from MRenderOverride
 class viewOverride : public MHWRender::MRenderOverride
 {
 public:
+    /// levels of the depth pyramid (half the size of the previous one, down to a single texel)
+    static const unsigned int kDepthPyramidLevels = 13;
     enum renderTargets {
         kColor = 0,
         kDepth,
         kNormals,
-        kTargetCount
+        kOITAccum,
+        kOITRevealage,
+        kTargetCount,                 ///< targets that can be debugged
+        kDebugTiles = kTargetCount,   ///< tiled view of all targets
+        kSceneAOV0,                   ///< extra scene outputs (kSceneAOVs layout)
+        kSceneAOV1,
+        kUpscaledColor,               ///< full resolution targets (dynamic resolution)
+        kUpscaledDepth,
+        kAccumulation,                ///< running average of jittered frames (progressive)
+        kDepthPyramid,                ///< first of the kDepthPyramidLevels min/max depth levels
+        kOverdraw = kDepthPyramid + kDepthPyramidLevels,  ///< 2^-fragments of all items (overdraw)
+        kTransparentLayers,           ///< 2^-layers of transparent items in front of the opaque depth
+        kOverdrawDepth,               ///< cleared depth of the overdraw scene render
+        kOverdrawStats                ///< first of the OverdrawStats::kLevels - 1 reductions
     };
-    enum renderOperations {
-        kSceneRender = 0,
-        kQuadRender,
-        kUIRender,
-        kHUDRender,
-        kPresentOp,
-        kOperationCount
+    /// layer counts shown by the overdraw heatmap
+    enum overdrawModes {
+        kOverdrawOff = 0,
+        kOverdrawFragments,   ///< fragments of all items, hidden or not
+        kOverdrawTransparent, ///< visible layers of transparent items
+        kOverdrawModeCount
+    };
+    /// layouts of the scene render targets (MRT)
+    enum sceneLayouts {
+        kSceneColorDepth = 0,  ///< color and depth (2 targets)
+        kSceneNormals,         ///< + normals (3 targets)
+        kSceneAOVs,            ///< + normals and two RGBA16F AOVs (5 targets)
+        kSceneLayoutCount
+    };
+    /// layouts of the normals target (G-buffer), materials need to write the matching encoding
+    enum gBufferLayouts {
+        kNormalsFull = 0,     ///< RGBA32F, xyz normals
+        kNormalsOctahedral,   ///< RG16F, octahedral encoded normals
+        kNormalsCompact,      ///< RGBA8, normals remapped to [0, 1] + roughness in alpha
+        kLayoutCount
     };
-
     /// constructors and supported drawAPIs
 	viewOverride( const MString & name );
 	~viewOverride() override;
@@ -50,19 +94,304 @@ public:
     void changeActiveTarget(unsigned int targetIdx);
     unsigned int activeTarget() { return mActiveTarget; };
     void showChannels(bool r, bool g, bool b, bool a);
+    void showTiles(bool enable);
+    bool tilesShown() { return mTilesShown; };
+    void enableOIT(bool enable);
+    bool oitEnabled() { return mOITEnabled; };
+    /// draws transparent items with their own scene render to color and depth only (without OIT)
+    void enableSplitTransparency(bool enable);
+    bool splitTransparencyEnabled() { return mSplitTransparency; };
+    void setGBufferLayout(unsigned int layout);
+    unsigned int gBufferLayout() { return mGBufferLayout; };
+    void setSceneLayout(unsigned int layout);
+    unsigned int sceneLayout() { return mSceneLayout; };
+    /// alternates the scene layouts over the next frames and reports their mean GPU times
+    void compareSceneLayouts(unsigned int layoutA, unsigned int layoutB, unsigned int frames);
+    bool comparingSceneLayouts() { return mLayoutTest.running(); };
+    ABSummary layoutComparison() { return mLayoutTest.summary(); };
+    /// measures each compiled operation disabled in turn, each G-buffer layout and each scene layout over the
+    /// given number of frames, then writes their frame times to a .json report (0 frames stops without a report)
+    MStatus benchmarkAblations(const std::string &path, unsigned int frames);
+    bool benchmarkingAblations() { return mAblation.running(); };
+    const AblationBenchmark& ablationBenchmark() { return mAblation; };
+    void enableGPUProfiler(bool enable);
+    bool gpuProfilerEnabled() { return mGPUProfiler.enabled(); };
+    void gpuPassTimes(MStringArray &passTimes);
+    FrameTimeStats& frameStats() { return mFrameStats; };
+    /// frame time budget in milliseconds that the scene resolution adapts to (0 disables)
+    void setResolutionBudget(float milliseconds);
+    float resolutionBudget() { return mScaler.budget(); };
+    float resolutionScale() { return mScaler.scale(); };
+    /// reuses the image of a panel while its camera, viewport and the scene don't change
+    void enableFrameCache(bool enable);
+    bool frameCacheEnabled() { return mFrameCacheEnabled; };
+    bool frameCached() { return mFrameCached; };  ///< the last frame reused the cached image
+    void invalidateFrameCache() { mSceneWatcher.touch(); };
+    /// refines still frames by accumulating jittered scene renders (0 disables)
+    static const unsigned int kMaxProgressiveSamples = 256;
+    void setProgressiveSamples(unsigned int samples);
+    unsigned int progressiveSamples() { return mProgressiveSamples; };
+    /// draws only the matching objects (names or patterns, e.g., "*_proxy") while the camera moves (empty disables)
+    void setProxyObjects(const MStringArray &objects);
+    const MStringArray& proxyObjects() { return mProxyPatterns; };
+    bool proxyDrawn() { return mProxyDrawn; };  ///< the last frame only drew the proxy objects
+    /// redraws only the screen rectangle of the changed shapes, up to a fraction of the viewport (0 disables)
+    void setPartialRedraw(float areaThreshold);
+    float partialRedrawThreshold() { return mPartialThreshold; };
+    float redrawnFraction() { return mRedrawnFraction; };  ///< of the viewport drawn by the last frame
+    const DirtyRect& partialRectangle() { return mPartialRect; };  ///< redrawn by the last partial frame
+    /// writes the color, depth and normals targets of the next frames to .exr or .png files (0 stops)
+    MStatus captureFrames(const std::string &path, unsigned int frames);
+    FrameCapture& frameCapture() { return mCapture; };
+    /// builds the min/max depth pyramid (Hi-Z) of the scene for screen-space effects
+    void enableDepthPyramid(bool enable);
+    bool depthPyramidEnabled() { return mDepthPyramidEnabled; };
+    /// levels built by the last frame, level i is target kDepthPyramid + i (RG32F min, max depth)
+    unsigned int depthPyramidLevels() { return mDepthPyramidLevelCount; };
+    /// size and GPU time of each level as "name widthxheight time" (time while profiling)
+    void depthPyramidTimes(MStringArray &levelTimes);
+    /// shows the layers per pixel as a heatmap, with statistics in the HUD (pixels above threshold layers)
+    void setOverdrawMode(unsigned int mode, unsigned int threshold);
+    unsigned int overdrawMode() { return mOverdrawMode; };
+    unsigned int overdrawThreshold() { return mOverdrawThreshold; };
+    /// statistics of the panel drawn last, a few frames late
+    const OverdrawSummary& overdrawSummary() { return mOverdrawStats.summary(); };
+    void enableShaderReload(bool enable);
+    bool shaderReloadEnabled() { return mShaderWatcher.running(); };
+    const TargetPool& targetPool() { return mTargetPool; };
+    unsigned long long aliasedBytes() { return mAliasedBytes; };
+    unsigned long long naiveBytes() { return mNaiveBytes; };
 protected:
     MString mEnvironment;
 	MString mUIName;
     unsigned int mActiveTarget = 0;
-    std::vector<float> mChannels = std::vector<float>{ 1.0f, 1.0f, 1.0f, 0.0f };
+    std::vector<float> mChannels;  ///< RGBA channel mask of each target (alpha shows only alpha)
+    bool mTilesShown = false;      ///< all targets side by side
+    bool mOITEnabled = false;  ///< weighted blended order-independent transparency
+    bool mSplitTransparency = true;  ///< opaque and transparent items drawn by separate scene renders
+    unsigned int mGBufferLayout = gBufferLayouts::kNormalsFull;  ///< layout of the normals target
+    unsigned int mSceneLayout = sceneLayouts::kSceneNormals;     ///< targets of the scene render
 
-    // Operations and operation names
-    MHWRender::MRenderOperation* mOperations[renderOperations::kOperationCount];
-    bool mOperationEnabled[renderOperations::kOperationCount];
+    // Render graph with the operations and the targets they read and write
+    RenderGraph mGraph;
+    int mScenePass = -1;
+    int mTransparentScenePass = -1;
+    int mOITScenePass = -1;
+    int mOITCompositePass = -1;
+    int mAccumulatePass = -1;
+    int mResolvePass = -1;
+    int mDepthPyramidPasses[kDepthPyramidLevels];
+    int mOverdrawPass = -1;
+    int mTransparentLayersPass = -1;
+    int mOverdrawStatsPasses[OverdrawStats::kLevels];
+    int mCapturePasses[FrameCapture::kSourceCount] = { -1, -1, -1 };
+    int mHeatmapPass = -1;
+    int mPartialClearPass = -1;
+    int mDebugPass = -1;
+    int mTilesPass = -1;
+    int mUpscalePass = -1;
+    int mUIPass = -1;
+    int mHUDPass = -1;
+    int mPresentPass = -1;
+    // cached shader parameters of the quad operations
+    int mAccumTexParameter = -1;
+    int mRevealageTexParameter = -1;
+    int mAccumulateInputParameter = -1;
+    int mResolveInputParameter = -1;
+    int mDepthPyramidInputParameters[kDepthPyramidLevels];
+    int mDepthPyramidSizeParameters[kDepthPyramidLevels];
+    int mOverdrawStatsInputParameters[OverdrawStats::kLevels];
+    int mOverdrawStatsSizeParameters[OverdrawStats::kLevels];
+    int mOverdrawThresholdParameter = -1;
+    int mCaptureInputParameters[FrameCapture::kSourceCount] = { -1, -1, -1 };
+    int mHeatmapInputParameter = -1;
+    int mInputTexParameter = -1;
+    int mColorChannelsParameter = -1;
+    int mDepthParameter = -1;
+    int mTileTexParameters[kTargetCount];
+    int mTileChannelsParameters[kTargetCount];
+    int mTileDepthParameter = -1;
+    int mTileNormalEncodingParameter = -1;
+    int mTileSizeParameter = -1;
+    int mTileCountParameter = -1;
+    int mUpscaleColorParameter = -1;
+    int mUpscaleDepthParameter = -1;
+    int mUpscaleScaleParameter = -1;
+    int mUpscaleSourceParameter = -1;
+    // shader permutations of the debug quad, one per debug mode
+    static const unsigned int kDebugModeCount = 10;  ///< (color, depth, 3 normals layouts) x alpha only
+    int mDebugPermutations[kDebugModeCount];
+    std::vector<MHWRender::MRenderOperation*> mOperationList;  ///< compiled passes (and timestamps) in order
     int mCurrentOperation;
 
-    // Render Targets
-    MHWRender::MRenderTargetDescription mTargetDescriptions[kTargetCount];
-    MHWRender::MRenderTarget *mTargets[kTargetCount];
-    MStatus mUpdateRenderTargets();
+    // GPU timings of the operations
+    GPUProfiler mGPUProfiler;
+    FrameTimeStats mFrameStats;  ///< CPU frame times recorded by the HUD
+
+    // A/B comparison of two scene layouts
+    ABTest mLayoutTest;
+    unsigned int mTestLayouts[2] = { 0, 0 };
+    bool mTestProfiler = false;  ///< profiler state to restore after the comparison
+    void mFinishLayoutComparison();
+
+    // Pass ablation benchmark (operations, target formats and MRT layouts measured in turn)
+    AblationBenchmark mAblation;
+    std::string mAblationPath;             ///< report, written once all configurations were measured
+    int mAblationConfig = -1;              ///< configuration of the last issued frame
+    int mAblationPass = -1;                ///< pass disabled by the last issued frame
+    bool mAblationPassEnabled = false;     ///< its state to restore
+    unsigned int mAblationLayouts[2] = { 0, 0 };  ///< G-buffer and scene layouts to restore
+    bool mAblationProfiler = false;        ///< profiler state to restore
+    std::chrono::steady_clock::time_point mAblationTime;  ///< setup of the last issued frame
+    int mStepAblation();
+    void mFinishAblation();
+
+    // Dynamic resolution of the scene targets
+    ResolutionScaler mScaler;
+    bool mScaling = false;                ///< scene targets are smaller than the viewport this frame
+    unsigned long long mScaledFrame = 0;  ///< last recorded frame the scale was updated with
+    unsigned int mScaledWidth = 0;        ///< size of the scaled viewport
+    unsigned int mScaledHeight = 0;
+    float mScaleParams[4] = { 1.0f, 1.0f, 1.0f, 1.0f };  ///< scaled / full viewport size, 1 / scaled target size
+    float mSourceSize[4] = { 1.0f, 1.0f, 0.0f, 0.0f };   ///< size of the scaled viewport (pixels)
+
+    // Frame cache and progressive accumulation of still frames
+    SceneWatcher mSceneWatcher;
+    bool mFrameCacheEnabled = false;
+    bool mFrameCached = false;  ///< only the HUD and present operations run this frame
+    unsigned int mProgressiveSamples = 0;    ///< jittered samples accumulated per still frame
+    MHWRender::MCameraOverride mJitterCamera;  ///< jittered projection of the scene renders
+    MStringArray mProxyPatterns;          ///< objects drawn while navigating
+    MSelectionList mProxySet;             ///< matching objects, rebuilt once the scene changed
+    unsigned long long mProxyVersion = 0;  ///< scene watcher version mProxySet was built at
+    bool mProxyDrawn = false;
+    float mPartialThreshold = 0.0f;    ///< largest fraction of the viewport redrawn partially
+    float mRedrawnFraction = 1.0f;
+    DirtyRect mPartialRect;            ///< pixels of the viewport redrawn by this frame
+    MFloatPoint mPartialViewportRect;  ///< normalized rectangle of the bucketed targets
+    MHWRender::MCameraOverride mCropCamera;  ///< projection cropped to the partial rectangle
+    const MSelectionList* mUpdateProxySet();
+    void mUpdateSceneWatcher();
+    static double sHalton(unsigned int index, unsigned int base);
+    struct FrameKey {
+        unsigned long long version = 0;  ///< scene watcher version
+        MMatrix viewProjection;
+        int viewport[4] = { 0, 0, 0, 0 };
+        unsigned int displayStyle = 0;
+        bool sameView(const FrameKey &other) const {
+            return viewProjection == other.viewProjection && displayStyle == other.displayStyle
+                && viewport[0] == other.viewport[0] && viewport[1] == other.viewport[1]
+                && viewport[2] == other.viewport[2] && viewport[3] == other.viewport[3];
+        }
+        bool operator==(const FrameKey &other) const { return version == other.version && sameView(other); }
+    };
+
+    // Capture of the scene targets to disk (read back a few frames late)
+    FrameCapture mCapture;
+    MFloatPoint mCaptureRects[FrameCapture::kSourceCount];  ///< sub-rectangles of the staging targets
+
+    // Depth pyramid (Hi-Z) of the scene depth
+    bool mDepthPyramidEnabled = false;
+    unsigned int mDepthPyramidLevelCount = 0;
+    unsigned int mDepthPyramidSizes[kDepthPyramidLevels + 1][2] = {};  ///< depth and level sizes (pixels)
+    MFloatPoint mDepthPyramidRects[kDepthPyramidLevels];         ///< sub-rectangles of the bucketed levels
+    static unsigned int sDepthPyramidLevels(unsigned int width, unsigned int height);
+
+    // Overdraw instrumentation (layer counts, heatmap and statistics reduced on the GPU)
+    unsigned int mOverdrawMode = overdrawModes::kOverdrawOff;
+    unsigned int mOverdrawThreshold = 4;
+    OverdrawStats mOverdrawStats;
+    unsigned int mOverdrawStatsSizes[OverdrawStats::kLevels + 1][2] = {};  ///< layer and reduction sizes (pixels)
+    MFloatPoint mOverdrawStatsRects[OverdrawStats::kLevels];             ///< sub-rectangles of the bucketed reductions
+
+    // Shader hot-reload
+    ShaderWatcher mShaderWatcher;
+    void mReloadShaders();
+
+    // Render Targets (one set per panel, keyed by the destination name)
+    struct TargetSet {
+        viewOverride *override = nullptr;
+        std::string destination;
+        bool hasPanelCallback = false;
+        MCallbackId panelCallback;  ///< releases the set when the panel is destroyed
+        std::vector<PooledTarget> pooled;             ///< indexed by graph target
+        std::vector<MHWRender::MRenderTarget*> targets;  ///< indexed by graph target
+        MFloatPoint viewportRect;  ///< normalized sub-rectangle of the bucketed targets
+        MFloatPoint scaledRect;    ///< normalized sub-rectangle of the bucketed scaled targets
+        bool cacheValid = false;   ///< the presented targets hold the image of cacheKey
+        FrameKey cacheKey;
+        bool finalImage = false;   ///< full resolution and fully accumulated
+        unsigned int samples = 0;  ///< jittered samples in the accumulation target
+        // partial redraw
+        unsigned long long drawnVersion = 0;  ///< scene version of the image before this frame
+        bool redrawable = false;              ///< the image is the full resolution scene and UI (no debug view)
+        unsigned int hudVersion = 0;          ///< HUD text drawn into the image
+        std::map<unsigned int, MBoundingBox> drawnBounds;  ///< world bounds of the changed shapes as last drawn
+    };
+    std::map<std::string, TargetSet*> mTargetSets;
+    TargetPool mTargetPool;
+    MHWRender::MRenderTarget **mTargets = nullptr;  ///< targets of the panel being drawn
+    const MFloatPoint *mViewportRect = nullptr;     ///< sub-rectangle of the panel being drawn (nullptr if full)
+    const MFloatPoint *mScaledRect = nullptr;       ///< sub-rectangle of the scaled targets (nullptr if full)
+    unsigned long long mAliasedBytes = 0;  ///< target memory of the last frame with aliasing
+    unsigned long long mNaiveBytes = 0;    ///< target memory of the last frame without aliasing
+    MStatus mUpdateRenderTargets(TargetSet *targetSet);
+    TargetSet* mFindTargetSet(const MString &destination);
+    bool mUnchanged(TargetSet *targetSet, bool &sceneChanged, bool &viewChanged);
+    bool mDirtyRegion(TargetSet *targetSet, const MMatrix &viewProjection, int width, int height, DirtyRect &rect);
+    static const MFloatPoint* sSubRectangle(const MHWRender::MRenderTargetDescription &description,
+        unsigned int width, unsigned int height, MFloatPoint &rect);
+    TargetSet* mAcquireTargetSet(const MString &destination);
+    void mReleaseTargetSet(TargetSet *targetSet);
+    MStatus mBuildGraph();
+    unsigned int mDebugMode() const;
+
+    // Frame setup: each feature configures the passes it owns before the graph is compiled
+    // (mConfigure...) and sets their targets and parameters once the targets are assigned (mUpdate...)
+    struct FrameState {
+        TargetSet *targetSet = nullptr;
+        bool unchanged = false;      ///< the panel shows the same scene and view as its last frame
+        bool sceneChanged = true;
+        bool viewChanged = true;
+        bool capturing = false;
+        bool debugShown = false;     ///< a target other than color, or a channel mask
+        bool overdrawShown = false;
+        bool refine = false;         ///< still frames are refined by progressive accumulation
+        bool resolving = false;
+        bool accumulating = false;
+        bool sceneDrawn = false;
+        bool partial = false;        ///< only the partial rectangle is redrawn
+        bool ablating = false;
+        int ablationConfig = -1;
+        int layoutSide = -1;         ///< scene layout being compared (-1 if not comparing)
+        unsigned int sceneLayout = 0;
+        int layerTarget = -1;        ///< counted by the overdraw instrumentation
+        int viewWidth = 0;
+        int viewHeight = 0;
+        bool captureSources[FrameCapture::kSourceCount] = { true, true, true };
+        const MSelectionList *proxySet = nullptr;            ///< drawn by the scene renders (nullptr for all)
+        MHWRender::MCameraOverride *sceneCamera = nullptr;  ///< of the scene renders (cropped or jittered)
+    };
+    static MHWRender::MRasterFormat sNormalsFormat(unsigned int layout);
+    void mConfigureScene(const FrameState &frame);
+    void mConfigureTransparency(const FrameState &frame);
+    void mUpdateTransparency();
+    void mConfigureProgressive(const FrameState &frame);
+    void mUpdateProgressive(const FrameState &frame);
+    void mConfigureCapture(FrameState &frame);
+    void mUpdateCapture(const FrameState &frame);
+    void mConfigureDebugViews(const FrameState &frame);
+    void mUpdateDebugViews();
+    void mConfigureDynamicResolution(const FrameState &frame);
+    void mUpdateDynamicResolution();
+    void mConfigurePartialRedraw(FrameState &frame);
+    void mUpdatePartialRedraw(const FrameState &frame);
+    void mConfigurePresentation();
+    void mConfigureDepthPyramid(const FrameState &frame);
+    void mUpdateDepthPyramid(const FrameState &frame);
+    void mConfigureOverdraw(FrameState &frame);
+    void mUpdateOverdraw(const FrameState &frame);
+    /// the compiled operations (and timestamps) to iterate, with the GPU times they resolved
+    void mListOperations(const FrameState &frame);
+    static void sPanelDestroyed(void *clientData);
 };
\ No newline at end of file
@@ -0,0 +1,531 @@
+// Title         viewOverrideCapture.cpp
+// Summary       viewOverride render target capture
+// Copyright     2020 Artineering and/or its licensors
+// License       MIT
+
+#include <cmath>
+#include <cctype>
+#include <cstdio>
+#include <cstring>
+#include <algorithm>
+#include <fstream>
+#include <maya/MIOStream.h>
+#include "viewOverrideCapture.h"
+
+/////////////////////////////////////////////////////////////////////
+/// Render target capture
+///
+/// Reading a render target back right after drawing it waits for the
+/// GPU to finish the frame, and encoding and writing the image takes
+/// longer than drawing it. Captured targets are therefore copied into a
+/// ring of staging targets and only mapped kLatency frames later, and
+/// the pixels are encoded and written on a pool of worker threads.
+///
+/// The images are written without compression and without external
+/// libraries: OpenEXR scanline files (half or float channels, as read
+/// back) and 8 bit PNG files made of stored deflate blocks. Writing
+/// uncompressed keeps the encoding as cheap as a copy, so sustained
+/// captures are bound by the disk rather than the workers. Both
+/// encoders assume a little-endian host.
+///
+/////////////////////////////////////////////////////////////////////
+
+namespace {
+    bool endsWith(const std::string &text, const std::string &suffix) {
+        if (text.size() < suffix.size()) {
+            return false;
+        }
+        for (size_t i = 0; i < suffix.size(); i++) {
+            if (tolower(text[text.size() - suffix.size() + i]) != suffix[i]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void put(std::vector<unsigned char> &file, const void *data, size_t size) {
+        const unsigned char *bytes = static_cast<const unsigned char*>(data);
+        file.insert(file.end(), bytes, bytes + size);
+    }
+
+    void put32(std::vector<unsigned char> &file, unsigned int value) {
+        put(file, &value, 4);
+    }
+
+    void putString(std::vector<unsigned char> &file, const char *text) {
+        put(file, text, strlen(text) + 1);
+    }
+
+    void putAttribute(std::vector<unsigned char> &file, const char *name, const char *type, unsigned int size) {
+        putString(file, name);
+        putString(file, type);
+        put32(file, size);
+    }
+
+    void putBigEndian(std::vector<unsigned char> &file, unsigned int value) {
+        unsigned char bytes[4] = { (unsigned char)(value >> 24), (unsigned char)(value >> 16), (unsigned char)(value >> 8), (unsigned char)value };
+        put(file, bytes, 4);
+    }
+
+    unsigned int crc32(const unsigned char *data, size_t size, unsigned int crc = 0) {
+        static unsigned int table[256];
+        static bool initialized = [] {
+            for (unsigned int n = 0; n < 256; n++) {
+                unsigned int c = n;
+                for (int k = 0; k < 8; k++) {
+                    c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+                }
+                table[n] = c;
+            }
+            return true;
+        }();
+        (void)initialized;
+        crc = ~crc;
+        for (size_t i = 0; i < size; i++) {
+            crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+        }
+        return ~crc;
+    }
+
+    void putChunk(std::vector<unsigned char> &file, const char *type, const std::vector<unsigned char> &data) {
+        putBigEndian(file, (unsigned int)data.size());
+        size_t start = file.size();
+        put(file, type, 4);
+        put(file, data.data(), data.size());
+        putBigEndian(file, crc32(&file[start], file.size() - start));
+    }
+
+    bool isHalf(MHWRender::MRasterFormat format) {
+        return format == MHWRender::kR16G16B16A16_FLOAT || format == MHWRender::kR16G16_FLOAT || format == MHWRender::kR16_FLOAT;
+    }
+
+    // value of a channel in [0, 1] for 8 bit formats, as stored otherwise
+    float channelValue(const CaptureImage &image, const unsigned char *pixel, unsigned int channel) {
+        if (isHalf(image.format)) {
+            unsigned short half;
+            memcpy(&half, pixel + channel * 2, 2);
+            return CaptureImage::halfToFloat(half);
+        }
+        if (image.format == MHWRender::kR8G8B8A8_UNORM || image.format == MHWRender::kR8_UNORM) {
+            return pixel[channel] / 255.0f;
+        }
+        float value;
+        memcpy(&value, pixel + channel * 4, 4);
+        return value;
+    }
+
+    bool encodeEXR(const CaptureImage &image, unsigned int channelCount, unsigned int pixelBytes, std::vector<unsigned char> &file) {
+        // channels are stored in alphabetical order
+        std::vector<unsigned int> order(channelCount);
+        for (unsigned int c = 0; c < channelCount; c++) {
+            order[c] = c;
+        }
+        std::sort(order.begin(), order.end(), [&image](unsigned int a, unsigned int b) { return image.channels[a] < image.channels[b]; });
+        bool half = isHalf(image.format);
+        unsigned int valueBytes = half ? 2 : 4;
+
+        const unsigned char magic[8] = { 0x76, 0x2f, 0x31, 0x01, 2, 0, 0, 0 };  // version 2, scanline
+        put(file, magic, 8);
+        putAttribute(file, "channels", "chlist", channelCount * 18 + 1);
+        for (unsigned int c : order) {
+            char name[2] = { image.channels[c], 0 };
+            put(file, name, 2);
+            put32(file, half ? 1 : 2);  // pixel type
+            put32(file, 0);             // pLinear and reserved
+            put32(file, 1);             // x and y sampling
+            put32(file, 1);
+        }
+        file.push_back(0);
+        putAttribute(file, "compression", "compression", 1);
+        file.push_back(0);  // NO_COMPRESSION
+        int window[4] = { 0, 0, (int)image.width - 1, (int)image.height - 1 };
+        putAttribute(file, "dataWindow", "box2i", 16);
+        put(file, window, 16);
+        putAttribute(file, "displayWindow", "box2i", 16);
+        put(file, window, 16);
+        putAttribute(file, "lineOrder", "lineOrder", 1);
+        file.push_back(0);  // INCREASING_Y
+        float one = 1.0f;
+        float center[2] = { 0.0f, 0.0f };
+        putAttribute(file, "pixelAspectRatio", "float", 4);
+        put(file, &one, 4);
+        putAttribute(file, "screenWindowCenter", "v2f", 8);
+        put(file, center, 8);
+        putAttribute(file, "screenWindowWidth", "float", 4);
+        put(file, &one, 4);
+        file.push_back(0);  // end of header
+
+        // offset table, followed by one chunk per scanline
+        unsigned int lineBytes = image.width * channelCount * valueBytes;
+        unsigned long long offset = file.size() + (unsigned long long)image.height * 8;
+        for (unsigned int y = 0; y < image.height; y++) {
+            put(file, &offset, 8);
+            offset += 8 + lineBytes;
+        }
+        size_t position = file.size();
+        file.resize((size_t)offset);
+        bool stored = half || image.format == MHWRender::kR32G32B32A32_FLOAT || image.format == MHWRender::kR32_FLOAT;
+        for (unsigned int y = 0; y < image.height; y++) {
+            unsigned int row = image.flip ? image.height - 1 - y : y;
+            const unsigned char *pixels = &image.data[(size_t)row * image.width * pixelBytes];
+            unsigned int header[2] = { y, lineBytes };
+            memcpy(&file[position], header, 8);
+            unsigned char *out = &file[position + 8];
+            for (unsigned int c : order) {
+                for (unsigned int x = 0; x < image.width; x++, out += valueBytes) {
+                    const unsigned char *pixel = pixels + (size_t)x * pixelBytes;
+                    if (stored) {
+                        memcpy(out, pixel + c * valueBytes, valueBytes);  // as read back
+                    } else {
+                        float value = channelValue(image, pixel, c);
+                        memcpy(out, &value, 4);
+                    }
+                }
+            }
+            position += 8 + lineBytes;
+        }
+        return true;
+    }
+
+    bool encodePNG(const CaptureImage &image, unsigned int channelCount, unsigned int pixelBytes, std::vector<unsigned char> &file) {
+        // gray, RGB (two channels with an empty blue) or RGBA
+        unsigned int fileChannels = (channelCount == 1) ? 1 : (channelCount == 4) ? 4 : 3;
+        unsigned char colorType = (fileChannels == 1) ? 0 : (fileChannels == 4) ? 6 : 2;
+        const unsigned char signature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+        put(file, signature, 8);
+        std::vector<unsigned char> header;
+        putBigEndian(header, image.width);
+        putBigEndian(header, image.height);
+        const unsigned char format[5] = { 8, colorType, 0, 0, 0 };  // bit depth, color type, deflate, filter, no interlace
+        put(header, format, 5);
+        putChunk(file, "IHDR", header);
+
+        // filtered rows (filter type 0)
+        size_t rowBytes = 1 + (size_t)image.width * fileChannels;
+        std::vector<unsigned char> raw(rowBytes * image.height, 0);
+        for (unsigned int y = 0; y < image.height; y++) {
+            unsigned int row = image.flip ? image.height - 1 - y : y;
+            const unsigned char *pixels = &image.data[(size_t)row * image.width * pixelBytes];
+            unsigned char *out = &raw[y * rowBytes + 1];
+            for (unsigned int x = 0; x < image.width; x++) {
+                for (unsigned int c = 0; c < channelCount && c < fileChannels; c++) {
+                    float value = channelValue(image, pixels + (size_t)x * pixelBytes, c) * image.scale + image.bias;
+                    out[x * fileChannels + c] = (unsigned char)(std::min(std::max(value, 0.0f), 1.0f) * 255.0f + 0.5f);
+                }
+            }
+        }
+
+        // zlib stream of stored deflate blocks
+        std::vector<unsigned char> data;
+        data.reserve(raw.size() + raw.size() / 65535 * 5 + 16);
+        data.push_back(0x78);
+        data.push_back(0x01);
+        size_t position = 0;
+        do {
+            size_t size = std::min(raw.size() - position, (size_t)65535);
+            bool last = (position + size == raw.size());
+            unsigned char block[5] = { (unsigned char)(last ? 1 : 0), (unsigned char)size, (unsigned char)(size >> 8),
+                (unsigned char)~size, (unsigned char)(~size >> 8) };
+            put(data, block, 5);
+            put(data, raw.data() + position, size);
+            position += size;
+        } while (position < raw.size());
+        unsigned int a = 1, b = 0;  // adler32
+        for (unsigned char value : raw) {
+            a = (a + value) % 65521;
+            b = (b + a) % 65521;
+        }
+        putBigEndian(data, (b << 16) | a);
+        putChunk(file, "IDAT", data);
+        putChunk(file, "IEND", std::vector<unsigned char>());
+        return true;
+    }
+}
+
+
+float CaptureImage::halfToFloat(unsigned short half) {
+    unsigned int sign = (half >> 15) & 0x1;
+    unsigned int exponent = (half >> 10) & 0x1F;
+    unsigned int mantissa = half & 0x3FF;
+    float value;
+    if (exponent == 0) {
+        value = std::ldexp((float)mantissa, -24);  // subnormal
+    } else if (exponent == 31) {
+        value = mantissa ? NAN : INFINITY;
+    } else {
+        value = std::ldexp((float)(mantissa | 0x400), (int)exponent - 25);
+    }
+    return sign ? -value : value;
+}
+
+bool CaptureImage::layout(MHWRender::MRasterFormat format, unsigned int &channelCount, unsigned int &pixelBytes) {
+    switch (format) {
+    case MHWRender::kR8G8B8A8_UNORM: channelCount = 4; pixelBytes = 4; return true;
+    case MHWRender::kR8_UNORM: channelCount = 1; pixelBytes = 1; return true;
+    case MHWRender::kR16_FLOAT: channelCount = 1; pixelBytes = 2; return true;
+    case MHWRender::kR16G16_FLOAT: channelCount = 2; pixelBytes = 4; return true;
+    case MHWRender::kR16G16B16A16_FLOAT: channelCount = 4; pixelBytes = 8; return true;
+    case MHWRender::kR32_FLOAT: channelCount = 1; pixelBytes = 4; return true;
+    case MHWRender::kR32G32B32A32_FLOAT: channelCount = 4; pixelBytes = 16; return true;
+    default: return false;
+    }
+}
+
+bool CaptureImage::encode(std::vector<unsigned char> &file, std::string &error) const {
+    file.clear();
+    unsigned int channelCount = 0;
+    unsigned int pixelBytes = 0;
+    if (!layout(format, channelCount, pixelBytes) || channels.size() != channelCount) {
+        error = "unsupported target format for " + path;
+        return false;
+    }
+    if (data.size() < (size_t)width * height * pixelBytes || width == 0 || height == 0) {
+        error = "incomplete pixels for " + path;
+        return false;
+    }
+    if (endsWith(path, ".exr")) {
+        return encodeEXR(*this, channelCount, pixelBytes, file);
+    }
+    if (endsWith(path, ".png")) {
+        return encodePNG(*this, channelCount, pixelBytes, file);
+    }
+    error = "unsupported image format for " + path + " (.exr or .png)";
+    return false;
+}
+
+
+CaptureWriter::~CaptureWriter() {
+    stop();
+}
+
+void CaptureWriter::start(unsigned int threadCount) {
+    if (running()) {
+        return;
+    }
+    if (threadCount == 0) {
+        threadCount = std::max(1u, std::thread::hardware_concurrency() / 2);
+    }
+    mStopping = false;
+    for (unsigned int i = 0; i < threadCount; i++) {
+        mThreads.push_back(std::thread(&CaptureWriter::mWorker, this));
+    }
+}
+
+void CaptureWriter::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mStopping = true;
+    }
+    mReady.notify_all();
+    for (std::thread &thread : mThreads) {
+        thread.join();
+    }
+    mThreads.clear();
+    mStopping = false;
+}
+
+bool CaptureWriter::submit(CaptureImage &image) {
+    if (!running()) {
+        start();
+    }
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        if (mQueue.size() >= kMaxQueued) {
+            mDropped++;
+            return false;
+        }
+        mQueue.push_back(CaptureImage());
+        std::swap(mQueue.back(), image);
+    }
+    mReady.notify_one();
+    return true;
+}
+
+void CaptureWriter::wait() {
+    std::unique_lock<std::mutex> lock(mMutex);
+    mIdle.wait(lock, [this] { return mQueue.empty() && mBusy == 0; });
+}
+
+unsigned int CaptureWriter::queued() {
+    std::lock_guard<std::mutex> lock(mMutex);
+    return (unsigned int)mQueue.size() + mBusy;
+}
+
+// Encodes and writes queued images until stopped, the queue is emptied before stopping
+void CaptureWriter::mWorker() {
+    std::vector<unsigned char> file;
+    while (true) {
+        CaptureImage image;
+        {
+            std::unique_lock<std::mutex> lock(mMutex);
+            mReady.wait(lock, [this] { return mStopping || !mQueue.empty(); });
+            if (mQueue.empty()) {
+                return;
+            }
+            std::swap(image, mQueue.front());
+            mQueue.pop_front();
+            mBusy++;
+        }
+        std::string error;
+        bool written = image.encode(file, error);
+        if (written) {
+            std::ofstream stream(image.path.c_str(), std::ios::out | std::ios::binary);
+            written = stream.write((const char*)file.data(), file.size()).good();
+            if (!written) {
+                error = "could not write " + image.path;
+            }
+        }
+        if (written) {
+            mWritten++;
+        } else {
+            mFailed++;
+            cerr << "Capture not written, " << error.c_str() << endl;
+        }
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mBusy--;
+        }
+        mIdle.notify_all();
+    }
+}
+
+
+bool FrameCapture::start(const std::string &path, unsigned int frames, std::string &error) {
+    stop();
+    if (frames == 0) {
+        return true;
+    }
+    if (!endsWith(path, ".exr") && !endsWith(path, ".png")) {
+        error = "unsupported image format for " + path + " (.exr or .png)";
+        return false;
+    }
+    mPath = path.substr(0, path.size() - 4);
+    mExtension = path.substr(path.size() - 4);
+    mFramesLeft = frames;
+    mNextFrame = 1;
+    return true;
+}
+
+void FrameCapture::stop() {
+    // oldest slot first
+    for (unsigned int i = 1; i <= kLatency; i++) {
+        Slot &slot = mSlots[(mSlot + i) % kLatency];
+        if (slot.pending) {
+            mReadBack(slot);
+        }
+    }
+    mFramesLeft = 0;
+    mDestination.clear();
+}
+
+unsigned int FrameCapture::framesInFlight() const {
+    unsigned int frames = 0;
+    for (unsigned int i = 0; i < kLatency; i++) {
+        frames += mSlots[i].pending ? 1 : 0;
+    }
+    return frames;
+}
+
+bool FrameCapture::beginFrame(const std::string &destination, TargetPool &pool, unsigned int width, unsigned int height,
+    const MHWRender::MRasterFormat formats[kSourceCount], const bool sources[kSourceCount], bool signedNormals) {
+    if (!active()) {
+        return false;
+    }
+    if (mDestination.empty()) {
+        mDestination = destination;
+    } else if (destination != mDestination) {
+        return false;  // other panels
+    }
+    mSlot = (mSlot + 1) % kLatency;
+    Slot &slot = mSlots[mSlot];
+    if (slot.pending) {
+        mReadBack(slot);
+    }
+    if (mFramesLeft == 0) {
+        if (!active()) {
+            mDestination.clear();
+            release(pool);
+        }
+        return false;
+    }
+
+    // staging targets of the slot, sized to the captured viewport
+    static const char *names[kSourceCount] = { "captureColorTarget", "captureDepthTarget", "captureNormalsTarget" };
+    for (unsigned int s = 0; s < kSourceCount; s++) {
+        PooledTarget &staging = slot.staging[s];
+        slot.sources[s] = sources[s];
+        if (!sources[s]) {
+            continue;
+        }
+        if (!staging.target) {
+            MString name = MString(names[s]) + MString(std::to_string(mSlot).c_str());
+            pool.acquire(staging, MHWRender::MRenderTargetDescription(name, width, height, 0, formats[s], 1, false));
+        } else {
+            pool.setFormat(staging, formats[s]);
+            pool.fit(staging, width, height);
+        }
+    }
+    slot.pending = true;
+    slot.frame = mNextFrame++;
+    slot.width = width;
+    slot.height = height;
+    slot.signedNormals = signedNormals;
+    mFramesLeft--;
+    mFramesCaptured++;
+    return true;
+}
+
+void FrameCapture::release(TargetPool &pool) {
+    for (unsigned int i = 0; i < kLatency; i++) {
+        for (unsigned int s = 0; s < kSourceCount; s++) {
+            pool.release(mSlots[i].staging[s]);
+        }
+        mSlots[i].pending = false;
+    }
+}
+
+// Maps the staging targets of the slot and queues their captured rectangle to be written
+void FrameCapture::mReadBack(Slot &slot) {
+    static const char *sourceNames[kSourceCount] = { "color", "depth", "normals" };
+    bool openGL = MHWRender::MRenderer::theRenderer()->drawAPIIsOpenGL();
+    for (unsigned int s = 0; s < kSourceCount; s++) {
+        const PooledTarget &staging = slot.staging[s];
+        unsigned int channelCount = 0;
+        unsigned int pixelBytes = 0;
+        if (!slot.sources[s] || !staging.target || !CaptureImage::layout(staging.description.rasterFormat(), channelCount, pixelBytes)) {
+            continue;
+        }
+        int rowPitch = 0;
+        size_t slicePitch = 0;
+        unsigned char *raw = static_cast<unsigned char*>(staging.target->rawData(rowPitch, slicePitch));
+        if (!raw) {
+            cerr << "Capture of the " << sourceNames[s] << " target failed, could not read it back" << endl;
+            continue;
+        }
+        CaptureImage image;
+        image.path = mFileName(sourceNames[s], slot.frame);
+        image.channels = (s == kDepthSource) ? "Z" : (channelCount == 4) ? "RGBA" : (channelCount == 2) ? "RG" : "R";
+        image.format = staging.description.rasterFormat();
+        image.width = std::min(slot.width, staging.description.width());
+        image.height = std::min(slot.height, staging.description.height());
+        image.flip = openGL;  // the captured rectangle starts at the bottom row
+        if (s == kNormalsSource && slot.signedNormals) {
+            image.scale = 0.5f;
+            image.bias = 0.5f;
+        }
+        size_t rowBytes = (size_t)image.width * pixelBytes;
+        image.data.resize(rowBytes * image.height);
+        for (unsigned int y = 0; y < image.height && (size_t)rowPitch >= rowBytes; y++) {
+            memcpy(&image.data[y * rowBytes], raw + (size_t)y * rowPitch, rowBytes);
+        }
+        MHWRender::MRenderTarget::freeRawData(raw);
+        mWriter.submit(image);
+    }
+    slot.pending = false;
+}
+
+std::string FrameCapture::mFileName(const char *source, unsigned int frame) const {
+    char number[16];
+    snprintf(number, sizeof(number), "%04u", frame);
+    return mPath + "." + source + "." + number + mExtension;
+}
@@ -0,0 +1,146 @@
+// Title         viewOverrideCapture.h
+// Summary       viewOverride render target capture declaration
+// Copyright     2020 Artineering and/or its licensors
+// License       MIT
+
+#pragma once
+#include <mutex>
+#include <deque>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+#include <condition_variable>
+#include <maya/MViewport2Renderer.h>
+#include <maya/MRenderTargetManager.h>
+#include "viewOverrideTargetPool.h"
+
+/// Pixels of a target read back by the FrameCapture, written to disk by the CaptureWriter
+struct CaptureImage {
+    std::string path;          ///< file to write, encoded by extension (.exr or .png)
+    std::string channels;      ///< channel names in pixel order (e.g., "RGBA" or "Z")
+    MHWRender::MRasterFormat format = MHWRender::kR8G8B8A8_UNORM;
+    unsigned int width = 0;
+    unsigned int height = 0;
+    bool flip = false;         ///< rows are stored bottom-up (OpenGL)
+    float scale = 1.0f;        ///< remap of the values into [0, 1] for 8 bit files (e.g., signed normals)
+    float bias = 0.0f;
+    std::vector<unsigned char> data;  ///< tightly packed rows
+
+    /// encodes the image as an uncompressed OpenEXR or PNG (stored deflate) file
+    bool encode(std::vector<unsigned char> &file, std::string &error) const;
+    /// number of channels and bytes per pixel of the supported formats (false if unsupported)
+    static bool layout(MHWRender::MRasterFormat format, unsigned int &channelCount, unsigned int &pixelBytes);
+    static float halfToFloat(unsigned short half);
+};
+
+
+/// Image writer thread pool
+///
+/// Encodes and writes the captured images on worker threads, so that the
+/// viewport only copies the pixels. The queue is bounded: images submitted
+/// while it is full are dropped (and counted) instead of stalling the viewport.
+class CaptureWriter {
+public:
+    static const unsigned int kMaxQueued = 48;  ///< images waiting to be written
+
+    CaptureWriter() {}
+    ~CaptureWriter();
+
+    /// starts the workers (half the hardware threads if 0)
+    void start(unsigned int threadCount = 0);
+    /// writes the queued images and joins the workers
+    void stop();
+    bool running() const { return !mThreads.empty(); }
+    /// queues the image (starting the workers if needed), returns false if it was dropped
+    bool submit(CaptureImage &image);
+    /// blocks until all queued images are written
+    void wait();
+
+    unsigned int queued();
+    unsigned long long written() const { return mWritten; }
+    unsigned long long failed() const { return mFailed; }
+    unsigned long long dropped() const { return mDropped; }
+
+protected:
+    std::vector<std::thread> mThreads;
+    std::mutex mMutex;                      ///< guards the queue and mBusy
+    std::condition_variable mReady;         ///< signaled on new images and stop
+    std::condition_variable mIdle;          ///< signaled when an image was written
+    std::deque<CaptureImage> mQueue;
+    unsigned int mBusy = 0;                 ///< images being encoded
+    bool mStopping = false;
+    std::atomic<unsigned long long> mWritten{ 0 };
+    std::atomic<unsigned long long> mFailed{ 0 };
+    std::atomic<unsigned long long> mDropped{ 0 };
+
+    void mWorker();
+};
+
+
+/// Asynchronous capture of the scene targets
+///
+/// Every captured frame, a copy operation per source target draws into a
+/// staging target of the current ring slot. The slot is only read back when
+/// it comes around again, kLatency frames later, when the GPU is long done
+/// with the copy, so mapping it never stalls the pipeline. The read pixels
+/// are handed to the CaptureWriter and the staging targets are reused.
+class FrameCapture {
+public:
+    static const unsigned int kLatency = 3;  ///< frames between copying a target and reading it back
+    enum sources {
+        kColorSource = 0,
+        kDepthSource,
+        kNormalsSource,
+        kSourceCount
+    };
+
+    FrameCapture() {}
+    ~FrameCapture() {}
+
+    /// captures the next frames of the first panel drawn into files named after the path,
+    /// e.g., "shot.exr" writes shot.color.0001.exr, shot.depth.0001.exr and shot.normals.0001.exr
+    bool start(const std::string &path, unsigned int frames, std::string &error);
+    /// reads back the frames in flight (waiting for the GPU) and stops capturing
+    void stop();
+    /// frames left to capture
+    unsigned int framesLeft() const { return mFramesLeft; }
+    /// frames copied but not read back yet, the panel needs to be drawn kLatency more times
+    unsigned int framesInFlight() const;
+    bool active() const { return mFramesLeft > 0 || framesInFlight() > 0; }
+    const std::string& destination() const { return mDestination; }
+
+    /// reads back the slot copied kLatency frames ago and returns true if this frame of the
+    /// destination is captured, in which case the copies of the sources draw into staging(source)
+    bool beginFrame(const std::string &destination, TargetPool &pool, unsigned int width, unsigned int height,
+        const MHWRender::MRasterFormat formats[kSourceCount], const bool sources[kSourceCount], bool signedNormals);
+    const PooledTarget& staging(unsigned int source) const { return mSlots[mSlot].staging[source]; }
+    /// releases the staging targets (done once all frames are read back)
+    void release(TargetPool &pool);
+
+    CaptureWriter& writer() { return mWriter; }
+    unsigned long long framesCaptured() const { return mFramesCaptured; }
+
+protected:
+    struct Slot {
+        bool pending = false;       ///< copied, waiting to be read back
+        unsigned int frame = 0;     ///< frame number of the file names
+        unsigned int width = 0;
+        unsigned int height = 0;
+        bool signedNormals = false;
+        bool sources[kSourceCount] = { false, false, false };  ///< targets copied into the staging targets
+        PooledTarget staging[kSourceCount];
+    };
+    Slot mSlots[kLatency];
+    unsigned int mSlot = 0;          ///< slot of the frame being drawn
+    std::string mPath;               ///< path without extension
+    std::string mExtension;          ///< ".exr" or ".png"
+    std::string mDestination;        ///< panel being captured
+    unsigned int mFramesLeft = 0;
+    unsigned int mNextFrame = 1;
+    unsigned long long mFramesCaptured = 0;
+    CaptureWriter mWriter;
+
+    void mReadBack(Slot &slot);
+    std::string mFileName(const char *source, unsigned int frame) const;
+};
@@ -16,7 +16,82 @@
 ///     refreshes the shaders in the quadRender
 ///
 /// viewOverride -c bool bool bool bool
-///     modifies the channels (RGBA) to show
+///     modifies the channels (RGBA) to show of the active target
+///
+/// viewOverride -tl bool
+///     shows all render targets side by side
+///
+/// viewOverride -oit bool
+///     enables weighted blended order-independent transparency
+///
+/// viewOverride -sts bool
+///     draws transparent items with a second scene render to color and depth only (default)
+///
+/// viewOverride -ps
+///     returns the render target pool statistics (hits, misses, bytes held)
+///
+/// viewOverride -tm
+///     returns the target memory of the last frame (aliased, naive)
+///
+/// viewOverride -gb unsigned int
+///     changes the layout of the normals target (0: RGBA32F, 1: RG16F octahedral, 2: RGBA8 + roughness)
+///
+/// viewOverride -mrt unsigned int
+///     changes the targets of the scene render (0: color + depth, 1: + normals, 2: + normals + 2 AOVs)
+///
+/// viewOverride -ab unsigned int unsigned int unsigned int
+///     alternates two scene render layouts over the given number of frames and prints their mean GPU time
+///     query returns the last comparison (framesA, msA, framesB, msB, all operations msA, msB)
+///
+/// viewOverride -pab string unsigned int
+///     measures each operation disabled in turn, each G-buffer layout and each scene render layout over the
+///     given number of frames, then writes their CPU and GPU frame times to a .json file (0 frames stops)
+///     query returns the configuration being measured and the number of configurations (-1 0 when done)
+///
+/// viewOverride -gpu bool
+///     enables the GPU profiler (GPU time of each operation in the HUD)
+///
+/// viewOverride -gt
+///     returns the GPU time of each operation in milliseconds ("name time")
+///
+/// viewOverride -hr bool
+///     reloads the quad shaders when their files change
+///
+/// viewOverride -stats string
+///     exports the frame time statistics to a .json or .csv file
+///     query returns the frame time percentiles and hitches (p50, p95, p99, max, hitches)
+///
+/// viewOverride -drs float
+///     renders the scene at a lower resolution to meet a frame time budget in milliseconds (0 disables)
+///     query returns the budget and the current resolution scale
+///
+/// viewOverride -fc bool
+///     reuses the image of panels whose camera, size and scene didn't change since they were drawn
+///
+/// viewOverride -pa unsigned int
+///     refines still frames by accumulating the given number of jittered scene renders (0 disables)
+///
+/// viewOverride -cap string unsigned int
+///     writes the color, depth and normals targets of the next frames to .exr or .png files (0 frames stops)
+///     query returns the frames left, frames being read back, images queued, written, dropped and failed
+///
+/// viewOverride -hiz bool
+///     builds the min/max depth pyramid (Hi-Z) of the scene depth
+///     query returns the size and GPU time of each level ("name widthxheight time")
+///
+/// viewOverride -od unsigned int unsigned int
+///     shows the layers per pixel as a heatmap: 0 off, 1 all fragments (overdraw), 2 transparent layers,
+///     with the share of pixels above the given number of layers in the HUD
+///     query returns the mode, threshold, mean and max layers and the fraction of pixels above the threshold
+///
+/// viewOverride -px string
+///     only draws the objects matching the space separated names or patterns while the camera moves ("" disables)
+///     query returns the names or patterns
+///
+/// viewOverride -pr float
+///     redraws only the screen rectangle of the shapes that changed, if it covers at most the given
+///     fraction of the viewport (0 disables)
+///     query returns the fraction and the fraction of the viewport redrawn by the last frame
 ///
 /////////////////////////////////////////////////////////////////////
 
@@ -27,6 +102,48 @@ const char *refreshSN = "-r";
 const char *refreshLN = "-refresh";
 const char *channelsSN = "-c";
 const char *channelsLN = "-channel";
+const char *tilesSN = "-tl";
+const char *tilesLN = "-tiles";
+const char *oitSN = "-oit";
+const char *oitLN = "-orderIndependentTransparency";
+const char *splitTransparencySN = "-sts";
+const char *splitTransparencyLN = "-splitTransparency";
+const char *poolStatsSN = "-ps";
+const char *poolStatsLN = "-poolStats";
+const char *targetMemorySN = "-tm";
+const char *targetMemoryLN = "-targetMemory";
+const char *gBufferSN = "-gb";
+const char *gBufferLN = "-gBufferLayout";
+const char *sceneLayoutSN = "-mrt";
+const char *sceneLayoutLN = "-mrtLayout";
+const char *layoutTestSN = "-ab";
+const char *layoutTestLN = "-abLayouts";
+const char *ablationSN = "-pab";
+const char *ablationLN = "-passAblation";
+const char *gpuProfilerSN = "-gpu";
+const char *gpuProfilerLN = "-gpuProfiler";
+const char *gpuTimesSN = "-gt";
+const char *gpuTimesLN = "-gpuTimes";
+const char *hotReloadSN = "-hr";
+const char *hotReloadLN = "-hotReload";
+const char *statsSN = "-st";
+const char *statsLN = "-stats";
+const char *dynamicResolutionSN = "-drs";
+const char *dynamicResolutionLN = "-dynamicResolution";
+const char *frameCacheSN = "-fc";
+const char *frameCacheLN = "-frameCache";
+const char *progressiveSN = "-pa";
+const char *progressiveLN = "-progressiveAccumulation";
+const char *captureSN = "-cap";
+const char *captureLN = "-capture";
+const char *depthPyramidSN = "-hiz";
+const char *depthPyramidLN = "-depthPyramid";
+const char *overdrawSN = "-od";
+const char *overdrawLN = "-overdraw";
+const char *proxySN = "-px";
+const char *proxyLN = "-proxy";
+const char *partialRedrawSN = "-pr";
+const char *partialRedrawLN = "-partialRedraw";
 
 
 /// constructor and destructor
@@ -51,6 +168,46 @@ MSyntax Cmd::newSyntax() {
     syntax.addFlag(refreshSN, refreshLN, MSyntax::kNoArg);
     // style channel flag
     syntax.addFlag(channelsSN, channelsLN, MSyntax::kBoolean, MSyntax::kBoolean, MSyntax::kBoolean, MSyntax::kBoolean);
+    // tiled debug view flag
+    syntax.addFlag(tilesSN, tilesLN, MSyntax::kBoolean);
+    // order-independent transparency flag
+    syntax.addFlag(oitSN, oitLN, MSyntax::kBoolean);
+    // split transparency flag
+    syntax.addFlag(splitTransparencySN, splitTransparencyLN, MSyntax::kBoolean);
+    // render target pool statistics flag
+    syntax.addFlag(poolStatsSN, poolStatsLN, MSyntax::kNoArg);
+    // target memory flag
+    syntax.addFlag(targetMemorySN, targetMemoryLN, MSyntax::kNoArg);
+    // G-buffer layout flag
+    syntax.addFlag(gBufferSN, gBufferLN, MSyntax::kUnsigned);
+    // scene render target layout flags
+    syntax.addFlag(sceneLayoutSN, sceneLayoutLN, MSyntax::kUnsigned);
+    syntax.addFlag(layoutTestSN, layoutTestLN, MSyntax::kUnsigned, MSyntax::kUnsigned, MSyntax::kUnsigned);
+    // pass ablation benchmark flag
+    syntax.addFlag(ablationSN, ablationLN, MSyntax::kString, MSyntax::kUnsigned);
+    // GPU profiler flags
+    syntax.addFlag(gpuProfilerSN, gpuProfilerLN, MSyntax::kBoolean);
+    syntax.addFlag(gpuTimesSN, gpuTimesLN, MSyntax::kNoArg);
+    // shader hot-reload flag
+    syntax.addFlag(hotReloadSN, hotReloadLN, MSyntax::kBoolean);
+    // frame time statistics flag
+    syntax.addFlag(statsSN, statsLN, MSyntax::kString);
+    // dynamic resolution flag
+    syntax.addFlag(dynamicResolutionSN, dynamicResolutionLN, MSyntax::kDouble);
+    // frame cache flag
+    syntax.addFlag(frameCacheSN, frameCacheLN, MSyntax::kBoolean);
+    // progressive accumulation flag
+    syntax.addFlag(progressiveSN, progressiveLN, MSyntax::kUnsigned);
+    // capture flag
+    syntax.addFlag(captureSN, captureLN, MSyntax::kString, MSyntax::kUnsigned);
+    // depth pyramid flag
+    syntax.addFlag(depthPyramidSN, depthPyramidLN, MSyntax::kBoolean);
+    // overdraw flag
+    syntax.addFlag(overdrawSN, overdrawLN, MSyntax::kUnsigned, MSyntax::kUnsigned);
+    // proxy objects flag
+    syntax.addFlag(proxySN, proxyLN, MSyntax::kString);
+    // partial redraw flag
+    syntax.addFlag(partialRedrawSN, partialRedrawLN, MSyntax::kDouble);
     return syntax;
 };
 
@@ -94,6 +251,309 @@ MStatus Cmd::doIt(const MArgList& args) {
         cout << "( " << r << ", " << g << ", " << b << ", " << a << ")" << endl;
         override->showChannels(r, g, b, a);
     }
+    // check for tiled debug view flag
+    if (argData.isFlagSet(tilesSN)) {
+        if (query) {
+            setResult(override->tilesShown());
+        }
+        else {
+            bool enable;
+            argData.getFlagArgument(tilesSN, 0, enable);
+            override->showTiles(enable);
+        }
+    }
+    // check for order-independent transparency flag
+    if (argData.isFlagSet(oitSN)) {
+        if (query) {
+            setResult(override->oitEnabled());
+        }
+        else {
+            bool enable;
+            argData.getFlagArgument(oitSN, 0, enable);
+            override->enableOIT(enable);
+        }
+    }
+    // check for split transparency flag
+    if (argData.isFlagSet(splitTransparencySN)) {
+        if (query) {
+            setResult(override->splitTransparencyEnabled());
+        }
+        else {
+            bool enable;
+            argData.getFlagArgument(splitTransparencySN, 0, enable);
+            override->enableSplitTransparency(enable);
+        }
+    }
+    // check if the render target pool statistics are requested
+    if (argData.isFlagSet(poolStatsSN)) {
+        const TargetPool& pool = override->targetPool();
+        clearResult();
+        appendToResult((double)pool.hits());
+        appendToResult((double)pool.misses());
+        appendToResult((double)pool.bytesHeld());
+    }
+    // check if the target memory with and without aliasing is requested
+    if (argData.isFlagSet(targetMemorySN)) {
+        clearResult();
+        appendToResult((double)override->aliasedBytes());
+        appendToResult((double)override->naiveBytes());
+    }
+    // check for G-buffer layout flag
+    if (argData.isFlagSet(gBufferSN)) {
+        if (query) {
+            setResult(override->gBufferLayout());
+        }
+        else {
+            unsigned int layout;
+            argData.getFlagArgument(gBufferSN, 0, layout);
+            override->setGBufferLayout(layout);
+        }
+    }
+    // check for scene render target layout flag
+    if (argData.isFlagSet(sceneLayoutSN)) {
+        if (query) {
+            setResult(override->sceneLayout());
+        }
+        else {
+            unsigned int layout;
+            argData.getFlagArgument(sceneLayoutSN, 0, layout);
+            override->setSceneLayout(layout);
+        }
+    }
+    // check for scene layout comparison flag
+    if (argData.isFlagSet(layoutTestSN)) {
+        if (query) {
+            ABSummary comparison = override->layoutComparison();
+            clearResult();
+            appendToResult((double)comparison.frames[0]);
+            appendToResult(comparison.sceneTime[0]);
+            appendToResult((double)comparison.frames[1]);
+            appendToResult(comparison.sceneTime[1]);
+            appendToResult(comparison.frameTime[0]);
+            appendToResult(comparison.frameTime[1]);
+        }
+        else {
+            unsigned int layoutA, layoutB, frames;
+            argData.getFlagArgument(layoutTestSN, 0, layoutA);
+            argData.getFlagArgument(layoutTestSN, 1, layoutB);
+            argData.getFlagArgument(layoutTestSN, 2, frames);
+            override->compareSceneLayouts(layoutA, layoutB, frames);
+        }
+    }
+    // check for pass ablation benchmark flag
+    if (argData.isFlagSet(ablationSN)) {
+        if (query) {
+            const AblationBenchmark &benchmark = override->ablationBenchmark();
+            bool running = override->benchmarkingAblations();
+            clearResult();
+            appendToResult(running ? (double)benchmark.currentConfig() : -1.0);
+            appendToResult(running ? (double)benchmark.configCount() : 0.0);
+        }
+        else {
+            MString path;
+            unsigned int frames;
+            argData.getFlagArgument(ablationSN, 0, path);
+            argData.getFlagArgument(ablationSN, 1, frames);
+            status = override->benchmarkAblations(path.asChar(), frames);
+            CHECK_MSTATUS_AND_RETURN_IT(status);
+        }
+    }
+    // check for GPU profiler flag
+    if (argData.isFlagSet(gpuProfilerSN)) {
+        if (query) {
+            setResult(override->gpuProfilerEnabled());
+        }
+        else {
+            bool enable;
+            argData.getFlagArgument(gpuProfilerSN, 0, enable);
+            override->enableGPUProfiler(enable);
+        }
+    }
+    // check if the GPU times are requested
+    if (argData.isFlagSet(gpuTimesSN)) {
+        MStringArray passTimes;
+        override->gpuPassTimes(passTimes);
+        clearResult();
+        for (unsigned int i = 0; i < passTimes.length(); i++) {
+            appendToResult(passTimes[i]);
+        }
+    }
+    // check for shader hot-reload flag
+    if (argData.isFlagSet(hotReloadSN)) {
+        if (query) {
+            setResult(override->shaderReloadEnabled());
+        }
+        else {
+            bool enable;
+            argData.getFlagArgument(hotReloadSN, 0, enable);
+            override->enableShaderReload(enable);
+        }
+    }
+    // check for frame time statistics flag
+    if (argData.isFlagSet(statsSN)) {
+        if (query) {
+            FrameTimeSummary stats = override->frameStats().summary();
+            clearResult();
+            appendToResult((double)stats.p50);
+            appendToResult((double)stats.p95);
+            appendToResult((double)stats.p99);
+            appendToResult((double)stats.max);
+            appendToResult((double)stats.hitches);
+        }
+        else {
+            MString path;
+            argData.getFlagArgument(statsSN, 0, path);
+            if (!override->frameStats().exportStats(path.asChar())) {
+                cerr << "Frame time statistics could not be exported to " << path << endl;
+                return MStatus::kFailure;
+            }
+            cout << "Frame time statistics exported to " << path << endl;
+        }
+    }
+    // check for dynamic resolution flag
+    if (argData.isFlagSet(dynamicResolutionSN)) {
+        if (query) {
+            clearResult();
+            appendToResult((double)override->resolutionBudget());
+            appendToResult((double)override->resolutionScale());
+        }
+        else {
+            double budget;
+            argData.getFlagArgument(dynamicResolutionSN, 0, budget);
+            override->setResolutionBudget((float)budget);
+        }
+    }
+    // check for frame cache flag
+    if (argData.isFlagSet(frameCacheSN)) {
+        if (query) {
+            setResult(override->frameCacheEnabled());
+        }
+        else {
+            bool enable;
+            argData.getFlagArgument(frameCacheSN, 0, enable);
+            override->enableFrameCache(enable);
+        }
+    }
+    // check for progressive accumulation flag
+    if (argData.isFlagSet(progressiveSN)) {
+        if (query) {
+            setResult(override->progressiveSamples());
+        }
+        else {
+            unsigned int samples;
+            argData.getFlagArgument(progressiveSN, 0, samples);
+            override->setProgressiveSamples(samples);
+        }
+    }
+    // check for capture flag
+    if (argData.isFlagSet(captureSN)) {
+        if (query) {
+            FrameCapture &capture = override->frameCapture();
+            clearResult();
+            appendToResult((double)capture.framesLeft());
+            appendToResult((double)capture.framesInFlight());
+            appendToResult((double)capture.writer().queued());
+            appendToResult((double)capture.writer().written());
+            appendToResult((double)capture.writer().dropped());
+            appendToResult((double)capture.writer().failed());
+        }
+        else {
+            MString path;
+            unsigned int frames;
+            argData.getFlagArgument(captureSN, 0, path);
+            argData.getFlagArgument(captureSN, 1, frames);
+            status = override->captureFrames(path.asChar(), frames);
+            CHECK_MSTATUS_AND_RETURN_IT(status);
+        }
+    }
+    // check for depth pyramid flag
+    if (argData.isFlagSet(depthPyramidSN)) {
+        if (query) {
+            MStringArray levelTimes;
+            override->depthPyramidTimes(levelTimes);
+            clearResult();
+            for (unsigned int i = 0; i < levelTimes.length(); i++) {
+                appendToResult(levelTimes[i]);
+            }
+        }
+        else {
+            bool enable;
+            argData.getFlagArgument(depthPyramidSN, 0, enable);
+            override->enableDepthPyramid(enable);
+        }
+    }
+    // check for overdraw flag
+    if (argData.isFlagSet(overdrawSN)) {
+        if (query) {
+            const OverdrawSummary &summary = override->overdrawSummary();
+            clearResult();
+            appendToResult((double)override->overdrawMode());
+            appendToResult((double)override->overdrawThreshold());
+            appendToResult((double)summary.meanLayers);
+            appendToResult((double)summary.maxLayers);
+            appendToResult((double)summary.aboveFraction);
+        }
+        else {
+            unsigned int mode, threshold;
+            argData.getFlagArgument(overdrawSN, 0, mode);
+            argData.getFlagArgument(overdrawSN, 1, threshold);
+            override->setOverdrawMode(mode, threshold);
+        }
+    }
+    // check for proxy objects flag
+    if (argData.isFlagSet(proxySN)) {
+        if (query) {
+            const MStringArray &patterns = override->proxyObjects();
+            clearResult();
+            for (unsigned int i = 0; i < patterns.length(); i++) {
+                appendToResult(patterns[i]);
+            }
+        }
+        else {
+            MString objects;
+            argData.getFlagArgument(proxySN, 0, objects);
+            MStringArray patterns;
+            objects.split(' ', patterns);
+            override->setProxyObjects(patterns);
+        }
+    }
+    // check for partial redraw flag
+    if (argData.isFlagSet(partialRedrawSN)) {
+        if (query) {
+            clearResult();
+            appendToResult((double)override->partialRedrawThreshold());
+            appendToResult((double)override->redrawnFraction());
+        }
+        else {
+            double threshold;
+            argData.getFlagArgument(partialRedrawSN, 0, threshold);
+            override->setPartialRedraw((float)threshold);
+        }
+    }
+
+    // settings changed through the command need the panels to be drawn again, captures and
+    // benchmarks draw their own frames once started, and reports leave the panels as they are
+    if (query) {
+        return MS::kSuccess;
+    }
+    const char *settingFlags[] = { targetSN, refreshSN, channelsSN, tilesSN, oitSN, splitTransparencySN, gBufferSN,
+        sceneLayoutSN, gpuProfilerSN, dynamicResolutionSN, frameCacheSN, progressiveSN, depthPyramidSN, overdrawSN,
+        proxySN, partialRedrawSN };
+    const char *startFlags[] = { layoutTestSN, ablationSN, captureSN };
+    bool settingChanged = false;
+    for (const char *flag : settingFlags) {
+        settingChanged = settingChanged || argData.isFlagSet(flag);
+    }
+    bool started = false;
+    for (const char *flag : startFlags) {
+        started = started || argData.isFlagSet(flag);
+    }
+    if (settingChanged) {
+        override->invalidateFrameCache();
+    }
+    if (!settingChanged && !started) {
+        return MS::kSuccess;
+    }
 
     return redoIt();  // normally a command should execute here
 };
@@ -0,0 +1,109 @@
+// Title         viewOverrideDirtyRegion.cpp
+// Summary       viewOverride partial redraw region
+// Copyright     2020 Artineering and/or its licensors
+// License       MIT
+
+#include <cmath>
+#include <algorithm>
+#include <maya/MDagPath.h>
+#include <maya/MFnDagNode.h>
+#include "viewOverrideDirtyRegion.h"
+
+/////////////////////////////////////////////////////////////////////
+/// Partial redraw region
+///
+/// Projections use Maya's row vector convention (p' = p * M), the
+/// corners of the bounds are projected to clip space and divided by w.
+/// Bounds reaching behind the camera can't be projected to a finite
+/// rectangle, which the caller answers with a full redraw.
+///
+/////////////////////////////////////////////////////////////////////
+
+void DirtyRect::merge(const DirtyRect &rect) {
+    if (rect.empty()) {
+        return;
+    }
+    if (empty()) {
+        *this = rect;
+        return;
+    }
+    int right = std::max(x + width, rect.x + rect.width);
+    int top = std::max(y + height, rect.y + rect.height);
+    x = std::min(x, rect.x);
+    y = std::min(y, rect.y);
+    width = right - x;
+    height = top - y;
+}
+
+void DirtyRect::pad(int pixels, int viewWidth, int viewHeight) {
+    if (empty()) {
+        return;
+    }
+    int right = std::min(x + width + pixels, viewWidth);
+    int top = std::min(y + height + pixels, viewHeight);
+    x = std::max(x - pixels, 0);
+    y = std::max(y - pixels, 0);
+    width = right - x;
+    height = top - y;
+}
+
+bool DirtyRegion::worldBounds(const MObjectHandle &shape, MBoundingBox &bounds) {
+    if (!shape.isAlive()) {
+        return false;
+    }
+    MStatus status;
+    MFnDagNode dagNode(shape.objectRef(), &status);
+    MDagPath path;
+    if (status != MS::kSuccess || dagNode.getPath(path) != MS::kSuccess) {
+        return false;
+    }
+    bounds = dagNode.boundingBox();  // object space of the shape
+    bounds.transformUsing(path.inclusiveMatrix());
+    return true;
+}
+
+bool DirtyRegion::project(const MBoundingBox &bounds, const MMatrix &viewProjection, int width, int height, DirtyRect &rect) {
+    const MPoint lo = bounds.min();
+    const MPoint hi = bounds.max();
+    double minX = 1.0, minY = 1.0, maxX = -1.0, maxY = -1.0;
+    for (int i = 0; i < 8; i++) {
+        double p[3] = { (i & 1) ? hi.x : lo.x, (i & 2) ? hi.y : lo.y, (i & 4) ? hi.z : lo.z };
+        double clip[4];
+        for (int c = 0; c < 4; c++) {
+            clip[c] = p[0] * viewProjection(0, c) + p[1] * viewProjection(1, c) + p[2] * viewProjection(2, c) + viewProjection(3, c);
+        }
+        if (clip[3] <= 1.0e-6) {
+            return false;
+        }
+        double ndcX = clip[0] / clip[3];
+        double ndcY = clip[1] / clip[3];
+        minX = (i == 0) ? ndcX : std::min(minX, ndcX);
+        minY = (i == 0) ? ndcY : std::min(minY, ndcY);
+        maxX = (i == 0) ? ndcX : std::max(maxX, ndcX);
+        maxY = (i == 0) ? ndcY : std::max(maxY, ndcY);
+    }
+    // pixels touched by [-1, 1] coordinates, within the viewport (empty if outside)
+    int left = (int)std::floor(std::max(minX * 0.5 + 0.5, 0.0) * width);
+    int bottom = (int)std::floor(std::max(minY * 0.5 + 0.5, 0.0) * height);
+    int right = (int)std::ceil(std::min(maxX * 0.5 + 0.5, 1.0) * width);
+    int top = (int)std::ceil(std::min(maxY * 0.5 + 0.5, 1.0) * height);
+    rect.x = left;
+    rect.y = bottom;
+    rect.width = std::max(right - left, 0);
+    rect.height = std::max(top - bottom, 0);
+    return true;
+}
+
+MMatrix DirtyRegion::cropMatrix(const DirtyRect &rect, int width, int height) {
+    // scales the rectangle's [-1, 1] coordinates up to the viewport and moves its center to the origin
+    double scaleX = (double)width / (double)std::max(rect.width, 1);
+    double scaleY = (double)height / (double)std::max(rect.height, 1);
+    double centerX = 2.0 * (rect.x + 0.5 * rect.width) / width - 1.0;
+    double centerY = 2.0 * (rect.y + 0.5 * rect.height) / height - 1.0;
+    MMatrix crop;
+    crop(0, 0) = scaleX;
+    crop(1, 1) = scaleY;
+    crop(3, 0) = -centerX * scaleX;
+    crop(3, 1) = -centerY * scaleY;
+    return crop;
+}
@@ -0,0 +1,42 @@
+// Title         viewOverrideDirtyRegion.h
+// Summary       viewOverride partial redraw region declaration
+// Copyright     2020 Artineering and/or its licensors
+// License       MIT
+
+#pragma once
+#include <maya/MMatrix.h>
+#include <maya/MBoundingBox.h>
+#include <maya/MObjectHandle.h>
+
+/// Pixel rectangle of the viewport, from its lower left corner
+struct DirtyRect {
+    int x = 0;
+    int y = 0;
+    int width = 0;
+    int height = 0;
+
+    bool empty() const { return width <= 0 || height <= 0; }
+    double area() const { return empty() ? 0.0 : (double)width * (double)height; }
+    void merge(const DirtyRect &rect);
+    /// grows the rectangle by pixels on each side, within the viewport
+    void pad(int pixels, int viewWidth, int viewHeight);
+};
+
+
+/// Region of the viewport to redraw after a few shapes changed
+///
+/// The world bounds of each shape, as it was last drawn and as it is
+/// now, are projected into the viewport. The scene is then drawn into
+/// that rectangle only, with a projection cropped to it, so that its
+/// pixels match the ones of a full redraw.
+class DirtyRegion {
+public:
+    static const int kPadding = 64;  ///< pixels around the shapes, for outlines and manipulators
+
+    /// world space bounds of a shape
+    static bool worldBounds(const MObjectHandle &shape, MBoundingBox &bounds);
+    /// viewport rectangle covering the bounds, false if they reach behind the camera
+    static bool project(const MBoundingBox &bounds, const MMatrix &viewProjection, int width, int height, DirtyRect &rect);
+    /// matrix applied after the projection that maps the rectangle to the whole viewport
+    static MMatrix cropMatrix(const DirtyRect &rect, int width, int height);
+};
@@ -0,0 +1,228 @@
+// Title         viewOverrideGraph.cpp
+// Summary       viewOverride render graph
+// Copyright     2020 Artineering and/or its licensors
+// License       MIT
+
+#include <algorithm>
+#include "viewOverrideGraph.h"
+
+/////////////////////////////////////////////////////////////////////
+/// Render graph used by viewOverride
+///
+/// Culling walks the passes backwards, starting from the root passes.
+/// A pass is kept if it writes a target that a later kept pass reads.
+/// Targets written by a kept pass are considered overwritten unless
+/// the pass also reads them (e.g., blending or drawing over), so any
+/// earlier writer of a fully overwritten target is culled. Read-only
+/// outputs are bound to the operation but count as inputs.
+///
+/// Aliasing runs over the compiled passes. A transient target lives
+/// from its first write to its last use and can share the allocation
+/// of a compatible target (same format, size, scaling and samples) whose live
+/// range has already ended. Transient targets that are read before
+/// being written in the frame keep their own allocation.
+///
+/////////////////////////////////////////////////////////////////////
+
+RenderGraph::~RenderGraph() {
+    clear();
+}
+
+void RenderGraph::clear() {
+    for (GraphPass &pass : mPasses) {
+        delete pass.operation;
+    }
+    mPasses.clear();
+    mTargets.clear();
+    mCompiled.clear();
+    mTargetUsed.clear();
+    mAlias.clear();
+    mDirty = true;
+}
+
+int RenderGraph::addTarget(const MHWRender::MRenderTargetDescription &description, unsigned int sizeDivisor, bool transient, bool scaled) {
+    GraphTarget target;
+    target.description = description;
+    target.sizeDivisor = sizeDivisor > 0 ? sizeDivisor : 1;
+    target.transient = transient;
+    target.scaled = scaled;
+    mTargets.push_back(target);
+    mDirty = true;
+    return (int)mTargets.size() - 1;
+}
+
+void RenderGraph::setTargetFormat(int target, MHWRender::MRasterFormat format) {
+    if (mTargets[target].description.rasterFormat() != format) {
+        mTargets[target].description.setRasterFormat(format);
+        mDirty = true;  // aliasing depends on the formats
+    }
+}
+
+void RenderGraph::setEnabled(int pass, bool enabled) {
+    if (mPasses[pass].enabled != enabled) {
+        mPasses[pass].enabled = enabled;
+        mDirty = true;
+    }
+}
+
+void RenderGraph::setInputs(int pass, const std::vector<int> &inputs) {
+    if (mPasses[pass].inputs != inputs) {
+        mPasses[pass].inputs = inputs;
+        mDirty = true;
+    }
+}
+
+void RenderGraph::setOutputs(int pass, const std::vector<int> &outputs) {
+    if (mPasses[pass].outputs != outputs) {
+        mPasses[pass].outputs = outputs;
+        mDirty = true;
+    }
+}
+
+void RenderGraph::setReadOnly(int pass, const std::vector<int> &targets) {
+    if (mPasses[pass].readOnly != targets) {
+        mPasses[pass].readOnly = targets;
+        mDirty = true;
+    }
+}
+
+bool RenderGraph::passCompiled(int pass) const {
+    return std::find(mCompiled.begin(), mCompiled.end(), pass) != mCompiled.end();
+}
+
+void RenderGraph::compile() {
+    if (!mDirty) {
+        return;
+    }
+    std::vector<bool> live(mTargets.size(), false);
+    std::vector<bool> keep(mPasses.size(), false);
+    for (int p = (int)mPasses.size() - 1; p >= 0; p--) {
+        const GraphPass &pass = mPasses[p];
+        if (!pass.enabled || !pass.operation) {
+            continue;
+        }
+        bool consumed = pass.root;
+        for (int t : pass.outputs) {
+            if (t >= 0 && live[t] && !mReadOnly(pass, t)) {
+                consumed = true;
+            }
+        }
+        if (!consumed) {
+            continue;
+        }
+        keep[p] = true;
+        // outputs are overwritten here, inputs need earlier writers
+        for (int t : pass.outputs) {
+            if (t >= 0 && !mReadOnly(pass, t)) {
+                live[t] = false;
+            }
+        }
+        for (int t : pass.inputs) {
+            if (t >= 0) {
+                live[t] = true;
+            }
+        }
+        for (int t : pass.readOnly) {
+            if (t >= 0) {
+                live[t] = true;
+            }
+        }
+    }
+
+    mCompiled.clear();
+    mTargetUsed.assign(mTargets.size(), false);
+    for (unsigned int p = 0; p < mPasses.size(); p++) {
+        if (!keep[p]) {
+            continue;
+        }
+        mCompiled.push_back(p);
+        for (int t : mPasses[p].outputs) {
+            if (t >= 0) mTargetUsed[t] = true;
+        }
+        for (int t : mPasses[p].inputs) {
+            if (t >= 0) mTargetUsed[t] = true;
+        }
+    }
+    mAliasTargets();
+    mDirty = false;
+}
+
+void RenderGraph::mAliasTargets() {
+    const int unused = -1;
+    std::vector<int> firstUse(mTargets.size(), unused);
+    std::vector<int> lastUse(mTargets.size(), unused);
+    std::vector<bool> readFirst(mTargets.size(), false);
+    for (int i = 0; i < (int)mCompiled.size(); i++) {
+        const GraphPass &pass = mPasses[mCompiled[i]];
+        for (unsigned int t = 0; t < mTargets.size(); t++) {
+            bool written = std::find(pass.outputs.begin(), pass.outputs.end(), (int)t) != pass.outputs.end();
+            bool read = mReads(pass, t);
+            if (!written && !read) {
+                continue;
+            }
+            if (firstUse[t] == unused) {
+                firstUse[t] = i;
+                readFirst[t] = read;
+            }
+            lastUse[t] = i;
+        }
+    }
+
+    // greedy interval allocation in order of first use
+    mAlias.resize(mTargets.size());
+    std::vector<int> slotEnd(mTargets.size(), unused);  // last use of the allocation owned by a target
+    for (int i = 0; i < (int)mCompiled.size(); i++) {
+        for (unsigned int t = 0; t < mTargets.size(); t++) {
+            if (firstUse[t] != i) {
+                continue;
+            }
+            mAlias[t] = t;
+            slotEnd[t] = lastUse[t];
+            if (!mTargets[t].transient || readFirst[t]) {
+                slotEnd[t] = (int)mCompiled.size();  // persistent, never shared
+                continue;
+            }
+            for (unsigned int s = 0; s < mTargets.size(); s++) {
+                if (slotEnd[s] == unused || slotEnd[s] >= i || mAlias[s] != (int)s || !mTargets[s].transient) {
+                    continue;
+                }
+                const GraphTarget &a = mTargets[s];
+                const GraphTarget &b = mTargets[t];
+                if (a.sizeDivisor == b.sizeDivisor && a.scaled == b.scaled &&
+                    a.description.rasterFormat() == b.description.rasterFormat() &&
+                    a.description.multiSampleCount() == b.description.multiSampleCount()) {
+                    mAlias[t] = s;
+                    slotEnd[s] = lastUse[t];
+                    slotEnd[t] = unused;
+                    break;
+                }
+            }
+        }
+    }
+    for (unsigned int t = 0; t < mTargets.size(); t++) {
+        if (firstUse[t] == unused) {
+            mAlias[t] = t;  // unused targets keep their own (minimal) allocation
+        }
+    }
+}
+
+bool RenderGraph::mReads(const GraphPass &pass, int target) {
+    return std::find(pass.inputs.begin(), pass.inputs.end(), target) != pass.inputs.end() || mReadOnly(pass, target);
+}
+
+bool RenderGraph::mReadOnly(const GraphPass &pass, int target) {
+    return std::find(pass.readOnly.begin(), pass.readOnly.end(), target) != pass.readOnly.end();
+}
+
+void RenderGraph::assignTargets(MHWRender::MRenderTarget* const* targets, const MFloatPoint *viewportRect, const MFloatPoint *scaledRect) {
+    for (int p : mCompiled) {
+        GraphPass &pass = mPasses[p];
+        for (unsigned int i = 0; i < pass.outputs.size(); i++) {
+            if (pass.outputs[i] >= 0) {
+                pass.setTarget(i, targets[pass.outputs[i]]);
+            }
+        }
+        bool scaled = !pass.outputs.empty() && pass.outputs[0] >= 0 && mTargets[pass.outputs[0]].scaled;
+        pass.setViewportRect(scaled ? scaledRect : viewportRect);
+    }
+}
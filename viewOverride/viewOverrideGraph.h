@@ -0,0 +1,98 @@
+// Title         viewOverrideGraph.h
+// Summary       viewOverride render graph declaration
+// Copyright     2020 Artineering and/or its licensors
+// License       MIT
+
+#pragma once
+#include <vector>
+#include <functional>
+#include <maya/MFloatPoint.h>
+#include <maya/MViewport2Renderer.h>
+#include <maya/MRenderTargetManager.h>
+
+/// Render target declared to the RenderGraph
+struct GraphTarget {
+    MHWRender::MRenderTargetDescription description;  ///< template description (sized per panel)
+    unsigned int sizeDivisor = 1;                     ///< target size relative to the viewport
+    bool transient = false;                           ///< contents aren't needed outside of the frame
+    bool scaled = false;                              ///< sized to the scaled viewport (dynamic resolution)
+};
+
+
+/// Render pass declared to the RenderGraph
+struct GraphPass {
+    MHWRender::MRenderOperation* operation = nullptr;  ///< owned by the graph
+    std::vector<int> outputs;  ///< target override list in order (-1 leaves the slot untouched)
+    std::vector<int> inputs;   ///< targets sampled or drawn over by the pass
+    std::vector<int> readOnly; ///< outputs that are only tested against (e.g., depth of transparent items)
+    bool enabled = true;
+    bool root = false;         ///< never culled (e.g., present)
+    std::function<void(unsigned int, MHWRender::MRenderTarget*)> setTarget;
+    std::function<void(const MFloatPoint*)> setViewportRect;
+};
+
+
+/// Declarative render graph
+///
+/// Passes declare the targets they write (outputs) and read (inputs).
+/// Compiling the graph culls disabled passes and passes whose outputs
+/// are never consumed by a root pass, keeping the declaration order.
+/// Transient targets whose lifetimes don't overlap are then aliased,
+/// so they can share the same allocation.
+class RenderGraph {
+public:
+    RenderGraph() {}
+    ~RenderGraph();
+
+    /// declare a render target, returns its handle
+    int addTarget(const MHWRender::MRenderTargetDescription &description, unsigned int sizeDivisor = 1, bool transient = false, bool scaled = false);
+    /// declare a pass (the graph takes ownership of the operation), returns its handle
+    template <class T>
+    int addPass(T *operation, const std::vector<int> &outputs, const std::vector<int> &inputs, bool root = false) {
+        GraphPass pass;
+        pass.operation = operation;
+        pass.outputs = outputs;
+        pass.inputs = inputs;
+        pass.root = root;
+        pass.setTarget = [operation](unsigned int i, MHWRender::MRenderTarget *target) { operation->setTargetOverride(i, target); };
+        pass.setViewportRect = [operation](const MFloatPoint *rect) { operation->setViewportRectangle(rect); };
+        mPasses.push_back(pass);
+        mDirty = true;
+        return (int)mPasses.size() - 1;
+    }
+
+    void setTargetFormat(int target, MHWRender::MRasterFormat format);
+    void setEnabled(int pass, bool enabled);
+    void setInputs(int pass, const std::vector<int> &inputs);
+    void setOutputs(int pass, const std::vector<int> &outputs);
+    void setReadOnly(int pass, const std::vector<int> &targets);
+    /// culls and orders the passes, only does work if the declarations changed
+    void compile();
+    /// points the compiled passes to the targets (indexed by target handle)
+    /// passes writing a scaled target render into the scaled viewport rectangle instead
+    void assignTargets(MHWRender::MRenderTarget* const* targets, const MFloatPoint *viewportRect, const MFloatPoint *scaledRect);
+    void clear();
+
+    unsigned int targetCount() const { return (unsigned int)mTargets.size(); }
+    const GraphTarget& target(int target) const { return mTargets[target]; }
+    bool targetUsed(int target) const { return mTargetUsed[target]; }
+    /// target whose allocation is shared by the given target (itself if not aliased)
+    int alias(int target) const { return mAlias[target]; }
+    unsigned int passCount() const { return (unsigned int)mPasses.size(); }
+    const GraphPass& pass(int pass) const { return mPasses[pass]; }
+    MHWRender::MRenderOperation* operation(int pass) const { return mPasses[pass].operation; }
+    bool passCompiled(int pass) const;
+    const std::vector<int>& compiledPasses() const { return mCompiled; }
+
+protected:
+    std::vector<GraphTarget> mTargets;
+    std::vector<GraphPass> mPasses;
+    std::vector<int> mCompiled;     ///< pass handles in execution order
+    std::vector<bool> mTargetUsed;  ///< targets referenced by compiled passes
+    std::vector<int> mAlias;        ///< allocation shared by each target
+    bool mDirty = true;
+
+    static bool mReadOnly(const GraphPass &pass, int target);
+    static bool mReads(const GraphPass &pass, int target);
+    void mAliasTargets();
+};
@@ -0,0 +1,926 @@
+// Title         viewOverrideImageDiff.cpp
+// Summary       viewOverride image comparison
+// Copyright     2020 Artineering and/or its licensors
+// License       MIT
+
+#include <cmath>
+#include <cctype>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include "viewOverrideImageDiff.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define VIEWOVERRIDE_X86
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define TARGET_SSE2
+#define TARGET_AVX2
+#else
+#define TARGET_SSE2 __attribute__((target("sse2")))
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+/////////////////////////////////////////////////////////////////////
+/// Golden image comparison
+///
+/// Regressions of the transparency sorting (and of the override in
+/// general) are caught by comparing captured targets (see
+/// FrameCapture) against golden images, e.g., in CI with the
+/// viewOverrideDiff tool of the stand-in build.
+///
+/// Images are compared as float planes, so that the kernels load
+/// consecutive pixels of a channel into a vector instead of shuffling
+/// interleaved channels. A pass over the planes finds the largest
+/// channel difference of each pixel, the pixels over the tolerance
+/// (NaNs always are) and the squared error. The structural similarity
+/// (SSIM) is computed over non-overlapping windows of the luminance,
+/// which catches sorting errors that shift colors without exceeding
+/// the tolerance much. The kernels are compiled for SSE2 and AVX2 and
+/// picked at runtime, the scalar kernel is the reference.
+///
+/// Only the files written by the capture are read quickly: OpenEXR
+/// files must be uncompressed scanline images, compressed PNG files
+/// (e.g., edited golden images) are inflated by a simple decoder.
+///
+/////////////////////////////////////////////////////////////////////
+
+namespace {
+    const size_t kChunk = 4096;  ///< pixels accumulated in float before adding to the double sums
+
+    struct DiffSums {
+        double squares = 0.0;
+        unsigned long long over = 0;
+        float max = 0.0f;
+    };
+
+    // sums of a, b, a^2, b^2 and a*b over a window
+    struct WindowSums {
+        float values[5] = { 0.0f, 0.0f, 0.0f, 0.0f, 0.0f };
+    };
+
+    // differences of the pixels [begin, end) of the channel planes
+    typedef void (*DiffKernel)(const float *const *a, const float *const *b, unsigned int channels, size_t begin, size_t end,
+        float tolerance, float *heat, DiffSums &sums);
+    typedef void (*WindowKernel)(const float *a, const float *b, size_t stride, WindowSums &sums);
+
+    void diffScalar(const float *const *a, const float *const *b, unsigned int channels, size_t begin, size_t end,
+        float tolerance, float *heat, DiffSums &sums) {
+        for (size_t start = begin; start < end; start += kChunk) {
+            size_t chunkEnd = std::min(end, start + kChunk);
+            float squares = 0.0f;
+            for (size_t i = start; i < chunkEnd; i++) {
+                float difference = 0.0f;
+                bool over = false;
+                for (unsigned int c = 0; c < channels; c++) {
+                    float e = std::fabs(a[c][i] - b[c][i]);
+                    squares += e * e;
+                    difference = (e > difference) ? e : difference;
+                    over = over || !(e <= tolerance);
+                }
+                sums.over += over ? 1 : 0;
+                sums.max = std::max(sums.max, difference);
+                if (heat) {
+                    heat[i] = difference;
+                }
+            }
+            sums.squares += squares;
+        }
+    }
+
+    void windowScalar(const float *a, const float *b, size_t stride, WindowSums &sums) {
+        for (unsigned int y = 0; y < ImageDiff::kWindow; y++) {
+            for (unsigned int x = 0; x < ImageDiff::kWindow; x++) {
+                float va = a[y * stride + x];
+                float vb = b[y * stride + x];
+                sums.values[0] += va;
+                sums.values[1] += vb;
+                sums.values[2] += va * va;
+                sums.values[3] += vb * vb;
+                sums.values[4] += va * vb;
+            }
+        }
+    }
+
+#ifdef VIEWOVERRIDE_X86
+    TARGET_SSE2 float horizontalSum(__m128 v) {
+        __m128 shuffled = _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1));
+        v = _mm_add_ps(v, shuffled);
+        shuffled = _mm_movehl_ps(shuffled, v);
+        return _mm_cvtss_f32(_mm_add_ss(v, shuffled));
+    }
+
+    TARGET_SSE2 float horizontalMax(__m128 v) {
+        v = _mm_max_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1)));
+        v = _mm_max_ps(v, _mm_movehl_ps(v, v));
+        return _mm_cvtss_f32(v);
+    }
+
+    TARGET_SSE2 unsigned long long horizontalCount(__m128i v) {
+        int counts[4];
+        _mm_storeu_si128((__m128i*)counts, v);
+        return (unsigned long long)counts[0] + counts[1] + counts[2] + counts[3];
+    }
+
+    TARGET_SSE2 void diffSSE2(const float *const *a, const float *const *b, unsigned int channels, size_t begin, size_t end,
+        float tolerance, float *heat, DiffSums &sums) {
+        const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+        const __m128 tol = _mm_set1_ps(tolerance);
+        size_t vectorEnd = begin + ((end - begin) & ~(size_t)3);
+        __m128 maximum = _mm_setzero_ps();
+        for (size_t start = begin; start < vectorEnd; start += kChunk) {
+            size_t chunkEnd = std::min(vectorEnd, start + kChunk);
+            __m128 squares = _mm_setzero_ps();
+            __m128i over = _mm_setzero_si128();
+            for (size_t i = start; i < chunkEnd; i += 4) {
+                __m128 difference = _mm_setzero_ps();
+                __m128 pixelOver = _mm_setzero_ps();
+                for (unsigned int c = 0; c < channels; c++) {
+                    __m128 e = _mm_and_ps(_mm_sub_ps(_mm_loadu_ps(a[c] + i), _mm_loadu_ps(b[c] + i)), absMask);
+                    squares = _mm_add_ps(squares, _mm_mul_ps(e, e));
+                    difference = _mm_max_ps(e, difference);  // NaNs keep the difference
+                    pixelOver = _mm_or_ps(pixelOver, _mm_cmpnle_ps(e, tol));  // NaNs are over
+                }
+                over = _mm_sub_epi32(over, _mm_castps_si128(pixelOver));
+                maximum = _mm_max_ps(difference, maximum);
+                if (heat) {
+                    _mm_storeu_ps(heat + i, difference);
+                }
+            }
+            sums.squares += horizontalSum(squares);
+            sums.over += horizontalCount(over);
+        }
+        sums.max = std::max(sums.max, horizontalMax(maximum));
+        diffScalar(a, b, channels, vectorEnd, end, tolerance, heat, sums);  // remaining pixels
+    }
+
+    TARGET_SSE2 void windowSSE2(const float *a, const float *b, size_t stride, WindowSums &sums) {
+        __m128 sa = _mm_setzero_ps(), sb = _mm_setzero_ps(), saa = _mm_setzero_ps(), sbb = _mm_setzero_ps(), sab = _mm_setzero_ps();
+        for (unsigned int y = 0; y < ImageDiff::kWindow; y++) {
+            for (unsigned int x = 0; x < ImageDiff::kWindow; x += 4) {
+                __m128 va = _mm_loadu_ps(a + y * stride + x);
+                __m128 vb = _mm_loadu_ps(b + y * stride + x);
+                sa = _mm_add_ps(sa, va);
+                sb = _mm_add_ps(sb, vb);
+                saa = _mm_add_ps(saa, _mm_mul_ps(va, va));
+                sbb = _mm_add_ps(sbb, _mm_mul_ps(vb, vb));
+                sab = _mm_add_ps(sab, _mm_mul_ps(va, vb));
+            }
+        }
+        sums.values[0] = horizontalSum(sa);
+        sums.values[1] = horizontalSum(sb);
+        sums.values[2] = horizontalSum(saa);
+        sums.values[3] = horizontalSum(sbb);
+        sums.values[4] = horizontalSum(sab);
+    }
+
+    TARGET_AVX2 float horizontalSum256(__m256 v) {
+        __m128 sum = _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+        sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+        sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, 1));
+        return _mm_cvtss_f32(sum);
+    }
+
+    TARGET_AVX2 void diffAVX2(const float *const *a, const float *const *b, unsigned int channels, size_t begin, size_t end,
+        float tolerance, float *heat, DiffSums &sums) {
+        const __m256 absMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7FFFFFFF));
+        const __m256 tol = _mm256_set1_ps(tolerance);
+        size_t vectorEnd = begin + ((end - begin) & ~(size_t)7);
+        __m256 maximum = _mm256_setzero_ps();
+        for (size_t start = begin; start < vectorEnd; start += kChunk) {
+            size_t chunkEnd = std::min(vectorEnd, start + kChunk);
+            __m256 squares = _mm256_setzero_ps();
+            __m256i over = _mm256_setzero_si256();
+            for (size_t i = start; i < chunkEnd; i += 8) {
+                __m256 difference = _mm256_setzero_ps();
+                __m256 pixelOver = _mm256_setzero_ps();
+                for (unsigned int c = 0; c < channels; c++) {
+                    __m256 e = _mm256_and_ps(_mm256_sub_ps(_mm256_loadu_ps(a[c] + i), _mm256_loadu_ps(b[c] + i)), absMask);
+                    squares = _mm256_add_ps(squares, _mm256_mul_ps(e, e));
+                    difference = _mm256_max_ps(e, difference);
+                    pixelOver = _mm256_or_ps(pixelOver, _mm256_cmp_ps(e, tol, _CMP_NLE_UQ));
+                }
+                over = _mm256_sub_epi32(over, _mm256_castps_si256(pixelOver));
+                maximum = _mm256_max_ps(difference, maximum);
+                if (heat) {
+                    _mm256_storeu_ps(heat + i, difference);
+                }
+            }
+            sums.squares += horizontalSum256(squares);
+            int counts[8];
+            _mm256_storeu_si256((__m256i*)counts, over);
+            for (int c : counts) {
+                sums.over += (unsigned long long)c;
+            }
+        }
+        __m128 maximum4 = _mm_max_ps(_mm256_castps256_ps128(maximum), _mm256_extractf128_ps(maximum, 1));
+        maximum4 = _mm_max_ps(maximum4, _mm_movehl_ps(maximum4, maximum4));
+        maximum4 = _mm_max_ss(maximum4, _mm_shuffle_ps(maximum4, maximum4, 1));
+        sums.max = std::max(sums.max, _mm_cvtss_f32(maximum4));
+        diffScalar(a, b, channels, vectorEnd, end, tolerance, heat, sums);  // remaining pixels
+    }
+
+    TARGET_AVX2 void windowAVX2(const float *a, const float *b, size_t stride, WindowSums &sums) {
+        __m256 sa = _mm256_setzero_ps(), sb = _mm256_setzero_ps(), saa = _mm256_setzero_ps(), sbb = _mm256_setzero_ps(), sab = _mm256_setzero_ps();
+        for (unsigned int y = 0; y < ImageDiff::kWindow; y++) {
+            __m256 va = _mm256_loadu_ps(a + y * stride);
+            __m256 vb = _mm256_loadu_ps(b + y * stride);
+            sa = _mm256_add_ps(sa, va);
+            sb = _mm256_add_ps(sb, vb);
+            saa = _mm256_add_ps(saa, _mm256_mul_ps(va, va));
+            sbb = _mm256_add_ps(sbb, _mm256_mul_ps(vb, vb));
+            sab = _mm256_add_ps(sab, _mm256_mul_ps(va, vb));
+        }
+        sums.values[0] = horizontalSum256(sa);
+        sums.values[1] = horizontalSum256(sb);
+        sums.values[2] = horizontalSum256(saa);
+        sums.values[3] = horizontalSum256(sbb);
+        sums.values[4] = horizontalSum256(sab);
+    }
+
+    bool cpuHasAVX2() {
+#if defined(_MSC_VER) && !defined(__clang__)
+        int info[4];
+        __cpuid(info, 1);
+        bool osxsave = (info[2] & (1 << 27)) != 0;
+        bool avx = (info[2] & (1 << 28)) != 0;
+        if (!osxsave || !avx || (_xgetbv(0) & 6) != 6) {
+            return false;  // the OS doesn't save the AVX registers
+        }
+        __cpuidex(info, 7, 0);
+        return (info[1] & (1 << 5)) != 0;
+#else
+        return __builtin_cpu_supports("avx2") != 0;
+#endif
+    }
+#endif
+
+    const DiffKernel sDiffKernels[ImageDiff::kKernelCount] = {
+        diffScalar,
+#ifdef VIEWOVERRIDE_X86
+        diffSSE2, diffAVX2
+#else
+        nullptr, nullptr
+#endif
+    };
+    const WindowKernel sWindowKernels[ImageDiff::kKernelCount] = {
+        windowScalar,
+#ifdef VIEWOVERRIDE_X86
+        windowSSE2, windowAVX2
+#else
+        nullptr, nullptr
+#endif
+    };
+
+    // structural similarity of a window from its sums over count pixels (values in [0, 1])
+    double windowSSIM(const WindowSums &sums, double count) {
+        const double c1 = 0.01 * 0.01;
+        const double c2 = 0.03 * 0.03;
+        double meanA = sums.values[0] / count;
+        double meanB = sums.values[1] / count;
+        double varianceA = std::max(0.0, sums.values[2] / count - meanA * meanA);
+        double varianceB = std::max(0.0, sums.values[3] / count - meanB * meanB);
+        double covariance = sums.values[4] / count - meanA * meanB;
+        return ((2.0 * meanA * meanB + c1) * (2.0 * covariance + c2)) /
+            ((meanA * meanA + meanB * meanB + c1) * (varianceA + varianceB + c2));
+    }
+
+    // plane compared by SSIM: the luminance of color images, the first channel otherwise
+    struct Luminance {
+        const DiffImage &image;
+        int rgb[3] = { -1, -1, -1 };
+        std::vector<float> buffer;
+
+        explicit Luminance(const DiffImage &image) : image(image) {
+            const char *names[3] = { "R", "G", "B" };
+            for (unsigned int c = 0; c < image.channels.size(); c++) {
+                for (unsigned int i = 0; i < 3; i++) {
+                    if (image.channels[c] == names[i]) {
+                        rgb[i] = (int)c;
+                    }
+                }
+            }
+        }
+
+        // the pixels [begin, end), computed into a buffer reused across bands so it stays in cache
+        const float* pixels(size_t begin, size_t end) {
+            if (rgb[0] < 0 || rgb[1] < 0 || rgb[2] < 0) {
+                return image.plane(0) + begin;
+            }
+            buffer.resize(end - begin);
+            const float *r = image.plane(rgb[0]) + begin;
+            const float *g = image.plane(rgb[1]) + begin;
+            const float *b = image.plane(rgb[2]) + begin;
+            for (size_t i = 0; i < end - begin; i++) {
+                buffer[i] = 0.2126f * r[i] + 0.7152f * g[i] + 0.0722f * b[i];
+            }
+            return buffer.data();
+        }
+    };
+
+    bool readFile(const std::string &path, std::vector<unsigned char> &contents) {
+        std::ifstream file(path.c_str(), std::ios::in | std::ios::binary | std::ios::ate);
+        if (!file) {
+            return false;
+        }
+        contents.resize((size_t)file.tellg());
+        file.seekg(0);
+        return file.read((char*)contents.data(), contents.size()).good() || contents.empty();
+    }
+
+    bool endsWith(const std::string &text, const std::string &suffix) {
+        if (text.size() < suffix.size()) {
+            return false;
+        }
+        for (size_t i = 0; i < suffix.size(); i++) {
+            if (tolower(text[text.size() - suffix.size() + i]) != suffix[i]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    unsigned int bigEndian(const unsigned char *bytes) {
+        return ((unsigned int)bytes[0] << 24) | ((unsigned int)bytes[1] << 16) | ((unsigned int)bytes[2] << 8) | bytes[3];
+    }
+
+    // bounds checked little-endian reads of a file
+    struct FileReader {
+        const std::vector<unsigned char> &file;
+        size_t position;
+        bool failed = false;
+        FileReader(const std::vector<unsigned char> &contents, size_t start = 0) : file(contents), position(start) {}
+
+        bool read(void *out, size_t size) {
+            if (failed || position + size > file.size()) {
+                failed = true;
+                return false;
+            }
+            memcpy(out, &file[position], size);
+            position += size;
+            return true;
+        }
+        int readInt() { int value = 0; read(&value, 4); return value; }
+        std::string readString() {
+            std::string text;
+            while (!failed && position < file.size() && file[position] != 0) {
+                text += (char)file[position++];
+            }
+            failed = failed || position >= file.size();
+            position++;
+            return text;
+        }
+    };
+
+    bool readEXR(const std::vector<unsigned char> &file, DiffImage &image, std::string &error) {
+        FileReader reader(file);
+        unsigned char magic[4];
+        unsigned int version = 0;
+        reader.read(magic, 4);
+        reader.read(&version, 4);
+        if (reader.failed || magic[0] != 0x76 || magic[1] != 0x2f || magic[2] != 0x31 || magic[3] != 0x01) {
+            error = "not an OpenEXR file";
+            return false;
+        }
+        if ((version & 0xFF) != 2 || (version & 0x1E00) != 0) {
+            error = "only single part scanline OpenEXR files are supported";
+            return false;
+        }
+        std::vector<int> pixelTypes;
+        int window[4] = { 0, 0, -1, -1 };
+        int compression = -1;
+        while (!reader.failed) {
+            std::string name = reader.readString();
+            if (name.empty()) {
+                break;
+            }
+            std::string type = reader.readString();
+            int size = reader.readInt();
+            size_t end = reader.position + (size_t)std::max(size, 0);
+            if (name == "channels") {
+                while (!reader.failed && reader.position < end) {
+                    std::string channel = reader.readString();
+                    if (channel.empty()) {
+                        break;
+                    }
+                    int pixelType = reader.readInt();
+                    reader.readInt();  // pLinear and reserved
+                    int xSampling = reader.readInt();
+                    int ySampling = reader.readInt();
+                    if (xSampling != 1 || ySampling != 1) {
+                        error = "subsampled channels are not supported";
+                        return false;
+                    }
+                    image.channels.push_back(channel);
+                    pixelTypes.push_back(pixelType);
+                }
+            } else if (name == "compression") {
+                unsigned char value = 0xFF;
+                reader.read(&value, 1);
+                compression = value;
+            } else if (name == "dataWindow") {
+                reader.read(window, 16);
+            }
+            reader.position = end;
+        }
+        if (reader.failed || image.channels.empty() || window[2] < window[0] || window[3] < window[1]) {
+            error = "invalid OpenEXR header";
+            return false;
+        }
+        if (compression != 0) {
+            error = "compressed OpenEXR files are not supported (capture writes them uncompressed)";
+            return false;
+        }
+        image.width = (unsigned int)(window[2] - window[0] + 1);
+        image.height = (unsigned int)(window[3] - window[1] + 1);
+        image.pixels.assign((size_t)image.width * image.height * image.channels.size(), 0.0f);
+        std::vector<unsigned long long> offsets(image.height);
+        reader.read(offsets.data(), offsets.size() * 8);
+        for (unsigned int line = 0; line < image.height && !reader.failed; line++) {
+            reader.position = (size_t)offsets[line];
+            int y = reader.readInt() - window[1];
+            reader.readInt();  // data size
+            if (y < 0 || y >= (int)image.height) {
+                error = "invalid OpenEXR scanline";
+                return false;
+            }
+            for (unsigned int c = 0; c < image.channels.size() && !reader.failed; c++) {
+                float *row = image.plane(c) + (size_t)y * image.width;
+                for (unsigned int x = 0; x < image.width; x++) {
+                    if (pixelTypes[c] == 1) {
+                        unsigned short half = 0;
+                        reader.read(&half, 2);
+                        row[x] = CaptureImage::halfToFloat(half);
+                    } else if (pixelTypes[c] == 2) {
+                        reader.read(&row[x], 4);
+                    } else {
+                        unsigned int value = 0;
+                        reader.read(&value, 4);
+                        row[x] = (float)value;
+                    }
+                }
+            }
+        }
+        if (reader.failed) {
+            error = "truncated OpenEXR file";
+            return false;
+        }
+        return true;
+    }
+
+    bool readPNG(const std::vector<unsigned char> &file, DiffImage &image, std::string &error) {
+        const unsigned char signature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+        if (file.size() < 8 || memcmp(file.data(), signature, 8) != 0) {
+            error = "not a PNG file";
+            return false;
+        }
+        unsigned int channelCount = 0;
+        std::vector<unsigned char> compressed;
+        size_t position = 8;
+        while (position + 8 <= file.size()) {
+            unsigned int length = bigEndian(&file[position]);
+            std::string type(file.begin() + position + 4, file.begin() + position + 8);
+            if (position + 12 + (size_t)length > file.size()) {
+                break;  // truncated chunk
+            }
+            const unsigned char *data = file.data() + position + 8;
+            if (type == "IHDR" && length >= 13) {
+                image.width = bigEndian(data);
+                image.height = bigEndian(data + 4);
+                unsigned char depth = data[8];
+                unsigned char colorType = data[9];
+                const unsigned int channels[7] = { 1, 0, 3, 0, 2, 0, 4 };
+                channelCount = (colorType < 7) ? channels[colorType] : 0;
+                if (depth != 8 || channelCount == 0 || data[12] != 0) {
+                    error = "only 8 bit, non interlaced gray or RGB(A) PNG files are supported";
+                    return false;
+                }
+            } else if (type == "IDAT") {
+                compressed.insert(compressed.end(), data, data + length);
+            } else if (type == "IEND") {
+                break;
+            }
+            position += 12 + (size_t)length;
+        }
+        std::vector<unsigned char> raw;
+        size_t rowBytes = (size_t)image.width * channelCount;
+        if (channelCount == 0 || !DiffImage::inflate(compressed.data(), compressed.size(), raw) || raw.size() < (rowBytes + 1) * image.height) {
+            error = "invalid PNG image data";
+            return false;
+        }
+        // undo the row filters in place
+        for (unsigned int y = 0; y < image.height; y++) {
+            unsigned char filter = raw[y * (rowBytes + 1)];
+            unsigned char *row = &raw[y * (rowBytes + 1) + 1];
+            const unsigned char *previous = (y > 0) ? row - (rowBytes + 1) : nullptr;
+            for (size_t x = 0; x < rowBytes; x++) {
+                int a = (x >= channelCount) ? row[x - channelCount] : 0;
+                int b = previous ? previous[x] : 0;
+                int c = (previous && x >= channelCount) ? previous[x - channelCount] : 0;
+                int predictor = 0;
+                if (filter == 1) {
+                    predictor = a;
+                } else if (filter == 2) {
+                    predictor = b;
+                } else if (filter == 3) {
+                    predictor = (a + b) / 2;
+                } else if (filter == 4) {
+                    int p = a + b - c;
+                    int pa = std::abs(p - a), pb = std::abs(p - b), pc = std::abs(p - c);
+                    predictor = (pa <= pb && pa <= pc) ? a : (pb <= pc) ? b : c;
+                }
+                row[x] = (unsigned char)(row[x] + predictor);
+            }
+        }
+        static const char *names[5][4] = { {}, { "Y" }, { "Y", "A" }, { "R", "G", "B" }, { "R", "G", "B", "A" } };
+        image.channels.assign(names[channelCount], names[channelCount] + channelCount);
+        image.pixels.resize(rowBytes * image.height);
+        for (unsigned int y = 0; y < image.height; y++) {
+            const unsigned char *row = &raw[y * (rowBytes + 1) + 1];
+            for (unsigned int x = 0; x < image.width; x++) {
+                for (unsigned int c = 0; c < channelCount; c++) {
+                    image.plane(c)[(size_t)y * image.width + x] = row[x * channelCount + c] / 255.0f;
+                }
+            }
+        }
+        return true;
+    }
+
+    // Deflate decoder (RFC 1951), decoding the Huffman codes one bit at a time like zlib's puff
+    struct Inflater {
+        const unsigned char *data;
+        size_t size;
+        size_t position = 0;
+        unsigned int bitBuffer = 0;
+        unsigned int bitCount = 0;
+        bool failed = false;
+        std::vector<unsigned char> &out;
+        Inflater(const unsigned char *input, size_t inputSize, std::vector<unsigned char> &output) : data(input), size(inputSize), out(output) {}
+
+        struct Huffman {
+            short count[16];
+            short symbol[288];
+        };
+
+        int bits(unsigned int need) {
+            unsigned long long value = bitBuffer;
+            while (bitCount < need) {
+                if (position >= size) {
+                    failed = true;
+                    return 0;
+                }
+                value |= (unsigned long long)data[position++] << bitCount;
+                bitCount += 8;
+            }
+            bitBuffer = (unsigned int)(value >> need);
+            bitCount -= need;
+            return (int)(value & ((1ull << need) - 1));
+        }
+
+        int decode(const Huffman &huffman) {
+            int code = 0, first = 0, index = 0;
+            for (int length = 1; length < 16; length++) {
+                code |= bits(1);
+                int count = huffman.count[length];
+                if (code - count < first) {
+                    return huffman.symbol[index + (code - first)];
+                }
+                index += count;
+                first = (first + count) << 1;
+                code <<= 1;
+                if (failed) {
+                    break;
+                }
+            }
+            failed = true;
+            return -1;
+        }
+
+        // canonical code from the code lengths, false if over-subscribed
+        static bool construct(Huffman &huffman, const short *lengths, int count) {
+            memset(huffman.count, 0, sizeof(huffman.count));
+            for (int symbol = 0; symbol < count; symbol++) {
+                huffman.count[lengths[symbol]]++;
+            }
+            int left = 1;
+            for (int length = 1; length < 16; length++) {
+                left = (left << 1) - huffman.count[length];
+                if (left < 0) {
+                    return false;
+                }
+            }
+            short offsets[16];
+            offsets[1] = 0;
+            for (int length = 1; length < 15; length++) {
+                offsets[length + 1] = offsets[length] + huffman.count[length];
+            }
+            for (int symbol = 0; symbol < count; symbol++) {
+                if (lengths[symbol] != 0) {
+                    huffman.symbol[offsets[lengths[symbol]]++] = (short)symbol;
+                }
+            }
+            return true;
+        }
+
+        bool stored() {
+            bitBuffer = 0;
+            bitCount = 0;
+            if (position + 4 > size) {
+                return false;
+            }
+            unsigned int length = data[position] | (data[position + 1] << 8);
+            unsigned int inverse = data[position + 2] | (data[position + 3] << 8);
+            position += 4;
+            if (length != (~inverse & 0xFFFF) || position + length > size) {
+                return false;
+            }
+            out.insert(out.end(), data + position, data + position + length);
+            position += length;
+            return true;
+        }
+
+        bool codes(const Huffman &lengthCode, const Huffman &distanceCode) {
+            static const short lengthBase[29] = { 3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+                35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+            static const short lengthExtra[29] = { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+                3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+            static const short distanceBase[30] = { 1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+                257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577 };
+            static const short distanceExtra[30] = { 0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+                7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+            while (!failed) {
+                int symbol = decode(lengthCode);
+                if (symbol < 0) {
+                    return false;
+                }
+                if (symbol < 256) {
+                    out.push_back((unsigned char)symbol);
+                    continue;
+                }
+                if (symbol == 256) {
+                    return true;  // end of block
+                }
+                symbol -= 257;
+                if (symbol >= 29) {
+                    return false;
+                }
+                int length = lengthBase[symbol] + bits(lengthExtra[symbol]);
+                symbol = decode(distanceCode);
+                if (symbol < 0 || symbol >= 30) {
+                    return false;
+                }
+                size_t distance = (size_t)(distanceBase[symbol] + bits(distanceExtra[symbol]));
+                if (distance > out.size()) {
+                    return false;
+                }
+                for (int i = 0; i < length; i++) {
+                    out.push_back(out[out.size() - distance]);
+                }
+            }
+            return false;
+        }
+
+        bool fixed() {
+            static Huffman lengthCode, distanceCode;
+            static bool built = [] {
+                short lengths[288];
+                for (int symbol = 0; symbol < 288; symbol++) {
+                    lengths[symbol] = (symbol < 144) ? 8 : (symbol < 256) ? 9 : (symbol < 280) ? 7 : 8;
+                }
+                construct(lengthCode, lengths, 288);
+                for (int symbol = 0; symbol < 30; symbol++) {
+                    lengths[symbol] = 5;
+                }
+                construct(distanceCode, lengths, 30);
+                return true;
+            }();
+            (void)built;
+            return codes(lengthCode, distanceCode);
+        }
+
+        bool dynamic() {
+            static const short order[19] = { 16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15 };
+            int lengthCount = bits(5) + 257;
+            int distanceCount = bits(5) + 1;
+            int codeCount = bits(4) + 4;
+            if (lengthCount > 286 || distanceCount > 30) {
+                return false;
+            }
+            short lengths[320] = {};
+            for (int i = 0; i < codeCount; i++) {
+                lengths[order[i]] = (short)bits(3);
+            }
+            Huffman lengthCode, distanceCode;
+            if (!construct(lengthCode, lengths, 19)) {
+                return false;
+            }
+            int index = 0;
+            while (index < lengthCount + distanceCount && !failed) {
+                int symbol = decode(lengthCode);
+                if (symbol < 0) {
+                    return false;
+                }
+                if (symbol < 16) {
+                    lengths[index++] = (short)symbol;
+                    continue;
+                }
+                short length = 0;
+                int repeat = 0;
+                if (symbol == 16) {
+                    if (index == 0) {
+                        return false;
+                    }
+                    length = lengths[index - 1];
+                    repeat = 3 + bits(2);
+                } else if (symbol == 17) {
+                    repeat = 3 + bits(3);
+                } else {
+                    repeat = 11 + bits(7);
+                }
+                if (index + repeat > lengthCount + distanceCount) {
+                    return false;
+                }
+                while (repeat--) {
+                    lengths[index++] = length;
+                }
+            }
+            if (failed || !construct(lengthCode, lengths, lengthCount) || !construct(distanceCode, lengths + lengthCount, distanceCount)) {
+                return false;
+            }
+            return codes(lengthCode, distanceCode);
+        }
+    };
+}
+
+
+bool DiffImage::inflate(const unsigned char *data, size_t size, std::vector<unsigned char> &out) {
+    out.clear();
+    // zlib header: deflate without a preset dictionary
+    if (size < 6 || (data[0] & 0x0F) != 8 || ((data[0] << 8) | data[1]) % 31 != 0 || (data[1] & 0x20)) {
+        return false;
+    }
+    Inflater inflater(data + 2, size - 6, out);
+    bool last = false;
+    while (!last) {
+        last = inflater.bits(1) != 0;
+        int type = inflater.bits(2);
+        bool decoded = (type == 0) ? inflater.stored() : (type == 1) ? inflater.fixed() : (type == 2) ? inflater.dynamic() : false;
+        if (!decoded || inflater.failed) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool DiffImage::read(const std::string &path, DiffImage &image, std::string &error) {
+    image = DiffImage();
+    std::vector<unsigned char> file;
+    if (!readFile(path, file)) {
+        error = "could not read " + path;
+        return false;
+    }
+    bool valid = false;
+    if (endsWith(path, ".exr")) {
+        valid = readEXR(file, image, error);
+    } else if (endsWith(path, ".png")) {
+        valid = readPNG(file, image, error);
+    } else {
+        error = "unsupported image format (.exr or .png)";
+    }
+    if (!valid) {
+        error = path + ": " + error;
+    }
+    return valid;
+}
+
+
+bool ImageDiff::supported(Kernel kernel) {
+    switch (kernel) {
+    case kScalar:
+        return true;
+#ifdef VIEWOVERRIDE_X86
+    case kSSE2:
+        return true;
+    case kAVX2: {
+        static const bool avx2 = cpuHasAVX2();
+        return avx2;
+    }
+#endif
+    default:
+        return false;
+    }
+}
+
+ImageDiff::Kernel ImageDiff::bestKernel() {
+    return supported(kAVX2) ? kAVX2 : supported(kSSE2) ? kSSE2 : kScalar;
+}
+
+const char* ImageDiff::kernelName(Kernel kernel) {
+    static const char *names[kKernelCount] = { "scalar", "sse2", "avx2" };
+    return (kernel < kKernelCount) ? names[kernel] : "best";
+}
+
+DiffResult ImageDiff::compare(const DiffImage &golden, const DiffImage &test, const DiffTolerance &tolerance,
+    std::vector<float> *heat, Kernel kernel) {
+    DiffResult result;
+    if (golden.width != test.width || golden.height != test.height) {
+        std::ostringstream message;
+        message << "size " << test.width << "x" << test.height << " differs from " << golden.width << "x" << golden.height;
+        result.error = message.str();
+        return result;
+    }
+    if (golden.channels != test.channels || golden.channels.empty()) {
+        result.error = "channels differ";
+        return result;
+    }
+    if (kernel == kBest) {
+        kernel = bestKernel();
+    } else if (!supported(kernel)) {
+        kernel = kScalar;
+    }
+    unsigned int channels = (unsigned int)golden.channels.size();
+    size_t count = (size_t)golden.width * golden.height;
+    result.pixels = count;
+
+    // per pixel differences
+    std::vector<const float*> planesA(channels), planesB(channels);
+    for (unsigned int c = 0; c < channels; c++) {
+        planesA[c] = golden.plane(c);
+        planesB[c] = test.plane(c);
+    }
+    if (heat) {
+        heat->resize(count);
+    }
+    DiffSums sums;
+    sDiffKernels[kernel](planesA.data(), planesB.data(), channels, 0, count, tolerance.channel, heat ? heat->data() : nullptr, sums);
+    result.overTolerance = sums.over;
+    result.maxDifference = sums.max;
+    result.rmse = std::sqrt(sums.squares / ((double)count * channels));
+
+    // structural similarity over the windows of the luminance (the whole image if smaller),
+    // a band of kWindow rows at a time
+    Luminance luminanceA(golden), luminanceB(test);
+    unsigned int columns = golden.width / kWindow;
+    unsigned int rows = golden.height / kWindow;
+    if (columns == 0 || rows == 0) {
+        const float *lumA = luminanceA.pixels(0, count);
+        const float *lumB = luminanceB.pixels(0, count);
+        WindowSums window;
+        for (size_t i = 0; i < count; i++) {
+            window.values[0] += lumA[i];
+            window.values[1] += lumB[i];
+            window.values[2] += lumA[i] * lumA[i];
+            window.values[3] += lumB[i] * lumB[i];
+            window.values[4] += lumA[i] * lumB[i];
+        }
+        result.ssim = result.minSSIM = windowSSIM(window, (double)count);
+    } else {
+        double total = 0.0;
+        result.minSSIM = 1.0;
+        const double windowPixels = (double)(kWindow * kWindow);
+        for (unsigned int y = 0; y < rows; y++) {
+            size_t rowStart = (size_t)y * kWindow * golden.width;
+            const float *lumA = luminanceA.pixels(rowStart, rowStart + (size_t)kWindow * golden.width);
+            const float *lumB = luminanceB.pixels(rowStart, rowStart + (size_t)kWindow * golden.width);
+            for (unsigned int x = 0; x < columns; x++) {
+                WindowSums window;
+                sWindowKernels[kernel](lumA + x * kWindow, lumB + x * kWindow, golden.width, window);
+                double ssim = windowSSIM(window, windowPixels);
+                total += ssim;
+                result.minSSIM = std::min(result.minSSIM, ssim);
+            }
+        }
+        result.ssim = total / ((double)columns * rows);
+    }
+
+    result.passed = (result.overTolerance <= (unsigned long long)(tolerance.pixels * count)) && (result.ssim >= tolerance.ssim);
+    return result;
+}
+
+void ImageDiff::heatmap(const std::vector<float> &heat, unsigned int width, unsigned int height, float scale, CaptureImage &image) {
+    image.format = MHWRender::kR8G8B8A8_UNORM;
+    image.channels = "RGBA";
+    image.width = width;
+    image.height = height;
+    image.flip = false;
+    image.scale = 1.0f;
+    image.bias = 0.0f;
+    image.data.resize((size_t)width * height * 4);
+    float inverseScale = (scale > 0.0f) ? 1.0f / scale : 1.0f;
+    for (size_t i = 0; i < (size_t)width * height && i < heat.size(); i++) {
+        float t = std::min(std::max(heat[i] * inverseScale, 0.0f), 1.0f) * 3.0f;
+        float rgb[3] = { 0.0f, 0.0f, t };  // black to blue
+        if (t > 2.0f) {
+            rgb[0] = 1.0f; rgb[1] = t - 2.0f; rgb[2] = 0.0f;  // red to yellow
+        } else if (t > 1.0f) {
+            rgb[0] = t - 1.0f; rgb[1] = 0.0f; rgb[2] = 2.0f - t;  // blue to red
+        }
+        for (unsigned int c = 0; c < 3; c++) {
+            image.data[i * 4 + c] = (unsigned char)(rgb[c] * 255.0f + 0.5f);
+        }
+        image.data[i * 4 + 3] = 255;
+    }
+}
@@ -0,0 +1,73 @@
+// Title         viewOverrideImageDiff.h
+// Summary       viewOverride image comparison declaration
+// Copyright     2020 Artineering and/or its licensors
+// License       MIT
+
+#pragma once
+#include <string>
+#include <vector>
+#include "viewOverrideCapture.h"
+
+/// Image read from a captured file, with one float plane per channel
+struct DiffImage {
+    unsigned int width = 0;
+    unsigned int height = 0;
+    std::vector<std::string> channels;  ///< channel names in plane order (e.g., A, B, G, R in OpenEXR files)
+    std::vector<float> pixels;          ///< planes of width * height values, rows from the top
+
+    const float* plane(unsigned int channel) const { return &pixels[(size_t)channel * width * height]; }
+    float* plane(unsigned int channel) { return &pixels[(size_t)channel * width * height]; }
+
+    /// reads an uncompressed OpenEXR (as written by the capture) or an 8 bit PNG file
+    static bool read(const std::string &path, DiffImage &image, std::string &error);
+    /// decompresses a zlib stream (PNG image data)
+    static bool inflate(const unsigned char *data, size_t size, std::vector<unsigned char> &out);
+};
+
+
+/// Thresholds of a comparison against a golden image
+struct DiffTolerance {
+    float channel = 1.0f / 255.0f;  ///< largest difference of a channel of a matching pixel
+    double pixels = 0.0;            ///< fraction of the pixels allowed over the channel tolerance
+    double ssim = 0.99;             ///< lowest mean structural similarity of the luminance
+};
+
+
+struct DiffResult {
+    bool passed = false;
+    std::string error;                   ///< set if the images couldn't be compared
+    unsigned long long pixels = 0;
+    unsigned long long overTolerance = 0;  ///< pixels with a channel over the tolerance
+    float maxDifference = 0.0f;          ///< largest difference of any channel
+    double rmse = 0.0;                   ///< root mean square error of all channels
+    double ssim = 1.0;                   ///< mean structural similarity of the luminance windows
+    double minSSIM = 1.0;                ///< lowest structural similarity of a window
+};
+
+
+/// Golden image comparison
+///
+/// The per pixel differences and the structural similarity (SSIM over
+/// kWindow x kWindow windows of the luminance) are computed by SIMD
+/// kernels, picked at runtime among the ones supported by the CPU.
+class ImageDiff {
+public:
+    enum Kernel {
+        kScalar = 0,
+        kSSE2,
+        kAVX2,
+        kKernelCount,
+        kBest = kKernelCount  ///< fastest kernel supported by the CPU
+    };
+    static const unsigned int kWindow = 8;  ///< size of the SSIM windows
+
+    /// compares two images with the same size and channels, the largest channel difference of each
+    /// pixel is written to heat (width * height values) if given
+    static DiffResult compare(const DiffImage &golden, const DiffImage &test, const DiffTolerance &tolerance,
+        std::vector<float> *heat = nullptr, Kernel kernel = kBest);
+    static bool supported(Kernel kernel);
+    static Kernel bestKernel();
+    static const char* kernelName(Kernel kernel);
+    /// differences mapped from black through blue and red to yellow at scale, as an RGBA8 image to encode
+    static void heatmap(const std::vector<float> &heat, unsigned int width, unsigned int height, float scale, CaptureImage &image);
+};
@@ -3,8 +3,11 @@
 // Copyright     2020 Artineering and/or its licensors
 // License       MIT
 
+#include <cstring>
+#include <maya/MDrawContext.h>
 #include <maya/MShaderManager.h>
 #include "viewOverrideOperations.h"
+#include "viewOverrideProfiler.h"
 
 /////////////////////////////////////////////////////////////////////
 /// Definition of render operations used in ViewOverride
@@ -13,10 +16,12 @@
 /// 2. Quad render with custom quad shaders
 /// 3. Heads Up Display (HUD) operation
 /// 4. Present operation
+/// 5. Timestamp operation for the GPU profiler
 ///
 /// Of special interest to troubleshoot the transparency object
-/// sorting  when rendering to multiple render targets is line 51.
-/// Change from listSize 3 to 2 and vice-versa to reproduce the bug
+/// sorting when rendering to multiple render targets is the number
+/// of targets of the scene render, set at runtime with viewOverride
+/// -mrt. Change from 3 targets to 2 and vice-versa to reproduce the bug
 ///
 /////////////////////////////////////////////////////////////////////
 
@@ -32,10 +37,15 @@ SceneRender::SceneRender(const MString& name,
     mClearOperation.setMask(clearMask);             // set mask
 }
 
-SceneRender::~SceneRender() {}
+SceneRender::~SceneRender() {
+    clearShaderInstance();
+    if (mBlendState) {
+        MHWRender::MStateManager::releaseBlendState(mBlendState);
+    }
+}
 
 void SceneRender::setTargetOverride(unsigned int i, MHWRender::MRenderTarget *target) {
-    if (i < 3) {
+    if (i < kMaxTargets) {
         if (target) {
             mTargets[i] = target;
         }
@@ -48,7 +58,7 @@ MHWRender::MRenderTarget * const * SceneRender::targetOverrideList(unsigned int
             listSize = 2;
             return &mTargets[0];
         } else {
-            listSize = 3;
+            listSize = mTargetCount;
             return &mTargets[0];
         }
     }
@@ -64,6 +74,89 @@ MHWRender::MSceneRender::MSceneFilterOption SceneRender::renderFilterOverride()
     return mSceneRenderFilter;  // value set during construction
 }
 
+void SceneRender::setTargetCount(unsigned int count) {
+    mTargetCount = (count < kMaxTargets) ? count : kMaxTargets;
+}
+
+void SceneRender::setSceneFilter(MHWRender::MSceneRender::MSceneFilterOption sceneFilter) {
+    mSceneRenderFilter = sceneFilter;
+}
+
+void SceneRender::setClearColor(const float color[4]) {
+    float clearColor[4] = { color[0], color[1], color[2], color[3] };
+    mClearOperation.setClearColor(clearColor);
+}
+
+void SceneRender::setShaderOverride(const MString &shaderFileName, const MString &techniqueName) {
+    clearShaderInstance();
+    mShaderFileName = shaderFileName;
+    mTechniqueName = techniqueName;
+}
+
+const MHWRender::MShaderInstance* SceneRender::shaderOverride() {
+    if (!mShaderOverride && !mShaderFailed && mShaderFileName.length() > 0) {
+        const MHWRender::MShaderManager* shaderMgr = MHWRender::MRenderer::theRenderer()->getShaderManager();
+        mShaderOverride = shaderMgr->getEffectsFileShader(mShaderFileName, mTechniqueName, 0, 0, true,
+            mBlendState ? sPreDraw : nullptr, mBlendState ? sPostDraw : nullptr);
+        if (!mShaderOverride) {
+            cerr << mShaderFileName << " could not be initialized" << endl;
+            mShaderFailed = true;  // until the shaders are reset, instead of compiling it every frame
+        } else if (mBlendState) {
+            sBlendStates()[mShaderOverride] = mBlendState;
+        }
+    }
+    return mShaderOverride;
+}
+
+void SceneRender::setBlendState(const MHWRender::MBlendStateDesc &blendDesc) {
+    clearShaderInstance();  // the draw callbacks are set when the shader instance is created
+    if (mBlendState) {
+        MHWRender::MStateManager::releaseBlendState(mBlendState);
+    }
+    mBlendState = MHWRender::MStateManager::acquireBlendState(blendDesc);
+}
+
+void SceneRender::sPreDraw(MHWRender::MDrawContext &context, const MHWRender::MRenderItemList &,
+    MHWRender::MShaderInstance *shaderInstance) {
+    auto blendState = sBlendStates().find(shaderInstance);
+    if (blendState != sBlendStates().end()) {
+        MHWRender::MStateManager *stateMgr = context.getStateManager();
+        sPreviousBlendState() = stateMgr->getBlendState();
+        stateMgr->setBlendState(blendState->second);
+    }
+}
+
+void SceneRender::sPostDraw(MHWRender::MDrawContext &context, const MHWRender::MRenderItemList &,
+    MHWRender::MShaderInstance *shaderInstance) {
+    if (sBlendStates().count(shaderInstance)) {
+        context.getStateManager()->setBlendState(sPreviousBlendState());
+    }
+}
+
+std::map<const MHWRender::MShaderInstance*, const MHWRender::MBlendState*>& SceneRender::sBlendStates() {
+    static std::map<const MHWRender::MShaderInstance*, const MHWRender::MBlendState*> blendStates;
+    return blendStates;
+}
+
+const MHWRender::MBlendState*& SceneRender::sPreviousBlendState() {
+    static const MHWRender::MBlendState *previous = nullptr;
+    return previous;
+}
+
+void SceneRender::clearShaderInstance() {
+    mShaderFailed = false;
+    if (mShaderFileName.length() == 0) {
+        return;
+    }
+    const MHWRender::MShaderManager* shaderMgr = MHWRender::MRenderer::theRenderer()->getShaderManager();
+    if (mShaderOverride) {
+        sBlendStates().erase(mShaderOverride);
+        shaderMgr->releaseShader(mShaderOverride);
+        mShaderOverride = nullptr;
+    }
+    shaderMgr->removeEffectFromCache(mShaderFileName, mTechniqueName, 0, 0);
+}
+
 // QUAD RENDER
 QuadRender::QuadRender(const MString & name, const MString &shaderFileName, const MString &techniqueName) :
     MQuadRender(name),
@@ -71,46 +164,230 @@ QuadRender::QuadRender(const MString & name, const MString &shaderFileName, cons
     mTechniqueName(techniqueName) {
     mClearOperation.setClearGradient(false);
     mClearOperation.setMask(MHWRender::MClearOperation::kClearNone);
+    mPermutations.push_back(QuadPermutation());  // without macros
 }
 
 QuadRender::~QuadRender() {
     clearShaderInstance();
+    if (mBlendState) {
+        MHWRender::MStateManager::releaseBlendState(mBlendState);
+    }
+    if (mDepthStencilState) {
+        MHWRender::MStateManager::releaseDepthStencilState(mDepthStencilState);
+    }
 }
 
 const MHWRender::MShaderInstance * QuadRender::shader() {
     if (!mShaderInstance) {
+        // compile all permutations up front, switching between them later doesn't stall
         const MHWRender::MShaderManager* shaderMgr = MHWRender::MRenderer::theRenderer()->getShaderManager();
-        mShaderInstance = shaderMgr->getEffectsFileShader(mShaderFileName, mTechniqueName, 0, 0, true);
-        if (!mShaderInstance) {
-            cerr << mShaderFileName << " could not be initialized" << endl;
+        for (unsigned int i = 0; i < mPermutations.size(); i++) {
+            QuadPermutation &permutation = mPermutations[i];
+            if (!permutation.instance) {
+                permutation.instance = shaderMgr->getEffectsFileShader(mShaderFileName, mTechniqueName,
+                    permutation.macros.data(), (unsigned int)permutation.macros.size(), true);
+                if (!permutation.instance) {
+                    cerr << mShaderFileName << " could not be initialized" << endl;
+                }
+            }
         }
+        mShaderInstance = mPermutations[mPermutation].instance;
+        mResetParameters();
+    }
+    if (mShaderInstance && mPushedVersion != mParametersVersion) {
+        mPushParameters();
     }
     return mShaderInstance;
 }
 
+int QuadRender::addPermutation(const std::vector<MHWRender::MShaderCompileMacro> &macros) {
+    QuadPermutation permutation;
+    permutation.macros = macros;
+    mPermutations.push_back(permutation);
+    mShaderInstance = nullptr;  // compiled with the others on next use
+    return (int)mPermutations.size() - 1;
+}
+
+void QuadRender::setPermutation(int permutation) {
+    if (permutation == mPermutation || permutation < 0 || permutation >= (int)mPermutations.size()) {
+        return;
+    }
+    mPermutation = permutation;
+    mShaderInstance = mPermutations[mPermutation].instance;
+    mResetParameters();  // the instance doesn't have the current values yet
+}
+
+int QuadRender::addParameter(const MString &name, QuadParameter::Type type) {
+    QuadParameter parameter;
+    parameter.name = name;
+    parameter.type = type;
+    parameter.version = ++mParametersVersion;
+    mParameters.push_back(parameter);
+    return (int)mParameters.size() - 1;
+}
+
+void QuadRender::setParameter(int parameter, int value) {
+    QuadParameter &p = mParameters[parameter];
+    if (p.intValue != value) {
+        p.intValue = value;
+        p.version = ++mParametersVersion;
+    }
+}
+
+void QuadRender::setParameter(int parameter, float value) {
+    QuadParameter &p = mParameters[parameter];
+    if (p.floatValues[0] != value) {
+        p.floatValues[0] = value;
+        p.version = ++mParametersVersion;
+    }
+}
+
+void QuadRender::setParameter(int parameter, const float *value) {
+    QuadParameter &p = mParameters[parameter];
+    if (memcmp(p.floatValues, value, sizeof(p.floatValues)) != 0) {
+        memcpy(p.floatValues, value, sizeof(p.floatValues));
+        p.version = ++mParametersVersion;
+    }
+}
+
+void QuadRender::setParameter(int parameter, MHWRender::MRenderTarget *target) {
+    QuadParameter &p = mParameters[parameter];
+    if (p.target != target) {
+        p.target = target;
+        p.version = ++mParametersVersion;
+    }
+}
+
+// Sets the parameters that changed since they were last set on the shader instance
+void QuadRender::mPushParameters() {
+    for (unsigned int i = 0; i < mParameters.size(); i++) {
+        QuadParameter &p = mParameters[i];
+        if (p.missing || p.pushedVersion == p.version) {
+            continue;
+        }
+        MStatus status;
+        switch (p.type) {
+        case QuadParameter::kInt:
+            status = mShaderInstance->setParameter(p.name, p.intValue);
+            break;
+        case QuadParameter::kFloat:
+            status = mShaderInstance->setParameter(p.name, p.floatValues[0]);
+            break;
+        case QuadParameter::kFloat4:
+            status = mShaderInstance->setParameter(p.name, p.floatValues);
+            break;
+        case QuadParameter::kTarget: {
+            MHWRender::MRenderTargetAssignment assignment{ p.target };
+            status = mShaderInstance->setParameter(p.name, assignment);
+            break;
+        }
+        }
+        if (status != MS::kSuccess) {
+            // don't look the parameter up again until the shader instance changes
+            cerr << p.name << " could not be set in " << mShaderFileName << endl;
+            p.missing = true;
+        }
+        p.pushedVersion = p.version;
+    }
+    mPushedVersion = mParametersVersion;
+}
+
 void QuadRender::clearShaderInstance() {
+    const MHWRender::MShaderManager* shaderMgr = MHWRender::MRenderer::theRenderer()->getShaderManager();
+    mReleasePermutations();
+    for (unsigned int i = 0; i < mPermutations.size(); i++) {
+        const QuadPermutation &permutation = mPermutations[i];
+        shaderMgr->removeEffectFromCache(mShaderFileName, mTechniqueName,
+            permutation.macros.data(), (unsigned int)permutation.macros.size());
+    }
+}
+
+void QuadRender::mReleasePermutations() {
+    const MHWRender::MShaderManager* shaderMgr = MHWRender::MRenderer::theRenderer()->getShaderManager();
+    for (unsigned int i = 0; i < mPermutations.size(); i++) {
+        if (mPermutations[i].instance) {
+            shaderMgr->releaseShader(mPermutations[i].instance);
+            mPermutations[i].instance = nullptr;
+        }
+    }
     mShaderInstance = nullptr;
+}
+
+// All permutations are compiled from the buffer, the previous instances are kept if any of them fails
+bool QuadRender::reloadShader(const char *buffer, unsigned int size) {
     const MHWRender::MShaderManager* shaderMgr = MHWRender::MRenderer::theRenderer()->getShaderManager();
-    shaderMgr->removeEffectFromCache(mShaderFileName, mTechniqueName, 0, 0);
+    std::vector<MHWRender::MShaderInstance*> instances;
+    for (unsigned int i = 0; i < mPermutations.size(); i++) {
+        const QuadPermutation &permutation = mPermutations[i];
+        MHWRender::MShaderInstance *shaderInstance = shaderMgr->getEffectsBufferShader(buffer, size, mTechniqueName,
+            permutation.macros.data(), (unsigned int)permutation.macros.size(), false);
+        if (!shaderInstance) {
+            cerr << mShaderFileName << " could not be reloaded, keeping the previous shader" << endl;
+            for (unsigned int j = 0; j < instances.size(); j++) {
+                shaderMgr->releaseShader(instances[j]);
+            }
+            return false;
+        }
+        instances.push_back(shaderInstance);
+    }
+    mReleasePermutations();
+    for (unsigned int i = 0; i < mPermutations.size(); i++) {
+        mPermutations[i].instance = instances[i];
+    }
+    mShaderInstance = mPermutations[mPermutation].instance;
+    mResetParameters();
+    return true;
+}
+
+// A new shader instance needs all parameters
+void QuadRender::mResetParameters() {
+    for (unsigned int i = 0; i < mParameters.size(); i++) {
+        mParameters[i].pushedVersion = 0;
+        mParameters[i].missing = false;
+    }
+    mPushedVersion = 0;
 }
 
 void QuadRender::setTargetOverride(unsigned int i, MHWRender::MRenderTarget *target) {
     if (i < 2) {
         if (target) {
             mTargets[i] = target;
+            mTargetCount = (i + 1 > mTargetCount) ? i + 1 : mTargetCount;
         }
     }
 }
 
 MHWRender::MRenderTarget * const * QuadRender::targetOverrideList(unsigned int & listSize) {
     if (mTargets) {
-        listSize = 2;
+        listSize = mTargetCount;  // quads don't need a depth target
         return &mTargets[0];
     }
     listSize = 0;
     return nullptr;
 }
 
+void QuadRender::setBlendState(const MHWRender::MBlendStateDesc &blendDesc) {
+    if (mBlendState) {
+        MHWRender::MStateManager::releaseBlendState(mBlendState);
+    }
+    mBlendState = MHWRender::MStateManager::acquireBlendState(blendDesc);
+}
+
+const MHWRender::MBlendState* QuadRender::blendStateOverride() {
+    return mBlendState;  // nullptr keeps the default (no blending)
+}
+
+void QuadRender::setDepthStencilState(const MHWRender::MDepthStencilStateDesc &depthStencilDesc) {
+    if (mDepthStencilState) {
+        MHWRender::MStateManager::releaseDepthStencilState(mDepthStencilState);
+    }
+    mDepthStencilState = MHWRender::MStateManager::acquireDepthStencilState(depthStencilDesc);
+}
+
+const MHWRender::MDepthStencilState* QuadRender::depthStencilStateOverride() {
+    return mDepthStencilState;  // nullptr keeps the default (no depth test or writes)
+}
+
 // HUD RENDER
 HUDOperation::HUDOperation(const MString & rendererName) : mRendererName(rendererName) {
         mPreviousFrame = std::chrono::high_resolution_clock::now();
@@ -118,6 +395,7 @@ HUDOperation::HUDOperation(const MString & rendererName) : mRendererName(rendere
         mFrameAccu = 0;
         mTimeAccu = 0LL;
         strcpy(mHUDStatsBuffer, "");
+        strcpy(mHUDPercentilesBuffer, "");
 }
 
 HUDOperation::~HUDOperation() {}
@@ -129,28 +407,58 @@ void HUDOperation::addUIDrawables(MHWRender::MUIDrawManager& drawManager2D, cons
     int x = 0, y = 0, w = 0, h = 0;
     frameContext.getViewportDimensions(x, y, w, h);
 
-    // setup draw
-    drawManager2D.beginDrawable();
-    drawManager2D.setColor(MColor(0.3f, 0.3f, 0.3f));
-    drawManager2D.setFontSize(MHWRender::MUIDrawManager::kSmallFontSize);
-
-    // draw renderer name
-    drawManager2D.text(MPoint(w*0.01f, h*0.97f), mRendererName, MHWRender::MUIDrawManager::kLeft);
-
-    // draw viewport size and FPS information
+    // measure the frame (cached frames included) and update the FPS information
     mCurrentFrame = std::chrono::high_resolution_clock::now();
     frameDuration = (unsigned int)std::chrono::duration_cast<std::chrono::microseconds>(mCurrentFrame - mPreviousFrame).count();
     mTimeAccu += frameDuration;
     mFrameAccu++;
+    if (mFrameStats && !mFirstFrame) {
+        mFrameStats->record(frameDuration / 1000.0f);
+    }
+    mFirstFrame = false;
     if (mTimeAccu > 1000000) {
         mFrameAverage = mFrameAccu;
         mDurationAverage = mTimeAccu / mFrameAccu;
-        sprintf(mHUDStatsBuffer, "Resolution [%d, %d]      FPS: %d -> each frame: %d us", w, h, mFrameAverage, mDurationAverage);
+        if (mResolutionScale < 1.0f) {
+            sprintf(mHUDStatsBuffer, "Resolution [%d, %d] scaled %.2f      FPS: %d -> each frame: %d us", w, h, mResolutionScale, mFrameAverage, mDurationAverage);
+        } else {
+            sprintf(mHUDStatsBuffer, "Resolution [%d, %d]      FPS: %d -> each frame: %d us", w, h, mFrameAverage, mDurationAverage);
+        }
+        if (mFrameStats) {
+            FrameTimeSummary stats = mFrameStats->summary();
+            sprintf(mHUDPercentilesBuffer, "p50: %.2f ms  p95: %.2f ms  p99: %.2f ms  max: %.2f ms  hitches: %llu",
+                stats.p50, stats.p95, stats.p99, stats.max, stats.hitches);
+        }
         // reset values
         mFrameAccu = 0; mTimeAccu = 0;
+        mTextVersion++;
     }
-    drawManager2D.text(MPoint(w*0.01f, h*0.95f), mHUDStatsBuffer, MHWRender::MUIDrawManager::kLeft);
     mPreviousFrame = mCurrentFrame;
+    if (mCached) {
+        return;  // drawing the text again would blend it over the text of the cached image
+    }
+
+    // setup draw
+    drawManager2D.beginDrawable();
+    drawManager2D.setColor(MColor(0.3f, 0.3f, 0.3f));
+    drawManager2D.setFontSize(MHWRender::MUIDrawManager::kSmallFontSize);
+
+    // draw renderer name
+    drawManager2D.text(MPoint(w*0.01f, h*0.97f), mRendererName, MHWRender::MUIDrawManager::kLeft);
+
+    // draw viewport size and FPS information
+    drawManager2D.text(MPoint(w*0.01f, h*0.95f), mHUDStatsBuffer, MHWRender::MUIDrawManager::kLeft);
+    drawManager2D.text(MPoint(w*0.01f, h*0.93f), mHUDPercentilesBuffer, MHWRender::MUIDrawManager::kLeft);
+
+    // draw overdraw statistics and GPU times of the operations
+    float line = 0.91f;
+    if (mOverdrawStats.length() > 0) {
+        drawManager2D.text(MPoint(w*0.01f, h*line), mOverdrawStats, MHWRender::MUIDrawManager::kLeft);
+        line -= 0.02f;
+    }
+    for (unsigned int i = 0; i < mPassTimes.length(); i++) {
+        drawManager2D.text(MPoint(w*0.01f, h*(line - 0.02f * i)), mPassTimes[i], MHWRender::MUIDrawManager::kLeft);
+    }
 
     // end draw UI
     drawManager2D.endDrawable();
@@ -191,3 +499,15 @@ void PresentTarget::setTargetOverride(unsigned int i, MHWRender::MRenderTarget *
         }
     }
 }
+
+
+/// TIMESTAMP
+TimestampOperation::TimestampOperation(const MString &name, GPUProfiler *profiler, unsigned int index)
+    : MUserRenderOperation(name)
+    , mProfiler(profiler)
+    , mIndex(index) {}
+
+MStatus TimestampOperation::execute(const MHWRender::MDrawContext &) {
+    mProfiler->timestamp(mIndex);
+    return MStatus::kSuccess;
+}
@@ -4,14 +4,25 @@
 // License       MIT
 
 #pragma once
+#include <map>
 #include <chrono>
+#include <vector>
 #include <maya/MViewport2Renderer.h>
+#include <maya/MShaderManager.h>
+#include <maya/MStateManager.h>
+#include <maya/MFloatPoint.h>
+#include <maya/MStringArray.h>
+#include <maya/MSelectionList.h>
+
+class GPUProfiler;
+class FrameTimeStats;
 
 /// Declaration of all override operations
 /// 1. SceneRender
 /// 2. QuadRender
 /// 3. HUDRender
 /// 4. PresentTarget
+/// 5. TimestampOperation
 ///===========================================
 class SceneRender : public MHWRender::MSceneRender {
 public:
@@ -25,13 +36,81 @@ public:
     /// return custom render target list
     MHWRender::MRenderTarget* const* targetOverrideList(unsigned int &listSize) override;
     /// set a custom clear operation before the scene render starts
-    MHWRender::MClearOperation& SceneRender::clearOperation() override;
+    MHWRender::MClearOperation& clearOperation() override;
     /// set a custom scene filter (e.g., opaque, transparent)
-    MHWRender::MSceneRender::MSceneFilterOption SceneRender::renderFilterOverride() override;
+    MHWRender::MSceneRender::MSceneFilterOption renderFilterOverride() override;
+    /// change the scene filter after construction
+    void setSceneFilter(MHWRender::MSceneRender::MSceneFilterOption sceneFilter);
+    /// number of targets rendered to (color, depth and further color targets), up to kMaxTargets
+    static const unsigned int kMaxTargets = 5;
+    void setTargetCount(unsigned int count);
+    /// render into a sub-rectangle of the targets (nullptr for the full targets)
+    void setViewportRectangle(const MFloatPoint* rect) { mViewportRect = rect; }
+    const MFloatPoint* viewportRectangleOverride() override { return mViewportRect; }
+    /// render with another camera or projection (nullptr for the viewport camera)
+    void setCameraOverride(const MHWRender::MCameraOverride* cameraOverride) { mCameraOverride = cameraOverride; }
+    const MHWRender::MCameraOverride* cameraOverride() override { return mCameraOverride; }
+    /// only draw the given objects (nullptr for all objects)
+    void setObjectSetOverride(const MSelectionList* objectSet) { mObjectSet = objectSet; }
+    const MSelectionList* objectSetOverride() override { return mObjectSet; }
+    /// draw all items with the technique of an effect instead of their materials (e.g., instrumentation)
+    void setShaderOverride(const MString &shaderFileName, const MString &techniqueName);
+    const MHWRender::MShaderInstance* shaderOverride() override;
+    void clearShaderInstance();
+    const MString& shaderFileName() const { return mShaderFileName; }
+    /// blend the items drawn with the shader override (e.g., additive), bound around their draws
+    void setBlendState(const MHWRender::MBlendStateDesc &blendDesc);
+    const MHWRender::MBlendState* blendState() const { return mBlendState; }
+    /// change the cleared targets (e.g., kClearNone to draw over the previous frame)
+    void setClearMask(unsigned int clearMask) { mClearOperation.setMask(clearMask); }
+    /// change the clear color (black by default)
+    void setClearColor(const float color[4]);
 
 protected:
     MHWRender::MSceneRender::MSceneFilterOption mSceneRenderFilter;  ///< scene draw filter override (onlyShaded, etc)
-    MHWRender::MRenderTarget* mTargets[3];  ///< target list that is presented on the viewport
+    MHWRender::MRenderTarget* mTargets[kMaxTargets];  ///< target list that is presented on the viewport
+    unsigned int mTargetCount = 3;          ///< number of targets in the target list
+    const MFloatPoint* mViewportRect = nullptr;  ///< normalized viewport rectangle override
+    const MHWRender::MCameraOverride* mCameraOverride = nullptr;  ///< camera override (e.g., jittered)
+    const MSelectionList* mObjectSet = nullptr;  ///< objects to draw (e.g., proxies while navigating)
+    MString mShaderFileName;  ///< effect of the shader override (none if empty)
+    MString mTechniqueName;
+    MHWRender::MShaderInstance* mShaderOverride = nullptr;  ///< compiled on first use
+    bool mShaderFailed = false;
+    const MHWRender::MBlendState* mBlendState = nullptr;  ///< of the shader override (nullptr keeps Maya's)
+    static void sPreDraw(MHWRender::MDrawContext &context, const MHWRender::MRenderItemList &renderItemList,
+        MHWRender::MShaderInstance *shaderInstance);
+    static void sPostDraw(MHWRender::MDrawContext &context, const MHWRender::MRenderItemList &renderItemList,
+        MHWRender::MShaderInstance *shaderInstance);
+    /// blend states of the shader instances, the draw callbacks only get the instance
+    static std::map<const MHWRender::MShaderInstance*, const MHWRender::MBlendState*>& sBlendStates();
+    static const MHWRender::MBlendState*& sPreviousBlendState();  ///< restored after the draws
+};
+
+
+/// Typed shader parameter cached by the QuadRender
+struct QuadParameter {
+    enum Type {
+        kInt = 0,
+        kFloat,
+        kFloat4,
+        kTarget
+    };
+    MString name;
+    Type type = kFloat;
+    int intValue = 0;
+    float floatValues[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+    MHWRender::MRenderTarget *target = nullptr;
+    unsigned int version = 0;        ///< version of the value
+    unsigned int pushedVersion = 0;  ///< version of the value set on the shader instance
+    bool missing = false;            ///< not found in the shader instance
+};
+
+
+/// Effect compiled with a set of preprocessor macros
+struct QuadPermutation {
+    std::vector<MHWRender::MShaderCompileMacro> macros;
+    MHWRender::MShaderInstance *instance = nullptr;  ///< compiled with all permutations on first use
 };
 
 
@@ -46,16 +125,52 @@ public:
         return mShaderInstance;
     }
     void clearShaderInstance();
+    const MString& shaderFileName() const { return mShaderFileName; }
+    /// compiles the effect from memory and swaps it in, the previous instance is kept on failure
+    bool reloadShader(const char *buffer, unsigned int size);
+    /// declare a permutation of the effect compiled with the macros, returns its handle (0 has no macros)
+    int addPermutation(const std::vector<MHWRender::MShaderCompileMacro> &macros);
+    /// switch to a permutation, all permutations are compiled together so switching never compiles
+    void setPermutation(int permutation);
+    int permutation() const { return mPermutation; }
     /// set custom render target list
     void setTargetOverride(unsigned int i, MHWRender::MRenderTarget* target);
     /// set custom render target
     virtual MHWRender::MRenderTarget* const* targetOverrideList(unsigned int &listSize);
+    /// declare a cached shader parameter, returns its handle
+    int addParameter(const MString &name, QuadParameter::Type type);
+    /// set cached shader parameters, only changed values reach the shader instance
+    void setParameter(int parameter, int value);
+    void setParameter(int parameter, float value);
+    void setParameter(int parameter, const float *value);
+    void setParameter(int parameter, MHWRender::MRenderTarget *target);
+    /// set custom blend state (e.g., to composite over the target)
+    void setBlendState(const MHWRender::MBlendStateDesc &blendDesc);
+    const MHWRender::MBlendState* blendStateOverride() override;
+    /// set custom depth stencil state (e.g., to write depth from the shader)
+    void setDepthStencilState(const MHWRender::MDepthStencilStateDesc &depthStencilDesc);
+    const MHWRender::MDepthStencilState* depthStencilStateOverride() override;
+    /// render into a sub-rectangle of the targets (nullptr for the full targets)
+    void setViewportRectangle(const MFloatPoint* rect) { mViewportRect = rect; }
+    const MFloatPoint* viewportRectangleOverride() override { return mViewportRect; }
 
 protected:
     MString mShaderFileName;
     MString mTechniqueName;
-    MHWRender::MShaderInstance* mShaderInstance = nullptr;     ///< shader instance
+    MHWRender::MShaderInstance* mShaderInstance = nullptr;     ///< shader instance of the active permutation
+    std::vector<QuadPermutation> mPermutations;  ///< indexed by permutation handle
+    int mPermutation = 0;                        ///< active permutation
+    const MHWRender::MBlendState* mBlendState = nullptr;      ///< blend state override
+    const MHWRender::MDepthStencilState* mDepthStencilState = nullptr;  ///< depth stencil state override
     MHWRender::MRenderTarget* mTargets[2];  ///< target list that is presented on the viewport
+    unsigned int mTargetCount = 0;          ///< number of targets set in the target list
+    const MFloatPoint* mViewportRect = nullptr;  ///< normalized viewport rectangle override
+    std::vector<QuadParameter> mParameters;   ///< indexed by parameter handle
+    unsigned int mParametersVersion = 0;      ///< bumped with every parameter change
+    unsigned int mPushedVersion = 0;          ///< parameters version set on the shader instance
+    void mPushParameters();
+    void mResetParameters();
+    void mReleasePermutations();
 };
 
 
@@ -70,10 +185,28 @@ public:
     /// set custom render target list
     void setTargetOverride(unsigned int i, MHWRender::MRenderTarget* target);
     virtual MHWRender::MRenderTarget* const* targetOverrideList(unsigned int &listSize);  ///< targets to render operation to
+    /// render into a sub-rectangle of the targets (nullptr for the full targets)
+    void setViewportRectangle(const MFloatPoint* rect) { mViewportRect = rect; }
+    const MFloatPoint* viewportRectangleOverride() override { return mViewportRect; }
+    /// GPU times of the operations to show (one line each)
+    void setPassTimes(const MStringArray &passTimes) { mPassTimes = passTimes; mTextVersion++; }
+    /// frame time statistics to record into and show
+    void setFrameStats(FrameTimeStats *frameStats) { mFrameStats = frameStats; }
+    /// resolution scale of the scene to show (dynamic resolution)
+    void setResolutionScale(float scale) { mResolutionScale = scale; }
+    /// the target already holds the HUD of a previous frame (frame cache), only measure the frame
+    void setCached(bool cached) { mCached = cached; }
+    /// overdraw statistics to show (empty to hide them)
+    void setOverdrawStats(const MString &overdrawStats) { mOverdrawStats = overdrawStats; mTextVersion++; }
+    /// changes whenever the text to draw changed (partial redraws keep the text of the last full frame)
+    unsigned int textVersion() const { return mTextVersion; }
+    /// normalized height of the viewport below which no text is drawn
+    float textBottom() const { return 0.97f - 0.02f * (3 + (mOverdrawStats.length() > 0 ? 1 : 0) + mPassTimes.length()); }
 
 protected:
     const MString mRendererName;			   ///< render override name
     MHWRender::MRenderTarget* mTargets[2];  ///< target list that is presented on the viewport
+    const MFloatPoint* mViewportRect = nullptr;  ///< normalized viewport rectangle override
 
     /// variables for time statistics
     std::chrono::high_resolution_clock::time_point mPreviousFrame;
@@ -84,6 +217,14 @@ protected:
     unsigned int mFrameAverage;
     unsigned int mDurationAverage;
     char mHUDStatsBuffer[120];
+    char mHUDPercentilesBuffer[120];
+    bool mFirstFrame = true;                  ///< no previous frame to measure from
+    FrameTimeStats *mFrameStats = nullptr;
+    MStringArray mPassTimes;
+    MString mOverdrawStats;
+    unsigned int mTextVersion = 0;
+    float mResolutionScale = 1.0f;
+    bool mCached = false;
 };
 
 
@@ -96,7 +237,24 @@ public:
     void setTargetOverride(unsigned int i, MHWRender::MRenderTarget* target);
     /// target override list
     MHWRender::MRenderTarget* const* targetOverrideList(unsigned int &listSize);
+    /// render into a sub-rectangle of the targets (nullptr for the full targets)
+    void setViewportRectangle(const MFloatPoint* rect) { mViewportRect = rect; }
+    const MFloatPoint* viewportRectangleOverride() override { return mViewportRect; }
 
 protected:
     MHWRender::MRenderTarget* mTargets[2];  ///< target list that is presented on the viewport
-};
\ No newline at end of file
+    const MFloatPoint* mViewportRect = nullptr;  ///< normalized viewport rectangle override
+};
+
+class TimestampOperation : public MHWRender::MUserRenderOperation {
+public:
+    TimestampOperation(const MString &name, GPUProfiler *profiler, unsigned int index);
+    ~TimestampOperation() {}
+
+    /// issues the GPU timestamp once the pipeline reaches the operation
+    MStatus execute(const MHWRender::MDrawContext &drawContext) override;
+
+protected:
+    GPUProfiler *mProfiler;  ///< profiler collecting the timestamps
+    unsigned int mIndex;     ///< index of the timestamp within the frame
+};
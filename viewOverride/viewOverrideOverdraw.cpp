@@ -0,0 +1,66 @@
+// Title         viewOverrideOverdraw.cpp
+// Summary       viewOverride overdraw statistics
+// Copyright     2020 Artineering and/or its licensors
+// License       MIT
+
+#include <string>
+#include <cstring>
+#include "viewOverrideOverdraw.h"
+
+/////////////////////////////////////////////////////////////////////
+/// Overdraw instrumentation
+///
+/// The instrumentation scene renders draw every item with a shader
+/// override declared transparent, so that Viewport 2.0 blends it over
+/// the target without writing depth. Each fragment outputs black with
+/// an alpha of 0.5, halving the target cleared to 1, which leaves
+/// 2^-layers in every pixel with either alpha blending convention.
+/// The heatmap and the first reduction decode the layer count from it.
+///
+/// The statistics are reduced to a single texel on the GPU, so only
+/// 16 bytes are read back per frame, a few frames late.
+///
+/////////////////////////////////////////////////////////////////////
+
+MHWRender::MRenderTarget* OverdrawStats::beginFrame(TargetPool &pool) {
+    mSlot = (mSlot + 1) % kLatency;
+    PooledTarget &staging = mStaging[mSlot];
+    if (mPending[mSlot] && staging.target) {
+        int rowPitch = 0;
+        size_t slicePitch = 0;
+        void *raw = staging.target->rawData(rowPitch, slicePitch);
+        if (raw) {
+            float reduced[4];
+            memcpy(reduced, raw, sizeof(reduced));
+            MHWRender::MRenderTarget::freeRawData(raw);
+            mSummary = summarize(reduced);
+        }
+    }
+    if (!staging.target) {
+        MString name = "overdrawStatsTarget" + MString(std::to_string(mSlot).c_str());
+        pool.acquire(staging, MHWRender::MRenderTargetDescription(name, 1, 1, 0, MHWRender::kR32G32B32A32_FLOAT, 1, false));
+    }
+    mPending[mSlot] = (staging.target != nullptr);
+    return staging.target;
+}
+
+void OverdrawStats::release(TargetPool &pool) {
+    for (unsigned int i = 0; i < kLatency; i++) {
+        pool.release(mStaging[i]);
+        mPending[i] = false;
+    }
+    mSummary = OverdrawSummary();
+}
+
+OverdrawSummary OverdrawStats::summarize(const float reduced[4]) {
+    OverdrawSummary summary;
+    if (reduced[3] < 1.0f) {
+        return summary;  // nothing was drawn (e.g., before the first reduction reached the GPU)
+    }
+    summary.valid = true;
+    summary.pixels = (unsigned int)(reduced[3] + 0.5f);
+    summary.meanLayers = reduced[0] / reduced[3];
+    summary.maxLayers = reduced[1];
+    summary.aboveFraction = reduced[2] / reduced[3];
+    return summary;
+}
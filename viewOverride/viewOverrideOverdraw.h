@@ -0,0 +1,49 @@
+// Title         viewOverrideOverdraw.h
+// Summary       viewOverride overdraw statistics declaration
+// Copyright     2020 Artineering and/or its licensors
+// License       MIT
+
+#pragma once
+#include <maya/MViewport2Renderer.h>
+#include <maya/MRenderTargetManager.h>
+#include "viewOverrideTargetPool.h"
+
+/// Layers per pixel of the last frame read back
+struct OverdrawSummary {
+    bool valid = false;          ///< statistics were read back
+    unsigned int pixels = 0;
+    float meanLayers = 0.0f;
+    float maxLayers = 0.0f;
+    float aboveFraction = 0.0f;  ///< fraction of the pixels with more layers than the threshold
+};
+
+
+/// Overdraw statistics reduced on the GPU
+///
+/// The layer counts are reduced by kLevels quads of kReduction x kReduction
+/// texels into (sum, max, pixels above the threshold, pixels), the last one
+/// into a 1x1 staging target of the current ring slot. Like the capture,
+/// a slot is only read back kLatency frames later, so it never stalls.
+class OverdrawStats {
+public:
+    static const unsigned int kLatency = 3;    ///< frames between the reduction and its read back
+    static const unsigned int kReduction = 8;  ///< texels reduced per level and dimension
+    static const unsigned int kLevels = 5;     ///< reductions down to 1x1 for viewports up to 8^5 pixels
+
+    OverdrawStats() {}
+    ~OverdrawStats() {}
+
+    /// reads back the slot reduced kLatency frames ago and returns the staging target of this frame
+    MHWRender::MRenderTarget* beginFrame(TargetPool &pool);
+    /// releases the staging targets and forgets the statistics
+    void release(TargetPool &pool);
+    const OverdrawSummary& summary() const { return mSummary; }
+    /// summary of the reduced (sum, max, pixels above the threshold, pixels)
+    static OverdrawSummary summarize(const float reduced[4]);
+
+protected:
+    PooledTarget mStaging[kLatency];
+    bool mPending[kLatency] = { false, false, false };
+    unsigned int mSlot = 0;
+    OverdrawSummary mSummary;
+};
@@ -0,0 +1,635 @@
+// Title         viewOverrideProfiler.cpp
+// Summary       viewOverride GPU and frame time profilers
+// Copyright     2020 Artineering and/or its licensors
+// License       MIT
+
+#ifdef _WIN32
+#include <windows.h>
+#include <d3d11.h>
+#else
+#include <dlfcn.h>
+#endif
+#include <string>
+#include <fstream>
+#include <algorithm>
+#include "viewOverrideProfiler.h"
+#include "viewOverrideOperations.h"
+
+/////////////////////////////////////////////////////////////////////
+/// GPU profiler
+///
+/// Viewport 2.0 doesn't expose GPU timings of the render operations,
+/// so timestamp queries are issued by user operations placed between
+/// them. The queries depend on the draw API of the viewport:
+///  - OpenGL: glQueryCounter(GL_TIMESTAMP), the entry points are
+///            queried at runtime so that no GL headers or libraries
+///            are required to build the plugin.
+///  - DirectX 11: D3D11_QUERY_TIMESTAMP within a
+///                D3D11_QUERY_TIMESTAMP_DISJOINT query.
+///
+/// Frame time statistics
+///
+/// CPU frame times are kept in a fixed ring buffer to report their
+/// percentiles and hitches, which an average over a second hides.
+///
+/// A/B comparison
+///
+/// Two configurations alternate every frame so that both see the same
+/// scene, camera and GPU clocks. The GPU profiler hands each collected
+/// frame back with the side it was issued with.
+///
+/// Pass ablation benchmark
+///
+/// Each configuration (an operation disabled, a target format or MRT
+/// layout changed) is measured over consecutive frames, so every frame
+/// is drawn in full. The difference of a configuration to the baseline
+/// is the cost of what it takes away, e.g., of the disabled operation.
+///
+/////////////////////////////////////////////////////////////////////
+
+// OPENGL BACKEND
+#ifdef _WIN32
+#define VO_GLAPI __stdcall
+#else
+#define VO_GLAPI
+#endif
+
+namespace {
+    const unsigned int GL_TIMESTAMP_VO = 0x8E28;
+    const unsigned int GL_QUERY_RESULT_VO = 0x8866;
+    const unsigned int GL_QUERY_RESULT_AVAILABLE_VO = 0x8867;
+
+    typedef void (VO_GLAPI *GenQueriesProc)(int n, unsigned int *ids);
+    typedef void (VO_GLAPI *DeleteQueriesProc)(int n, const unsigned int *ids);
+    typedef void (VO_GLAPI *QueryCounterProc)(unsigned int id, unsigned int target);
+    typedef void (VO_GLAPI *GetQueryObjectivProc)(unsigned int id, unsigned int pname, int *params);
+    typedef void (VO_GLAPI *GetQueryObjectui64vProc)(unsigned int id, unsigned int pname, unsigned long long *params);
+
+    void* glProcAddress(const char *name) {
+#ifdef _WIN32
+        typedef PROC(WINAPI *GetProcAddressProc)(LPCSTR);
+        HMODULE module = GetModuleHandleA("opengl32.dll");
+        if (!module) {
+            return nullptr;
+        }
+        GetProcAddressProc wglGetProcAddressPtr = (GetProcAddressProc)GetProcAddress(module, "wglGetProcAddress");
+        return wglGetProcAddressPtr ? (void*)wglGetProcAddressPtr(name) : nullptr;
+#else
+        return dlsym(RTLD_DEFAULT, name);
+#endif
+    }
+}
+
+class GLTimerBackend : public GPUTimerBackend {
+public:
+    GLTimerBackend(unsigned int slotCount, unsigned int timestampCount) : mTimestampCount(timestampCount) {
+        mQueries.resize(slotCount * timestampCount, 0);
+        glGenQueries((int)mQueries.size(), mQueries.data());
+    }
+    ~GLTimerBackend() override {
+        if (!mQueries.empty()) {
+            glDeleteQueries((int)mQueries.size(), mQueries.data());
+        }
+    }
+    static bool load() {
+        glGenQueries = (GenQueriesProc)glProcAddress("glGenQueries");
+        glDeleteQueries = (DeleteQueriesProc)glProcAddress("glDeleteQueries");
+        glQueryCounter = (QueryCounterProc)glProcAddress("glQueryCounter");
+        glGetQueryObjectiv = (GetQueryObjectivProc)glProcAddress("glGetQueryObjectiv");
+        glGetQueryObjectui64v = (GetQueryObjectui64vProc)glProcAddress("glGetQueryObjectui64v");
+        return glGenQueries && glDeleteQueries && glQueryCounter && glGetQueryObjectiv && glGetQueryObjectui64v;
+    }
+    void beginFrame(unsigned int) override {}
+    void timestamp(unsigned int slot, unsigned int index) override {
+        glQueryCounter(mQueries[slot * mTimestampCount + index], GL_TIMESTAMP_VO);
+    }
+    void endFrame(unsigned int) override {}
+    bool resolve(unsigned int slot, unsigned int count, std::vector<double> &milliseconds) override {
+        // timestamps complete in order, so the last one being available is enough
+        const unsigned int *queries = &mQueries[slot * mTimestampCount];
+        int available = 0;
+        glGetQueryObjectiv(queries[count - 1], GL_QUERY_RESULT_AVAILABLE_VO, &available);
+        if (!available) {
+            return false;
+        }
+        unsigned long long previous = 0;
+        glGetQueryObjectui64v(queries[0], GL_QUERY_RESULT_VO, &previous);
+        milliseconds.resize(count - 1);
+        for (unsigned int i = 1; i < count; i++) {
+            unsigned long long current = 0;
+            glGetQueryObjectui64v(queries[i], GL_QUERY_RESULT_VO, &current);
+            milliseconds[i - 1] = (current - previous) / 1000000.0;  // nanoseconds
+            previous = current;
+        }
+        return true;
+    }
+    void abandon() override { mQueries.clear(); }
+
+protected:
+    unsigned int mTimestampCount;
+    std::vector<unsigned int> mQueries;  ///< [slot][timestamp]
+    static GenQueriesProc glGenQueries;
+    static DeleteQueriesProc glDeleteQueries;
+    static QueryCounterProc glQueryCounter;
+    static GetQueryObjectivProc glGetQueryObjectiv;
+    static GetQueryObjectui64vProc glGetQueryObjectui64v;
+};
+
+GenQueriesProc GLTimerBackend::glGenQueries = nullptr;
+DeleteQueriesProc GLTimerBackend::glDeleteQueries = nullptr;
+QueryCounterProc GLTimerBackend::glQueryCounter = nullptr;
+GetQueryObjectivProc GLTimerBackend::glGetQueryObjectiv = nullptr;
+GetQueryObjectui64vProc GLTimerBackend::glGetQueryObjectui64v = nullptr;
+
+
+// DIRECTX 11 BACKEND
+#ifdef _WIN32
+class DX11TimerBackend : public GPUTimerBackend {
+public:
+    DX11TimerBackend(ID3D11Device *device, unsigned int slotCount, unsigned int timestampCount)
+        : mTimestampCount(timestampCount) {
+        device->GetImmediateContext(&mContext);
+        D3D11_QUERY_DESC disjointDesc = { D3D11_QUERY_TIMESTAMP_DISJOINT, 0 };
+        D3D11_QUERY_DESC timestampDesc = { D3D11_QUERY_TIMESTAMP, 0 };
+        mDisjoint.resize(slotCount, nullptr);
+        mQueries.resize(slotCount * timestampCount, nullptr);
+        for (unsigned int i = 0; i < mDisjoint.size(); i++) {
+            device->CreateQuery(&disjointDesc, &mDisjoint[i]);
+        }
+        for (unsigned int i = 0; i < mQueries.size(); i++) {
+            device->CreateQuery(&timestampDesc, &mQueries[i]);
+        }
+    }
+    ~DX11TimerBackend() override {
+        for (unsigned int i = 0; i < mDisjoint.size(); i++) {
+            if (mDisjoint[i]) mDisjoint[i]->Release();
+        }
+        for (unsigned int i = 0; i < mQueries.size(); i++) {
+            if (mQueries[i]) mQueries[i]->Release();
+        }
+        if (mContext) {
+            mContext->Release();
+        }
+    }
+    void beginFrame(unsigned int slot) override {
+        mContext->Begin(mDisjoint[slot]);
+    }
+    void timestamp(unsigned int slot, unsigned int index) override {
+        mContext->End(mQueries[slot * mTimestampCount + index]);
+    }
+    void endFrame(unsigned int slot) override {
+        mContext->End(mDisjoint[slot]);
+    }
+    bool resolve(unsigned int slot, unsigned int count, std::vector<double> &milliseconds) override {
+        D3D11_QUERY_DATA_TIMESTAMP_DISJOINT disjoint;
+        if (mContext->GetData(mDisjoint[slot], &disjoint, sizeof(disjoint), D3D11_ASYNC_GETDATA_DONOTFLUSH) != S_OK) {
+            return false;
+        }
+        if (disjoint.Disjoint) {
+            return false;  // the frequency changed in between, timestamps are unreliable
+        }
+        ID3D11Query **queries = &mQueries[slot * mTimestampCount];
+        UINT64 previous = 0;
+        if (mContext->GetData(queries[0], &previous, sizeof(UINT64), D3D11_ASYNC_GETDATA_DONOTFLUSH) != S_OK) {
+            return false;
+        }
+        milliseconds.resize(count - 1);
+        for (unsigned int i = 1; i < count; i++) {
+            UINT64 current = 0;
+            if (mContext->GetData(queries[i], &current, sizeof(UINT64), D3D11_ASYNC_GETDATA_DONOTFLUSH) != S_OK) {
+                return false;
+            }
+            milliseconds[i - 1] = (current - previous) * 1000.0 / (double)disjoint.Frequency;
+            previous = current;
+        }
+        return true;
+    }
+    void abandon() override {
+        mDisjoint.clear();
+        mQueries.clear();
+        mContext = nullptr;
+    }
+
+protected:
+    unsigned int mTimestampCount;
+    ID3D11DeviceContext *mContext = nullptr;
+    std::vector<ID3D11Query*> mDisjoint;  ///< [slot]
+    std::vector<ID3D11Query*> mQueries;   ///< [slot][timestamp]
+};
+#endif
+
+
+GPUTimerBackend* GPUTimerBackend::create(unsigned int slotCount, unsigned int timestampCount) {
+    MHWRender::MRenderer *theRenderer = MHWRender::MRenderer::theRenderer();
+    if (!theRenderer) {
+        return nullptr;
+    }
+    if (theRenderer->drawAPIIsOpenGL()) {
+        if (GLTimerBackend::load()) {
+            return new GLTimerBackend(slotCount, timestampCount);
+        }
+        return nullptr;
+    }
+#ifdef _WIN32
+    ID3D11Device *device = (ID3D11Device*)theRenderer->GPUDeviceHandle();
+    if (device) {
+        return new DX11TimerBackend(device, slotCount, timestampCount);
+    }
+#endif
+    return nullptr;
+}
+
+
+// GPU PROFILER
+GPUProfiler::GPUProfiler() {
+    for (unsigned int i = 0; i < kMaxTimestamps; i++) {
+        mOperations.push_back(new TimestampOperation("viewOverride_Timestamp" + MString(std::to_string(i).c_str()), this, i));
+    }
+}
+
+GPUProfiler::~GPUProfiler() {
+    delete mBackend;
+    for (unsigned int i = 0; i < mOperations.size(); i++) {
+        delete mOperations[i];
+    }
+}
+
+void GPUProfiler::setEnabled(bool enabled) {
+    mEnabled = enabled;
+    if (!mEnabled) {
+        for (unsigned int i = 0; i < kMaxPanels; i++) {
+            mPanels[i].passTimes.clear();
+        }
+    }
+}
+
+void GPUProfiler::setBackend(GPUTimerBackend *backend) {
+    if (mBackend) {
+        mBackend->abandon();
+        delete mBackend;
+    }
+    mBackend = backend;
+    mDrawAPI = MHWRender::MRenderer::theRenderer()->drawAPI();
+    for (unsigned int i = 0; i < kMaxPanels; i++) {
+        mPanels[i] = PanelTimes();
+    }
+}
+
+bool GPUProfiler::beginFrame(const std::string &destination, const std::vector<int> &passes, int tag) {
+    mResolvedTag = -1;
+    if (!mEnabled || passes.size() < 2) {
+        return false;
+    }
+    MHWRender::MRenderer *theRenderer = MHWRender::MRenderer::theRenderer();
+    if (mBackend && mDrawAPI != theRenderer->drawAPI()) {
+        // the device of the previous draw API is gone
+        setBackend(nullptr);
+    }
+    if (!mBackend) {
+        mDrawAPI = theRenderer->drawAPI();
+        mBackend = GPUTimerBackend::create(kLatency * kMaxPanels, kMaxTimestamps);
+        if (!mBackend) {
+            cerr << "GPU timestamps are not supported by the draw API" << endl;
+            mEnabled = false;
+            return false;
+        }
+    }
+    if (passes.size() > kMaxTimestamps && !mCapReported) {
+        cerr << "GPU profiler: only the first " << kMaxTimestamps << " of " << passes.size() << " operations are timed" << endl;
+        mCapReported = true;
+    }
+
+    // ring of the panel, recycling the least recently drawn one for a new panel
+    mPanel = 0;
+    for (unsigned int i = 0; i < kMaxPanels; i++) {
+        if (mPanels[i].destination == destination) {
+            mPanel = i;
+            break;
+        }
+        if (mPanels[i].lastUsed < mPanels[mPanel].lastUsed) {
+            mPanel = i;
+        }
+    }
+    PanelTimes &panel = mPanels[mPanel];
+    if (panel.destination != destination) {
+        panel = PanelTimes();  // queries in flight are issued again before they're read
+        panel.destination = destination;
+    }
+    panel.lastUsed = ++mFrame;
+
+    // collect the results of the frame of the panel that used this slot before
+    mSlot = (unsigned int)(panel.frame++ % kLatency);
+    unsigned int backendSlot = mPanel * kLatency + mSlot;
+    if (panel.slotIssued[mSlot]) {
+        const std::vector<int> &slotPasses = panel.slotPasses[mSlot];
+        if (mBackend->resolve(backendSlot, (unsigned int)slotPasses.size(), mResolved)) {
+            mResolvedPasses = slotPasses;
+            mResolvedTag = panel.slotTags[mSlot];
+            for (unsigned int i = 0; i < mResolved.size(); i++) {
+                int pass = slotPasses[i];
+                if (pass >= (int)panel.passTimes.size()) {
+                    panel.passTimes.resize(pass + 1, -1.0);
+                }
+                // exponential moving average to keep the HUD readable
+                panel.passTimes[pass] = (panel.passTimes[pass] < 0.0) ? mResolved[i] : panel.passTimes[pass] * 0.9 + mResolved[i] * 0.1;
+            }
+        } else {
+            mDroppedFrames++;
+        }
+        panel.slotIssued[mSlot] = false;
+    }
+    size_t timed = std::min(passes.size(), (size_t)kMaxTimestamps);
+    panel.slotPasses[mSlot].assign(passes.begin(), passes.begin() + timed);
+    panel.slotTags[mSlot] = tag;
+    return true;
+}
+
+void GPUProfiler::timestamp(unsigned int index) {
+    if (!mBackend) {
+        return;
+    }
+    PanelTimes &panel = mPanels[mPanel];
+    unsigned int backendSlot = mPanel * kLatency + mSlot;
+    unsigned int count = (unsigned int)panel.slotPasses[mSlot].size();
+    if (index == 0) {
+        mBackend->beginFrame(backendSlot);
+    }
+    mBackend->timestamp(backendSlot, index);
+    if (index == count - 1) {
+        mBackend->endFrame(backendSlot);
+        panel.slotIssued[mSlot] = true;
+    }
+}
+
+TimestampOperation* GPUProfiler::operation(unsigned int index) {
+    return mOperations[index];
+}
+
+double GPUProfiler::passTime(int pass) const {
+    const std::vector<double> &passTimes = mPanels[mPanel].passTimes;
+    if (pass < 0 || pass >= (int)passTimes.size()) {
+        return -1.0;
+    }
+    return passTimes[pass];
+}
+
+double GPUProfiler::resolvedTime(int pass) const {
+    if (mResolvedTag < 0) {
+        return -1.0;
+    }
+    for (unsigned int i = 0; i < mResolvedPasses.size() && i < mResolved.size(); i++) {
+        if (mResolvedPasses[i] == pass) {
+            return mResolved[i];
+        }
+    }
+    return -1.0;
+}
+
+double GPUProfiler::resolvedFrameTime() const {
+    double time = 0.0;
+    for (unsigned int i = 0; mResolvedTag >= 0 && i < mResolved.size(); i++) {
+        time += mResolved[i];
+    }
+    return time;
+}
+
+
+// FRAME TIME STATISTICS
+void FrameTimeStats::record(float milliseconds) {
+    if (mCount >= kMinHitchFrames && milliseconds > kHitchFactor * (float)(mSum / mCount)) {
+        mHitches++;
+    }
+    if (mCount == kCapacity) {
+        mSum -= mSamples[mHead];  // evict the oldest sample
+    } else {
+        mCount++;
+    }
+    mSamples[mHead] = milliseconds;
+    mSum += milliseconds;
+    mHead = (mHead + 1) % kCapacity;
+    mFrames++;
+}
+
+void FrameTimeStats::reset() {
+    mHead = 0;
+    mCount = 0;
+    mSum = 0.0;
+    mHitches = 0;
+    mFrames = 0;
+}
+
+FrameTimeSummary FrameTimeStats::summary() const {
+    FrameTimeSummary result;
+    result.count = mCount;
+    result.hitches = mHitches;
+    if (mCount == 0) {
+        return result;
+    }
+    std::copy(mSamples, mSamples + mCount, mSorted);
+    std::sort(mSorted, mSorted + mCount);
+    // nearest-rank percentiles
+    auto percentile = [this](float p) {
+        unsigned int rank = (unsigned int)(p * mCount + 0.999999f);
+        return mSorted[(rank > 0 ? rank : 1) - 1];
+    };
+    result.mean = (float)(mSum / mCount);
+    result.p50 = percentile(0.50f);
+    result.p95 = percentile(0.95f);
+    result.p99 = percentile(0.99f);
+    result.max = mSorted[mCount - 1];
+    return result;
+}
+
+bool FrameTimeStats::exportStats(const std::string &path) const {
+    std::ofstream file(path.c_str());
+    if (!file) {
+        return false;
+    }
+    // samples in the order they were recorded
+    unsigned int first = (mCount == kCapacity) ? mHead : 0;
+    bool json = path.size() >= 5 && path.compare(path.size() - 5, 5, ".json") == 0;
+    if (json) {
+        FrameTimeSummary stats = summary();
+        file << "{\n";
+        file << "  \"frames\": " << mFrames << ",\n";
+        file << "  \"window\": " << stats.count << ",\n";
+        file << "  \"hitches\": " << stats.hitches << ",\n";
+        file << "  \"meanMs\": " << stats.mean << ",\n";
+        file << "  \"p50Ms\": " << stats.p50 << ",\n";
+        file << "  \"p95Ms\": " << stats.p95 << ",\n";
+        file << "  \"p99Ms\": " << stats.p99 << ",\n";
+        file << "  \"maxMs\": " << stats.max << ",\n";
+        file << "  \"samplesMs\": [";
+        for (unsigned int i = 0; i < mCount; i++) {
+            file << (i ? ", " : "") << mSamples[(first + i) % kCapacity];
+        }
+        file << "]\n}\n";
+    } else {
+        file << "frame,ms\n";
+        for (unsigned int i = 0; i < mCount; i++) {
+            file << i << "," << mSamples[(first + i) % kCapacity] << "\n";
+        }
+    }
+    return file.good();
+}
+
+
+// A/B COMPARISON
+void ABTest::start(unsigned int frames) {
+    mFrames = frames;
+    mIssued = 0;
+    mDrain = GPUProfiler::kLatency;
+    for (unsigned int i = 0; i < 2; i++) {
+        mCount[i] = 0;
+        mSceneSum[i] = 0.0;
+        mFrameSum[i] = 0.0;
+    }
+}
+
+void ABTest::stop() {
+    mIssued = mFrames;
+    mDrain = 0;
+}
+
+int ABTest::nextSide() {
+    if (mIssued < mFrames) {
+        return (int)(mIssued++ % 2);
+    }
+    if (mDrain > 0) {
+        mDrain--;
+    }
+    return -1;
+}
+
+void ABTest::record(int side, double sceneMilliseconds, double frameMilliseconds) {
+    if (side < 0 || side > 1 || sceneMilliseconds < 0.0) {
+        return;
+    }
+    mCount[side]++;
+    mSceneSum[side] += sceneMilliseconds;
+    mFrameSum[side] += frameMilliseconds;
+}
+
+ABSummary ABTest::summary() const {
+    ABSummary result;
+    for (unsigned int i = 0; i < 2; i++) {
+        result.frames[i] = mCount[i];
+        result.sceneTime[i] = mCount[i] ? mSceneSum[i] / mCount[i] : 0.0;
+        result.frameTime[i] = mCount[i] ? mFrameSum[i] / mCount[i] : 0.0;
+    }
+    return result;
+}
+
+
+// PASS ABLATION BENCHMARK
+void AblationBenchmark::start(const std::vector<AblationConfig> &configs, unsigned int frames) {
+    mResults.clear();
+    mResults.resize(configs.size());
+    for (unsigned int i = 0; i < configs.size(); i++) {
+        mResults[i].config = configs[i];
+    }
+    mCPUSeen.assign(configs.size(), 0);
+    mGPUSeen.assign(configs.size(), 0);
+    mFramesPerConfig = kWarmupFrames + frames;
+    mTotal = frames ? mFramesPerConfig * (unsigned int)configs.size() : 0;
+    mIssued = 0;
+    mDrain = mTotal ? GPUProfiler::kLatency : 0;
+}
+
+void AblationBenchmark::stop() {
+    mIssued = mTotal;
+    mDrain = 0;
+}
+
+int AblationBenchmark::nextConfig() {
+    if (mIssued < mTotal) {
+        return (int)(mIssued++ / mFramesPerConfig);
+    }
+    if (mDrain > 0) {
+        mDrain--;
+    }
+    return -1;
+}
+
+void AblationBenchmark::recordCPU(int config, float milliseconds) {
+    if (config < 0 || config >= (int)mResults.size()) {
+        return;
+    }
+    if (mCPUSeen[config]++ >= kWarmupFrames) {
+        mResults[config].cpu.record(milliseconds);
+    }
+}
+
+void AblationBenchmark::recordGPU(int config, double frameMilliseconds, const std::vector<std::string> &passNames,
+    const std::vector<double> &passMilliseconds) {
+    if (config < 0 || config >= (int)mResults.size() || frameMilliseconds < 0.0) {
+        return;
+    }
+    if (mGPUSeen[config]++ < kWarmupFrames) {
+        return;
+    }
+    AblationResult &result = mResults[config];
+    result.gpuFrames++;
+    result.gpuFrameSum += frameMilliseconds;
+    for (unsigned int i = 0; i < passNames.size(); i++) {
+        std::vector<std::string>::iterator it = std::find(result.passNames.begin(), result.passNames.end(), passNames[i]);
+        if (it == result.passNames.end()) {
+            result.passNames.push_back(passNames[i]);
+            result.passSums.push_back(0.0);
+            it = result.passNames.end() - 1;
+        }
+        result.passSums[it - result.passNames.begin()] += passMilliseconds[i];
+    }
+}
+
+bool AblationBenchmark::writeReport(const std::string &path) const {
+    std::ofstream file(path.c_str());
+    if (!file) {
+        return false;
+    }
+    FrameTimeSummary baseline = mResults.empty() ? FrameTimeSummary() : mResults[0].cpu.summary();
+    bool baselineGPU = !mResults.empty() && mResults[0].gpuFrames > 0;
+    double baselineGPUTime = baselineGPU ? mResults[0].gpuFrameSum / mResults[0].gpuFrames : 0.0;
+    file << "{\n";
+    file << "  \"framesPerConfig\": " << mFramesPerConfig - kWarmupFrames << ",\n";
+    file << "  \"warmupFrames\": " << kWarmupFrames << ",\n";
+    file << "  \"configs\": [";
+    for (unsigned int i = 0; i < mResults.size(); i++) {
+        const AblationResult &result = mResults[i];
+        FrameTimeSummary stats = result.cpu.summary();
+        file << (i ? "," : "") << "\n    {\n";
+        file << "      \"name\": \"" << result.config.name << "\",\n";
+        file << "      \"gBufferLayout\": " << result.config.gBufferLayout << ",\n";
+        file << "      \"mrtLayout\": " << result.config.sceneLayout << ",\n";
+        file << "      \"frames\": " << stats.count << ",\n";
+        file << "      \"meanMs\": " << stats.mean << ",\n";
+        file << "      \"p50Ms\": " << stats.p50 << ",\n";
+        file << "      \"p95Ms\": " << stats.p95 << ",\n";
+        file << "      \"p99Ms\": " << stats.p99 << ",\n";
+        file << "      \"maxMs\": " << stats.max << ",\n";
+        file << "      \"hitches\": " << stats.hitches << ",\n";
+        file << "      \"deltaMeanMs\": " << stats.mean - baseline.mean << ",\n";
+        file << "      \"deltaP95Ms\": " << stats.p95 - baseline.p95 << ",\n";
+        file << "      \"gpuFrames\": " << result.gpuFrames << ",\n";
+        if (result.gpuFrames) {
+            double gpuTime = result.gpuFrameSum / result.gpuFrames;
+            file << "      \"gpuMeanMs\": " << gpuTime << ",\n";
+            file << "      \"gpuDeltaMs\": ";
+            if (baselineGPU) {
+                file << gpuTime - baselineGPUTime << ",\n";
+            } else {
+                file << "null,\n";
+            }
+        } else {
+            file << "      \"gpuMeanMs\": null,\n";
+            file << "      \"gpuDeltaMs\": null,\n";
+        }
+        file << "      \"gpuPassesMs\": {";
+        for (unsigned int p = 0; p < result.passNames.size(); p++) {
+            file << (p ? ", " : "") << "\"" << result.passNames[p] << "\": " << result.passSums[p] / result.gpuFrames;
+        }
+        file << "}\n    }";
+    }
+    file << "\n  ]\n}\n";
+    return file.good();
+}
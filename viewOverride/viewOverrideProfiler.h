@@ -0,0 +1,223 @@
+// Title         viewOverrideProfiler.h
+// Summary       viewOverride GPU and frame time profilers declaration
+// Copyright     2020 Artineering and/or its licensors
+// License       MIT
+
+#pragma once
+#include <string>
+#include <vector>
+#include <maya/MViewport2Renderer.h>
+
+/// Timestamp queries of a draw API (OpenGL or DirectX 11)
+/// Queries are issued into one of several slots (frames in flight) and
+/// resolved without waiting on the GPU once the slot comes around again
+class GPUTimerBackend {
+public:
+    virtual ~GPUTimerBackend() {}
+    virtual void beginFrame(unsigned int slot) = 0;
+    virtual void timestamp(unsigned int slot, unsigned int index) = 0;
+    virtual void endFrame(unsigned int slot) = 0;
+    /// returns false if the results of the slot are not available (never waits)
+    virtual bool resolve(unsigned int slot, unsigned int count, std::vector<double> &milliseconds) = 0;
+    /// drops the queries without releasing them (their device is gone)
+    virtual void abandon() = 0;
+    /// creates the backend of the current draw API, nullptr if timestamps are not supported
+    static GPUTimerBackend* create(unsigned int slotCount, unsigned int timestampCount);
+};
+
+
+class TimestampOperation;
+
+/// GPU profiler of the render operations
+/// A timestamp operation is placed before each operation and the time between
+/// two timestamps is the GPU time of the operation in between. Results are read
+/// back kLatency frames of the same panel later so that the pipeline never stalls.
+/// Each panel has its own ring of slots and pass times, as panels are drawn one
+/// after the other within a frame and at different sizes.
+class GPUProfiler {
+public:
+    static const unsigned int kLatency = 4;        ///< frames between issuing and reading back the queries
+    static const unsigned int kMaxTimestamps = 64; ///< maximum number of timed operations per frame
+    static const unsigned int kMaxPanels = 4;      ///< panels timed at once (the least recently drawn one is recycled)
+
+    GPUProfiler();
+    ~GPUProfiler();
+
+    void setEnabled(bool enabled);
+    bool enabled() const { return mEnabled; }
+    /// starts a frame of the panel timing the given passes and collects the results of its frame kLatency
+    /// frames ago, the tag is handed back with the results (e.g., to tell apart alternating configurations)
+    /// only the first kMaxTimestamps passes are timed, returns false if timestamps are not supported
+    bool beginFrame(const std::string &destination, const std::vector<int> &passes, int tag = 0);
+    /// passes timed by the frame being recorded (a timestamp operation is placed before each one)
+    unsigned int timedPasses() const { return (unsigned int)mPanels[mPanel].slotPasses[mSlot].size(); }
+    /// issues the timestamp (called by the timestamp operations when the pipeline reaches them)
+    void timestamp(unsigned int index);
+    /// timestamp operation to place before the index-th pass of the frame
+    TimestampOperation* operation(unsigned int index);
+    /// smoothed GPU time of a pass in the panel drawn last in milliseconds (negative if not measured yet)
+    double passTime(int pass) const;
+    /// tag of the frame collected by the last beginFrame() (-1 if none was collected)
+    int resolvedTag() const { return mResolvedTag; }
+    /// unsmoothed GPU time of a pass in the collected frame (negative if it wasn't timed)
+    double resolvedTime(int pass) const;
+    /// unsmoothed GPU time of all timed passes in the collected frame
+    double resolvedFrameTime() const;
+    unsigned long long droppedFrames() const { return mDroppedFrames; }
+    /// replaces the timestamp backend (e.g., by a mock in tests), the profiler takes ownership
+    void setBackend(GPUTimerBackend *backend);
+
+protected:
+    /// slots and pass times of a panel
+    struct PanelTimes {
+        std::string destination;
+        unsigned long long frame = 0;           ///< frames recorded for the panel
+        unsigned long long lastUsed = 0;        ///< profiler frame the panel was last recorded at
+        std::vector<int> slotPasses[kLatency];  ///< passes timed in each slot
+        int slotTags[kLatency] = { 0, 0, 0, 0 };  ///< tag of the frame in each slot
+        bool slotIssued[kLatency] = { false, false, false, false };  ///< slot has timestamps in flight
+        std::vector<double> passTimes;          ///< indexed by graph pass
+    };
+    bool mEnabled = false;
+    GPUTimerBackend *mBackend = nullptr;
+    MHWRender::DrawAPI mDrawAPI = MHWRender::kNone;  ///< draw API the backend was created for
+    unsigned long long mFrame = 0;          ///< frames recorded for all panels
+    unsigned long long mDroppedFrames = 0;  ///< frames whose results weren't ready in time
+    bool mCapReported = false;              ///< more than kMaxTimestamps passes were reported
+    PanelTimes mPanels[kMaxPanels];
+    unsigned int mPanel = 0;                ///< panel of the frame being recorded
+    unsigned int mSlot = 0;                 ///< slot of the frame being recorded within the panel ring
+    std::vector<TimestampOperation*> mOperations;
+    std::vector<double> mResolved;
+    std::vector<int> mResolvedPasses;       ///< passes of the collected frame
+    int mResolvedTag = -1;
+};
+
+
+/// Summary of the frame times in the window (milliseconds)
+struct FrameTimeSummary {
+    unsigned int count = 0;
+    float mean = 0.0f;
+    float p50 = 0.0f;
+    float p95 = 0.0f;
+    float p99 = 0.0f;
+    float max = 0.0f;
+    unsigned long long hitches = 0;  ///< since the last reset
+};
+
+/// Frame time statistics over the last kCapacity frames
+/// Recording doesn't allocate, a frame is a hitch if it takes longer than
+/// kHitchFactor times the mean of the window
+class FrameTimeStats {
+public:
+    static const unsigned int kCapacity = 1024;
+    static const unsigned int kMinHitchFrames = 30;  ///< frames in the window before hitches are detected
+    static constexpr float kHitchFactor = 2.0f;
+
+    FrameTimeStats() {}
+
+    void record(float milliseconds);
+    void reset();
+    /// sorts a copy of the window, so it's meant to be called sporadically (e.g., once per second)
+    FrameTimeSummary summary() const;
+    /// writes the summary and samples to a .json file, or the samples to a .csv file otherwise
+    bool exportStats(const std::string &path) const;
+    /// most recent frame time (0 if none was recorded)
+    float latest() const { return mCount ? mSamples[(mHead + kCapacity - 1) % kCapacity] : 0.0f; }
+    unsigned long long frames() const { return mFrames; }
+
+protected:
+    float mSamples[kCapacity];          ///< ring buffer of frame times
+    mutable float mSorted[kCapacity];   ///< scratch buffer to compute percentiles
+    unsigned int mHead = 0;             ///< index of the next sample
+    unsigned int mCount = 0;            ///< samples in the window
+    double mSum = 0.0;                  ///< sum of the samples in the window
+    unsigned long long mHitches = 0;
+    unsigned long long mFrames = 0;     ///< frames recorded since the last reset
+};
+
+
+/// Summary of an A/B comparison (milliseconds)
+struct ABSummary {
+    unsigned int frames[2] = { 0, 0 };        ///< measured frames of A and B
+    double sceneTime[2] = { 0.0, 0.0 };       ///< mean GPU time of the measured pass
+    double frameTime[2] = { 0.0, 0.0 };       ///< mean GPU time of all timed passes
+};
+
+/// A/B comparison of two configurations alternating every frame
+/// Results arrive GPUProfiler::kLatency frames late, so the comparison
+/// keeps running that long after the last frame was issued
+class ABTest {
+public:
+    void start(unsigned int frames);
+    void stop();
+    bool running() const { return mIssued < mFrames || mDrain > 0; }
+    /// side (0: A, 1: B) to render the next frame with, -1 once all frames were issued
+    int nextSide();
+    void record(int side, double sceneMilliseconds, double frameMilliseconds);
+    ABSummary summary() const;
+
+protected:
+    unsigned int mFrames = 0;    ///< frames to issue
+    unsigned int mIssued = 0;    ///< frames issued so far
+    unsigned int mDrain = 0;     ///< frames left to collect the results in flight
+    unsigned int mCount[2] = { 0, 0 };
+    double mSceneSum[2] = { 0.0, 0.0 };
+    double mFrameSum[2] = { 0.0, 0.0 };
+};
+
+
+/// Configuration measured by a pass ablation benchmark
+struct AblationConfig {
+    std::string name;               ///< e.g., "baseline", "disable viewOverride_Scene_UI", "mrtLayout 0"
+    int disabledPass = -1;          ///< graph pass disabled (-1 for none)
+    unsigned int gBufferLayout = 0; ///< layout (format) of the normals target
+    unsigned int sceneLayout = 0;   ///< layout (MRT count) of the scene render targets
+};
+
+/// Measurements of a configuration (milliseconds)
+struct AblationResult {
+    AblationConfig config;
+    FrameTimeStats cpu;             ///< setup to setup times of the measured frames
+    unsigned int gpuFrames = 0;     ///< collected frames with GPU timings
+    double gpuFrameSum = 0.0;       ///< of all timed passes
+    std::vector<std::string> passNames;
+    std::vector<double> passSums;   ///< GPU time of each pass over the collected frames
+};
+
+/// Pass ablation benchmark
+/// Configurations are measured one after the other for a number of frames
+/// each, after kWarmupFrames that aren't measured (targets reallocated,
+/// shaders compiled). GPU timings arrive GPUProfiler::kLatency frames late
+/// and tagged with their configuration, so the benchmark keeps running that
+/// long after the last frame was issued.
+class AblationBenchmark {
+public:
+    static const unsigned int kWarmupFrames = 2;
+
+    void start(const std::vector<AblationConfig> &configs, unsigned int frames);
+    void stop();
+    bool running() const { return mIssued < mTotal || mDrain > 0; }
+    /// configuration to render the next frame with, -1 once all frames were issued
+    int nextConfig();
+    /// configuration being measured and configurations in total
+    int currentConfig() const { return mIssued ? (int)((mIssued - 1) / mFramesPerConfig) : -1; }
+    unsigned int configCount() const { return (unsigned int)mResults.size(); }
+    /// records the CPU time of a frame issued with the configuration
+    void recordCPU(int config, float milliseconds);
+    /// records the GPU times of a collected frame (pass names and times in the same order)
+    void recordGPU(int config, double frameMilliseconds, const std::vector<std::string> &passNames,
+        const std::vector<double> &passMilliseconds);
+    const std::vector<AblationResult>& results() const { return mResults; }
+    /// writes the results and their difference to the first configuration (baseline) to a .json file
+    bool writeReport(const std::string &path) const;
+
+protected:
+    std::vector<AblationResult> mResults;
+    std::vector<unsigned int> mCPUSeen;  ///< frames of each configuration timed on the CPU, with warmup
+    std::vector<unsigned int> mGPUSeen;  ///< frames of each configuration collected from the GPU, with warmup
+    unsigned int mFramesPerConfig = 0;   ///< warmup and measured frames
+    unsigned int mTotal = 0;             ///< frames to issue
+    unsigned int mIssued = 0;            ///< frames issued so far
+    unsigned int mDrain = 0;             ///< frames left to collect the results in flight
+};
@@ -0,0 +1,46 @@
+// Title         viewOverrideScaling.cpp
+// Summary       viewOverride dynamic resolution controller
+// Copyright     2020 Artineering and/or its licensors
+// License       MIT
+
+#include <cmath>
+#include <algorithm>
+#include "viewOverrideScaling.h"
+
+/////////////////////////////////////////////////////////////////////
+/// Dynamic resolution scaling
+///
+/// The scene is rendered into targets scaled down by the controller
+/// and a quad upscales the result to the viewport before the UI and
+/// HUD are drawn. The cost of the scene passes is roughly proportional
+/// to the pixel count, so the scale of each dimension is corrected by
+/// the square root of budget / frame time, damped to converge over a
+/// few frames since the frame times respond one frame late.
+///
+/////////////////////////////////////////////////////////////////////
+
+void ResolutionScaler::setBudget(float milliseconds) {
+    mBudget = std::max(milliseconds, 0.0f);
+    if (mBudget == 0.0f) {
+        mScale = 1.0f;
+    }
+}
+
+float ResolutionScaler::update(float frameMilliseconds) {
+    if (mBudget == 0.0f || frameMilliseconds <= 0.0f) {
+        return mScale;
+    }
+    if (frameMilliseconds > std::max(kIdleTime, 4.0f * mBudget)) {
+        mScale = 1.0f;  // the viewport was idle, start over at full resolution
+        return mScale;
+    }
+    float target = mScale * std::sqrt(mBudget / frameMilliseconds);
+    target = std::min(std::max(target, kMinScale), 1.0f);
+    float next = mScale + (target - mScale) * kDamping;
+    if (std::fabs(next - mScale) >= kMinStep) {
+        mScale = next;
+    } else if (target == 1.0f || target == kMinScale) {
+        mScale = target;  // settle at the bounds instead of creeping towards them
+    }
+    return mScale;
+}
@@ -0,0 +1,32 @@
+// Title         viewOverrideScaling.h
+// Summary       viewOverride dynamic resolution controller declaration
+// Copyright     2020 Artineering and/or its licensors
+// License       MIT
+
+#pragma once
+
+/// Dynamic resolution controller
+///
+/// Adjusts the resolution scale of the scene targets once per frame so
+/// that the frame time meets a budget. Frames much longer than the
+/// budget come after the viewport was idle and reset to full resolution.
+class ResolutionScaler {
+public:
+    static constexpr float kMinScale = 0.5f;     ///< lowest scale of each dimension
+    static constexpr float kDamping = 0.3f;      ///< fraction of the correction applied per frame
+    static constexpr float kMinStep = 0.02f;     ///< smaller corrections are ignored (no jitter)
+    static constexpr float kIdleTime = 250.0f;   ///< frames longer than this (ms) follow an idle viewport
+
+    ResolutionScaler() {}
+
+    /// frame time budget in milliseconds (0 disables scaling)
+    void setBudget(float milliseconds);
+    float budget() const { return mBudget; }
+    /// adjusts the scale from the time of the last frame and returns it
+    float update(float frameMilliseconds);
+    float scale() const { return mScale; }
+
+protected:
+    float mBudget = 0.0f;
+    float mScale = 1.0f;
+};
@@ -0,0 +1,205 @@
+// Title         viewOverrideSceneWatcher.cpp
+// Summary       viewOverride scene change watcher
+// Copyright     2020 Artineering and/or its licensors
+// License       MIT
+
+#include <maya/MDGMessage.h>
+#include <maya/MNodeMessage.h>
+#include <maya/MEventMessage.h>
+#include <maya/MFnDagNode.h>
+#include <maya/MItDependencyNodes.h>
+#include "viewOverrideSceneWatcher.h"
+
+/////////////////////////////////////////////////////////////////////
+/// Scene change watcher
+///
+/// Maya doesn't notify of dirtied nodes globally, so a dirty callback
+/// is registered on every node that is drawn or shades (DAG shapes and
+/// transforms, shading engines, materials and textures), which catches
+/// edits from manipulators, the attribute editor, animation and
+/// connections as they propagate to them. The callbacks only increment
+/// the version, checking it is left to the next frame. The callback of
+/// a node is removed with the node, so they don't pile up over a session.
+///
+/// Cameras and their transforms aren't part of the scene version, the
+/// frame key compares the view itself, so that navigating is told apart
+/// from scene changes (e.g., to draw proxies while tumbling).
+///
+/// Dirtied shapes (except lights, which shade everything) also keep the
+/// version of their last change, so that a frame can tell which shapes
+/// changed since a panel was drawn. A dirtied transform dirties the
+/// shapes below it (e.g., an object being dragged), unless there are
+/// too many of them. Any other change is global.
+///
+/////////////////////////////////////////////////////////////////////
+
+SceneWatcher::~SceneWatcher() {
+    stop();
+}
+
+void SceneWatcher::start() {
+    if (mRunning) {
+        return;
+    }
+    MStatus status;
+    const char *events[] = { "SelectionChanged", "timeChanged", "Undo", "Redo" };
+    for (const char *event : events) {
+        MCallbackId id = MEventMessage::addEventCallback(event, sChanged, this, &status);
+        if (status == MS::kSuccess) {
+            mCallbacks.push_back(id);
+        }
+    }
+    MCallbackId id = MDGMessage::addNodeAddedCallback(sNodeAdded, "dependNode", this, &status);
+    if (status == MS::kSuccess) {
+        mCallbacks.push_back(id);
+    }
+    id = MDGMessage::addNodeRemovedCallback(sNodeRemoved, "dependNode", this, &status);
+    if (status == MS::kSuccess) {
+        mCallbacks.push_back(id);
+    }
+    for (MItDependencyNodes it; !it.isDone(); it.next()) {
+        MObject node = it.thisNode();
+        mWatchNode(node);
+    }
+    mRunning = true;
+    touch();  // nothing was watched before
+}
+
+void SceneWatcher::stop() {
+    for (unsigned int i = 0; i < mCallbacks.size(); i++) {
+        MMessage::removeCallback(mCallbacks[i]);
+    }
+    mCallbacks.clear();
+    for (std::multimap<unsigned int, WatchedNode>::iterator it = mWatchedNodes.begin(); it != mWatchedNodes.end(); ++it) {
+        MMessage::removeCallback(it->second.callback);
+    }
+    mWatchedNodes.clear();
+    mDirtyShapes.clear();
+    mRunning = false;
+}
+
+bool SceneWatcher::sWatched(const MObject &node) {
+    return node.hasFn(MFn::kShape) || node.hasFn(MFn::kTransform) || node.hasFn(MFn::kShadingEngine)
+        || node.hasFn(MFn::kLambert) || node.hasFn(MFn::kTexture2d) || node.hasFn(MFn::kTexture3d)
+        || node.hasFn(MFn::kPluginHardwareShader);
+}
+
+void SceneWatcher::mWatchNode(MObject &node) {
+    if (node.isNull() || !sWatched(node)) {
+        return;  // e.g., utility nodes, which dirty the watched nodes they are connected to
+    }
+    MStatus status;
+    MCallbackId id = MNodeMessage::addNodeDirtyCallback(node, sNodeDirty, this, &status);
+    if (status == MS::kSuccess) {
+        MObjectHandle handle(node);
+        mWatchedNodes.insert(std::make_pair(handle.hashCode(), WatchedNode{ handle, id }));
+    }
+}
+
+void SceneWatcher::sChanged(void *clientData) {
+    static_cast<SceneWatcher*>(clientData)->touch();
+}
+
+// Camera shapes, and transforms whose shapes are all cameras
+bool SceneWatcher::sCamera(const MObject &node) {
+    if (node.hasFn(MFn::kCamera)) {
+        return true;
+    }
+    if (!node.hasFn(MFn::kTransform)) {
+        return false;
+    }
+    MFnDagNode dagNode(node);
+    bool cameras = false;
+    for (unsigned int i = 0; i < dagNode.childCount(); i++) {
+        MObject child = dagNode.child(i);
+        if (child.hasFn(MFn::kShape)) {
+            if (!child.hasFn(MFn::kCamera)) {
+                return false;
+            }
+            cameras = true;
+        }
+    }
+    return cameras;
+}
+
+bool SceneWatcher::sShapes(const MObject &node, std::vector<MObject> &shapes) {
+    if (node.hasFn(MFn::kLight)) {
+        return false;  // lights shade everything
+    }
+    if (node.hasFn(MFn::kShape)) {
+        if (!node.hasFn(MFn::kCamera)) {
+            shapes.push_back(node);
+        }
+        return shapes.size() <= kMaxDirtyShapes;
+    }
+    if (!node.hasFn(MFn::kTransform)) {
+        return false;  // materials, textures, etc.
+    }
+    // a dirtied transform moves every shape below it
+    MFnDagNode dagNode(node);
+    for (unsigned int i = 0; i < dagNode.childCount(); i++) {
+        if (!sShapes(dagNode.child(i), shapes)) {
+            return false;
+        }
+    }
+    return true;
+}
+void SceneWatcher::sNodeDirty(MObject &node, void *clientData) {
+    SceneWatcher *watcher = static_cast<SceneWatcher*>(clientData);
+    if (sCamera(node)) {
+        return;  // the view is part of the frame key
+    }
+    std::vector<MObject> shapes;
+    if (node.isNull() || !sShapes(node, shapes)) {
+        watcher->touch();
+        return;
+    }
+    for (const MObject &shapeNode : shapes) {
+        MObjectHandle handle(shapeNode);
+        DirtyShape &shape = watcher->mDirtyShapes[handle.hashCode()];
+        if (shape.handle.isValid() && !(shape.handle == shapeNode)) {
+            watcher->touch();  // hash collision, the other shape wouldn't be redrawn
+            return;
+        }
+        shape.handle = handle;
+        shape.version = ++watcher->mVersion;
+    }
+}
+
+bool SceneWatcher::dirtyShapes(unsigned long long sinceVersion, std::vector<MObjectHandle> &shapes) const {
+    shapes.clear();
+    if (mGlobalVersion > sinceVersion) {
+        return false;
+    }
+    for (std::map<unsigned int, DirtyShape>::const_iterator it = mDirtyShapes.begin(); it != mDirtyShapes.end(); ++it) {
+        if (it->second.version > sinceVersion) {
+            shapes.push_back(it->second.handle);
+        }
+    }
+    return true;
+}
+
+void SceneWatcher::sNodeAdded(MObject &node, void *clientData) {
+    SceneWatcher *watcher = static_cast<SceneWatcher*>(clientData);
+    watcher->mWatchNode(node);
+    watcher->touch();
+}
+
+void SceneWatcher::sNodeRemoved(MObject &node, void *clientData) {
+    SceneWatcher *watcher = static_cast<SceneWatcher*>(clientData);
+    unsigned int hashCode = MObjectHandle(node).hashCode();
+    std::pair<std::multimap<unsigned int, WatchedNode>::iterator, std::multimap<unsigned int, WatchedNode>::iterator> range =
+        watcher->mWatchedNodes.equal_range(hashCode);
+    for (std::multimap<unsigned int, WatchedNode>::iterator it = range.first; it != range.second; ++it) {
+        if (it->second.handle == node) {
+            MMessage::removeCallback(it->second.callback);
+            watcher->mWatchedNodes.erase(it);
+            break;
+        }
+    }
+    std::map<unsigned int, DirtyShape>::iterator shape = watcher->mDirtyShapes.find(hashCode);
+    if (shape != watcher->mDirtyShapes.end() && shape->second.handle == node) {
+        watcher->mDirtyShapes.erase(shape);
+    }
+    watcher->touch();
+}
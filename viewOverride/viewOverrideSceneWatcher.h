@@ -0,0 +1,61 @@
+// Title         viewOverrideSceneWatcher.h
+// Summary       viewOverride scene change watcher declaration
+// Copyright     2020 Artineering and/or its licensors
+// License       MIT
+
+#pragma once
+#include <map>
+#include <vector>
+#include <maya/MMessage.h>
+#include <maya/MObjectHandle.h>
+
+/// Scene change watcher
+///
+/// Counts the changes to the scene that can alter the image of a
+/// viewport: dirtied dependency nodes, added or removed nodes, the
+/// selection, the current time and undo/redo. The image of a frame
+/// drawn at the same version, camera and viewport can be reused.
+/// Dirtied shapes are also remembered, so that the image can be
+/// redrawn where they are (partial redraw) if nothing else changed.
+class SceneWatcher {
+public:
+    SceneWatcher() {}
+    ~SceneWatcher();
+
+    /// registers the callbacks (on the existing and future nodes that are drawn or shade)
+    void start();
+    void stop();
+    bool running() const { return mRunning; }
+    /// increments whenever the scene (or anything else shown) changed
+    unsigned long long version() const { return mVersion; }
+    void touch() { mGlobalVersion = ++mVersion; }
+    /// shapes dirtied after a version, false if anything else changed since (e.g., lights, materials or the selection)
+    bool dirtyShapes(unsigned long long sinceVersion, std::vector<MObjectHandle> &shapes) const;
+
+protected:
+    bool mRunning = false;
+    unsigned long long mVersion = 1;
+    unsigned long long mGlobalVersion = 1;  ///< version of the last change that isn't a shape
+    struct DirtyShape {
+        MObjectHandle handle;
+        unsigned long long version = 0;  ///< version of its last change
+    };
+    static const size_t kMaxDirtyShapes = 256;  ///< per dirtied node, more is a global change
+    std::map<unsigned int, DirtyShape> mDirtyShapes;  ///< by object hash code
+    struct WatchedNode {
+        MObjectHandle handle;
+        MCallbackId callback;  ///< dirty callback, removed with the node
+    };
+    std::multimap<unsigned int, WatchedNode> mWatchedNodes;  ///< by object hash code
+    std::vector<MCallbackId> mCallbacks;  ///< scene wide callbacks
+
+    void mWatchNode(MObject &node);
+    static bool sWatched(const MObject &node);
+    static bool sCamera(const MObject &node);
+    /// adds the shapes drawn by a node (itself or below its transform), false if its change is global
+    static bool sShapes(const MObject &node, std::vector<MObject> &shapes);
+    static void sChanged(void *clientData);
+    static void sNodeDirty(MObject &node, void *clientData);
+    static void sNodeAdded(MObject &node, void *clientData);
+    static void sNodeRemoved(MObject &node, void *clientData);
+};
@@ -0,0 +1,256 @@
+// Title         viewOverrideShaderWatcher.cpp
+// Summary       viewOverride shader file watcher
+// Copyright     2020 Artineering and/or its licensors
+// License       MIT
+
+#include <set>
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <sys/stat.h>
+#ifdef __linux__
+#include <poll.h>
+#include <unistd.h>
+#include <sys/inotify.h>
+#endif
+#include "viewOverrideShaderWatcher.h"
+
+/////////////////////////////////////////////////////////////////////
+/// Shader hot-reload
+///
+/// Recompiling an effect from its file stalls the viewport while the
+/// file is read and compiled, and a broken edit leaves the quad without
+/// a shader. The watcher therefore reads, preprocesses and validates
+/// changed effect files away from the main thread, which then only
+/// compiles valid sources from memory and swaps the shader instance
+/// once the new one is ready (see QuadRender::reloadShader).
+///
+/////////////////////////////////////////////////////////////////////
+
+namespace {
+    const unsigned int kMaxIncludeDepth = 8;
+
+    bool endsWith(const std::string &text, const std::string &suffix) {
+        return text.size() >= suffix.size() && text.compare(text.size() - suffix.size(), suffix.size(), suffix) == 0;
+    }
+
+    long long modificationTime(const std::string &path) {
+        struct stat info;
+        if (stat(path.c_str(), &info) != 0) {
+            return -1;
+        }
+        return (long long)info.st_mtime;
+    }
+
+    bool readFile(const std::string &path, std::string &contents) {
+        std::ifstream file(path.c_str(), std::ios::in | std::ios::binary);
+        if (!file) {
+            return false;
+        }
+        std::ostringstream stream;
+        stream << file.rdbuf();
+        contents = stream.str();
+        return true;
+    }
+
+    bool inlineIncludes(const std::string &directory, const std::string &fileName, unsigned int depth,
+        std::string &buffer, std::string &error) {
+        if (depth > kMaxIncludeDepth) {
+            error = "includes nested too deep in " + fileName;
+            return false;
+        }
+        std::string contents;
+        if (!readFile(directory + fileName, contents)) {
+            error = "could not read " + fileName;
+            return false;
+        }
+        std::istringstream lines(contents);
+        std::string line;
+        while (std::getline(lines, line)) {
+            size_t start = line.find_first_not_of(" \t");
+            if (start != std::string::npos && line.compare(start, 8, "#include") == 0) {
+                size_t open = line.find('"', start);
+                size_t close = (open != std::string::npos) ? line.find('"', open + 1) : std::string::npos;
+                if (close == std::string::npos) {
+                    error = "malformed include in " + fileName + ": " + line;
+                    return false;
+                }
+                if (!inlineIncludes(directory, line.substr(open + 1, close - open - 1), depth + 1, buffer, error)) {
+                    return false;
+                }
+                continue;
+            }
+            buffer += line;
+            buffer += '\n';
+        }
+        return true;
+    }
+}
+
+
+ShaderWatcher::~ShaderWatcher() {
+    stop();
+}
+
+bool ShaderWatcher::start(const std::string &directory, const std::vector<std::string> &effects) {
+    stop();
+    mDirectory = directory;
+    mEffects = effects;
+    mModified.clear();
+    mRunning = true;
+    mThread = std::thread(&ShaderWatcher::mWatch, this);
+    return true;
+}
+
+void ShaderWatcher::stop() {
+    mRunning = false;
+    if (mThread.joinable()) {
+        mThread.join();
+    }
+}
+
+void ShaderWatcher::collect(std::vector<ShaderSource> &sources) {
+    sources.clear();
+    std::lock_guard<std::mutex> lock(mMutex);
+    sources.swap(mReady);
+}
+
+bool ShaderWatcher::preprocess(const std::string &directory, const std::string &fileName, std::string &buffer, std::string &error) {
+    buffer.clear();
+    if (!inlineIncludes(directory, fileName, 0, buffer, error)) {
+        return false;
+    }
+    // check that braces and parentheses are balanced outside of comments and strings
+    int braces = 0;
+    int parentheses = 0;
+    for (size_t i = 0; i < buffer.size(); i++) {
+        char c = buffer[i];
+        if (c == '/' && i + 1 < buffer.size() && buffer[i + 1] == '/') {
+            i = buffer.find('\n', i);
+            if (i == std::string::npos) break;
+        } else if (c == '/' && i + 1 < buffer.size() && buffer[i + 1] == '*') {
+            i = buffer.find("*/", i + 2);
+            if (i == std::string::npos) {
+                error = "unterminated comment in " + fileName;
+                return false;
+            }
+            i++;
+        } else if (c == '"') {
+            i = buffer.find('"', i + 1);
+            if (i == std::string::npos) {
+                error = "unterminated string in " + fileName;
+                return false;
+            }
+        } else if (c == '{') {
+            braces++;
+        } else if (c == '}') {
+            braces--;
+        } else if (c == '(') {
+            parentheses++;
+        } else if (c == ')') {
+            parentheses--;
+        }
+        if (braces < 0 || parentheses < 0) {
+            break;
+        }
+    }
+    if (braces != 0 || parentheses != 0) {
+        error = "unbalanced braces or parentheses in " + fileName;
+        return false;
+    }
+    if (buffer.find("technique") == std::string::npos) {
+        error = "no technique found in " + fileName;
+        return false;
+    }
+    return true;
+}
+
+// Effect files are named <effect>.ogsfx (OpenGL) and <effect>10.fx (DirectX 11)
+bool ShaderWatcher::mWatched(const std::string &fileName, std::string &effect, std::string &extension) const {
+    if (endsWith(fileName, ".ogsfx")) {
+        extension = ".ogsfx";
+    } else if (endsWith(fileName, "10.fx")) {
+        extension = "10.fx";
+    } else {
+        return false;
+    }
+    effect = fileName.substr(0, fileName.size() - extension.size());
+    for (unsigned int i = 0; i < mEffects.size(); i++) {
+        if (mEffects[i] == effect) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void ShaderWatcher::mProcess(const std::string &fileName) {
+    ShaderSource source;
+    if (!mWatched(fileName, source.effect, source.extension)) {
+        return;
+    }
+    preprocess(mDirectory, fileName, source.buffer, source.error);
+    std::lock_guard<std::mutex> lock(mMutex);
+    for (unsigned int i = 0; i < mReady.size(); i++) {
+        if (mReady[i].effect == source.effect && mReady[i].extension == source.extension) {
+            mReady[i] = source;  // only the latest edit matters
+            return;
+        }
+    }
+    mReady.push_back(source);
+}
+
+void ShaderWatcher::mWatch() {
+#ifdef __linux__
+    int fd = inotify_init1(IN_NONBLOCK);
+    if (fd >= 0 && inotify_add_watch(fd, mDirectory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) >= 0) {
+        alignas(struct inotify_event) char events[4096];
+        while (mRunning) {
+            struct pollfd descriptor = { fd, POLLIN, 0 };
+            if (poll(&descriptor, 1, kPollInterval) <= 0) {
+                continue;
+            }
+            ssize_t length = read(fd, events, sizeof(events));
+            std::set<std::string> changed;  // editors may write a file several times per save
+            for (char *ptr = events; length > 0 && ptr < events + length; ) {
+                const struct inotify_event *event = (const struct inotify_event*)ptr;
+                if (event->len > 0) {
+                    changed.insert(event->name);
+                }
+                ptr += sizeof(struct inotify_event) + event->len;
+            }
+            for (std::set<std::string>::iterator it = changed.begin(); it != changed.end(); ++it) {
+                mProcess(*it);
+            }
+        }
+        close(fd);
+        return;
+    }
+    if (fd >= 0) {
+        close(fd);
+    }
+#endif
+    // fall back to polling the modification times
+    while (mRunning) {
+        mPoll();
+        std::this_thread::sleep_for(std::chrono::milliseconds(kPollInterval));
+    }
+}
+
+void ShaderWatcher::mPoll() {
+    const char *extensions[2] = { ".ogsfx", "10.fx" };
+    for (unsigned int i = 0; i < mEffects.size(); i++) {
+        for (unsigned int e = 0; e < 2; e++) {
+            std::string fileName = mEffects[i] + extensions[e];
+            long long modified = modificationTime(mDirectory + fileName);
+            std::map<std::string, long long>::iterator it = mModified.find(fileName);
+            if (it == mModified.end()) {
+                mModified[fileName] = modified;  // first scan
+            } else if (it->second != modified) {
+                it->second = modified;
+                if (modified >= 0) {
+                    mProcess(fileName);
+                }
+            }
+        }
+    }
+}
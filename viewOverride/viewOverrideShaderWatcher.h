@@ -0,0 +1,59 @@
+// Title         viewOverrideShaderWatcher.h
+// Summary       viewOverride shader file watcher declaration
+// Copyright     2020 Artineering and/or its licensors
+// License       MIT
+
+#pragma once
+#include <map>
+#include <mutex>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+/// Preprocessed source of a changed effect file
+struct ShaderSource {
+    std::string effect;     ///< effect name without extension (e.g., quadDebug)
+    std::string extension;  ///< ".ogsfx" (OpenGL) or "10.fx" (DirectX 11)
+    std::string buffer;     ///< source with the includes inlined
+    std::string error;      ///< empty if the source is valid
+};
+
+
+/// Shader file watcher
+///
+/// Watches the effect files of the shaders directory on a worker thread,
+/// which reads, preprocesses and validates changed files so that only the
+/// compilation is left to the main thread. Uses inotify on Linux and polls
+/// the modification times elsewhere.
+class ShaderWatcher {
+public:
+    static const unsigned int kPollInterval = 250;  ///< milliseconds between checks
+
+    ShaderWatcher() {}
+    ~ShaderWatcher();
+
+    /// starts watching the effects (names without extension) in the directory
+    bool start(const std::string &directory, const std::vector<std::string> &effects);
+    void stop();
+    bool running() const { return mRunning; }
+    /// moves the sources processed since the last call into sources, never blocks
+    void collect(std::vector<ShaderSource> &sources);
+
+    /// inlines #include "file" directives and checks that the source looks like a valid effect
+    static bool preprocess(const std::string &directory, const std::string &fileName, std::string &buffer, std::string &error);
+
+protected:
+    std::string mDirectory;
+    std::vector<std::string> mEffects;
+    std::thread mThread;
+    std::atomic<bool> mRunning{ false };
+    std::mutex mMutex;                    ///< guards mReady
+    std::vector<ShaderSource> mReady;     ///< processed sources waiting for the main thread
+    std::map<std::string, long long> mModified;  ///< modification times (polling)
+
+    void mWatch();
+    void mPoll();
+    void mProcess(const std::string &fileName);
+    bool mWatched(const std::string &fileName, std::string &effect, std::string &extension) const;
+};
@@ -0,0 +1,124 @@
+// Title         viewOverrideTargetPool.cpp
+// Summary       viewOverride render target pool
+// Copyright     2020 Artineering and/or its licensors
+// License       MIT
+
+#include "viewOverrideTargetPool.h"
+
+/////////////////////////////////////////////////////////////////////
+/// Render target pool used by viewOverride
+///
+/// Requests are rounded up to buckets of kBucketSize pixels. Growing
+/// past the bucket reallocates immediately, whereas a target that is
+/// larger than needed is kept for kShrinkCooldown frames before it
+/// is shrunk. Unchanged sizes don't touch the target at all.
+///
+/////////////////////////////////////////////////////////////////////
+
+unsigned int TargetPool::bucket(unsigned int size) {
+    if (size <= 1) {
+        return 1;  // minimal placeholder targets are not bucketed
+    }
+    return ((size + kBucketSize - 1) / kBucketSize) * kBucketSize;
+}
+
+unsigned int TargetPool::bytesPerPixel(MHWRender::MRasterFormat format) {
+    switch (format) {
+    case MHWRender::kR8_UNORM:
+        return 1;
+    case MHWRender::kR16_FLOAT:
+        return 2;
+    case MHWRender::kR32G32_FLOAT:
+    case MHWRender::kR16G16B16A16_FLOAT:
+        return 8;
+    case MHWRender::kR32G32B32A32_FLOAT:
+        return 16;
+    default:
+        return 4;  // depth and 32 bit color formats
+    }
+}
+
+unsigned long long TargetPool::bytes(const MHWRender::MRenderTargetDescription &description) {
+    unsigned long long samples = description.multiSampleCount() > 1 ? description.multiSampleCount() : 1;
+    return (unsigned long long)description.width() * description.height() * bytesPerPixel(description.rasterFormat()) * samples;
+}
+
+bool TargetPool::acquire(PooledTarget &pooled, const MHWRender::MRenderTargetDescription &description) {
+    const MHWRender::MRenderTargetManager* targetManager = MHWRender::MRenderer::theRenderer()->getRenderTargetManager();
+    if (!targetManager) {
+        return false;
+    }
+    pooled.width = description.width();
+    pooled.height = description.height();
+    pooled.shrinkFrames = 0;
+    pooled.description = description;
+    pooled.description.setWidth(bucket(pooled.width));
+    pooled.description.setHeight(bucket(pooled.height));
+    pooled.target = targetManager->acquireRenderTarget(pooled.description);
+    if (!pooled.target) {
+        return false;
+    }
+    mBytesHeld += bytes(pooled.description);
+    mMisses++;
+    return true;
+}
+
+void TargetPool::release(PooledTarget &pooled) {
+    if (!pooled.target) {
+        return;
+    }
+    const MHWRender::MRenderTargetManager* targetManager = MHWRender::MRenderer::theRenderer()->getRenderTargetManager();
+    if (targetManager) {
+        targetManager->releaseRenderTarget(pooled.target);
+    }
+    mBytesHeld -= bytes(pooled.description);
+    pooled.target = nullptr;
+}
+
+bool TargetPool::fit(PooledTarget &pooled, unsigned int width, unsigned int height) {
+    if (!pooled.target) {
+        return false;
+    }
+    bool changed = (width != pooled.width) || (height != pooled.height);
+    pooled.width = width;
+    pooled.height = height;
+
+    unsigned int bWidth = bucket(width);
+    unsigned int bHeight = bucket(height);
+    bool grow = (bWidth > pooled.description.width()) || (bHeight > pooled.description.height());
+    bool oversized = (bWidth < pooled.description.width()) || (bHeight < pooled.description.height());
+    if (!grow) {
+        if (!oversized) {
+            pooled.shrinkFrames = 0;
+            if (changed) mHits++;
+            return false;
+        }
+        // hysteresis: keep the larger allocation until the cooldown runs out
+        if (++pooled.shrinkFrames < kShrinkCooldown) {
+            if (changed) mHits++;
+            return false;
+        }
+    }
+
+    // reallocate into the current bucket
+    mBytesHeld -= bytes(pooled.description);
+    pooled.description.setWidth(bWidth);
+    pooled.description.setHeight(bHeight);
+    pooled.target->updateDescription(pooled.description);
+    mBytesHeld += bytes(pooled.description);
+    pooled.shrinkFrames = 0;
+    mMisses++;
+    return true;
+}
+
+bool TargetPool::setFormat(PooledTarget &pooled, MHWRender::MRasterFormat format) {
+    if (!pooled.target || pooled.description.rasterFormat() == format) {
+        return false;
+    }
+    mBytesHeld -= bytes(pooled.description);
+    pooled.description.setRasterFormat(format);
+    pooled.target->updateDescription(pooled.description);
+    mBytesHeld += bytes(pooled.description);
+    mMisses++;
+    return true;
+}
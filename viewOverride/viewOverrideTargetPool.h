@@ -0,0 +1,53 @@
+// Title         viewOverrideTargetPool.h
+// Summary       viewOverride render target pool declaration
+// Copyright     2020 Artineering and/or its licensors
+// License       MIT
+
+#pragma once
+#include <maya/MViewport2Renderer.h>
+#include <maya/MRenderTargetManager.h>
+
+/// Render target allocated into a size bucket by the TargetPool
+struct PooledTarget {
+    MHWRender::MRenderTarget* target = nullptr;
+    MHWRender::MRenderTargetDescription description;  ///< allocated (bucketed) description
+    unsigned int width = 0;         ///< requested width
+    unsigned int height = 0;        ///< requested height
+    unsigned int shrinkFrames = 0;  ///< consecutive frames the allocation has been oversized
+};
+
+
+/// Resize-aware render target pool
+///
+/// Targets are allocated into rounded-up size buckets, so resizing
+/// within a bucket doesn't reallocate and the operations only render
+/// into a sub-rectangle of the target. Oversized targets are only
+/// shrunk after a cooldown, to avoid thrashing while dragging.
+class TargetPool {
+public:
+    static const unsigned int kBucketSize = 128;      ///< bucket granularity in pixels
+    static const unsigned int kShrinkCooldown = 120;  ///< frames before an oversized target shrinks
+
+    TargetPool() {}
+    ~TargetPool() {}
+
+    bool acquire(PooledTarget &pooled, const MHWRender::MRenderTargetDescription &description);
+    void release(PooledTarget &pooled);
+    /// fits the target to the requested size, returns true if it was reallocated
+    bool fit(PooledTarget &pooled, unsigned int width, unsigned int height);
+    /// changes the raster format of the target, returns true if it was reallocated
+    bool setFormat(PooledTarget &pooled, MHWRender::MRasterFormat format);
+
+    unsigned long long hits() const { return mHits; }
+    unsigned long long misses() const { return mMisses; }
+    unsigned long long bytesHeld() const { return mBytesHeld; }
+
+    static unsigned int bucket(unsigned int size);
+    static unsigned int bytesPerPixel(MHWRender::MRasterFormat format);
+    static unsigned long long bytes(const MHWRender::MRenderTargetDescription &description);
+
+protected:
+    unsigned long long mHits = 0;       ///< resizes served by the current allocation
+    unsigned long long mMisses = 0;     ///< resizes that required a reallocation
+    unsigned long long mBytesHeld = 0;  ///< memory held by all pooled targets
+};